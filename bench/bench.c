@@ -0,0 +1,104 @@
+/**
+ * @file bench.c
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief Host-side benchmark harness.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "bench.h"
+#include <stdio.h>
+#include <time.h>
+
+uint8_t bench_buffer[SSD1306_FRAMEBUFFER_SIZE(128, 64)];
+
+struct ssd1306_bitmap bench_bm = {
+    .width = 128,
+    .height = 64,
+    .length = sizeof(bench_buffer),
+    .data = bench_buffer,
+};
+
+/**
+ * @brief State of the pseudo-random number generator.
+ */
+static uint32_t bench_seed = 0x2545F491u;
+
+uint64_t bench_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Runs an operation until BENCH_MIN_TIME_NS have elapsed.
+ * @param fn Operation to run.
+ * @param ctx Context passed to the operation.
+ * @return Time per operation in nanoseconds.
+ */
+static double bench_measure(bench_fn fn, void *ctx)
+{
+    uint64_t iterations = 1;
+    uint64_t elapsed;
+
+    for (;;) {
+        uint64_t start = bench_now();
+
+        for (uint64_t i = 0; i < iterations; i++) {
+            fn(ctx);
+        }
+
+        elapsed = bench_now() - start;
+        if (elapsed >= BENCH_MIN_TIME_NS)
+            break;
+        iterations *= 2;
+    }
+
+    return (double)elapsed / (double)iterations;
+}
+
+void bench_run(const char *name, bench_fn fn, void *ctx, uint32_t pixels)
+{
+    double ns_per_op = bench_measure(fn, ctx);
+
+    printf("{\"name\": \"%s\", \"ns_per_op\": %.2f, \"pixels_per_s\": %.0f}\n",
+           name, ns_per_op, pixels * 1e9 / ns_per_op);
+}
+
+void bench_run_bytes(const char *name, bench_fn fn, void *ctx, uint32_t pixels,
+                     uint32_t bytes)
+{
+    double ns_per_op = bench_measure(fn, ctx);
+
+    printf("{\"name\": \"%s\", \"ns_per_op\": %.2f, \"pixels_per_s\": %.0f, "
+           "\"bytes_per_frame\": %u}\n",
+           name, ns_per_op, pixels * 1e9 / ns_per_op, (unsigned)bytes);
+}
+
+uint32_t bench_count_pixels(const uint8_t *data, uint16_t length)
+{
+    uint32_t pixels = 0;
+
+    for (uint16_t i = 0; i < length; i++) {
+        for (uint8_t byte = data[i]; byte; byte &= byte - 1u) {
+            pixels++;
+        }
+    }
+    return pixels;
+}
+
+void bench_reset(void)
+{
+    ssd1306_bitmap_clear(&bench_bm);
+    ssd1306_bitmap_reset_dirty(&bench_bm);
+}
+
+uint32_t bench_random(void)
+{
+    bench_seed ^= bench_seed << 13u;
+    bench_seed ^= bench_seed >> 17u;
+    bench_seed ^= bench_seed << 5u;
+    return bench_seed;
+}
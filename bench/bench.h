@@ -0,0 +1,133 @@
+/**
+ * @file bench.h
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief Host-side benchmark harness. Every benchmark prints one line of
+ *        JSON, so the results can be compared between builds.
+ */
+
+#ifndef __SSD1306_BENCH_H
+#define __SSD1306_BENCH_H
+
+#include "ssd1306/ssd1306_bitmap.h"
+#include <stdint.h>
+
+/**
+ * @brief Minimum run time of a benchmark in nanoseconds.
+ */
+#ifndef BENCH_MIN_TIME_NS
+#define BENCH_MIN_TIME_NS 200000000ull
+#endif
+
+/**
+ * @brief Keeps the compiler from merging the iterations of a byte loop into
+ *        word or vector code, so the loop can stand for an 8-bit MCU build.
+ */
+#if defined(__GNUC__)
+#define BENCH_BARRIER() __asm__ volatile("" ::: "memory")
+#else
+#define BENCH_BARRIER()
+#endif
+
+/**
+ * @brief Bitmap array shared by the benchmarks.
+ */
+extern uint8_t bench_buffer[SSD1306_FRAMEBUFFER_SIZE(128, 64)];
+
+/**
+ * @brief 128x64 bitmap shared by the benchmarks, backed by bench_buffer.
+ */
+extern struct ssd1306_bitmap bench_bm;
+
+/**
+ * @brief Benchmarked operation.
+ * @param ctx Benchmark specific context.
+ */
+typedef void (*bench_fn)(void *ctx);
+
+/**
+ * @brief Returns a monotonic timestamp in nanoseconds.
+ */
+uint64_t bench_now(void);
+
+/**
+ * @brief Runs an operation until BENCH_MIN_TIME_NS have elapsed and prints
+ *        the time per operation and the pixel throughput.
+ * @param name Benchmark name.
+ * @param fn Operation to run.
+ * @param ctx Context passed to the operation.
+ * @param pixels Number of pixels drawn by one operation.
+ */
+void bench_run(const char *name, bench_fn fn, void *ctx, uint32_t pixels);
+
+/**
+ * @brief Runs an operation that writes to the SSD1306 and also prints the
+ *        bytes it sends per frame.
+ * @param name Benchmark name.
+ * @param fn Operation to run.
+ * @param ctx Context passed to the operation.
+ * @param pixels Number of pixels sent by one operation.
+ * @param bytes Number of bytes written to the transport by one operation.
+ */
+void bench_run_bytes(const char *name, bench_fn fn, void *ctx, uint32_t pixels,
+                     uint32_t bytes);
+
+/**
+ * @brief Returns the number of lit pixels of a bitmap array.
+ * @param data Bitmap array.
+ * @param length Number of bytes.
+ */
+uint32_t bench_count_pixels(const uint8_t *data, uint16_t length);
+
+/**
+ * @brief Clears bench_bm and its dirty marks, so each group of benchmarks
+ *        starts from the same state.
+ */
+void bench_reset(void);
+
+/**
+ * @brief Returns a pseudo-random number from a fixed seed, so every build
+ *        draws the same shapes.
+ */
+uint32_t bench_random(void);
+
+/**
+ * @brief Line and span benchmarks.
+ */
+void bench_lines(void);
+
+/**
+ * @brief Bulk bitmap operation benchmarks.
+ */
+void bench_bitmap(void);
+
+/**
+ * @brief Circle and polygon benchmarks.
+ */
+void bench_shapes(void);
+
+/**
+ * @brief Sprite benchmarks.
+ */
+void bench_sprite(void);
+
+/**
+ * @brief Text rendering benchmarks.
+ */
+void bench_text(void);
+
+/**
+ * @brief Numeric field benchmarks.
+ */
+void bench_numbers(void);
+
+/**
+ * @brief Seven-segment readout benchmarks.
+ */
+void bench_segments(void);
+
+/**
+ * @brief GDDRAM update benchmarks over the mock transport.
+ */
+void bench_flush(void);
+
+#endif /* !__SSD1306_BENCH_H */
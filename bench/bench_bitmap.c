@@ -0,0 +1,135 @@
+/**
+ * @file bench_bitmap.c
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief Compares the bulk bitmap operations against byte loops. Build with
+ *        -DSSD1306_WORD_TYPE=uint32_t to measure a 32-bit word.
+ */
+
+#include "bench.h"
+#include "ssd1306/ssd1306_bitmap.h"
+#include <stdio.h>
+#include <string.h>
+
+static uint8_t bench_src[SSD1306_FRAMEBUFFER_SIZE(128, 64)];
+
+static struct ssd1306_bitmap bench_src_bm = {
+    .width = 128,
+    .height = 64,
+    .length = sizeof(bench_src),
+    .data = bench_src,
+};
+
+static const uint8_t bench_pattern[8] = {0x55, 0xAA, 0x55, 0xAA,
+                                         0x55, 0xAA, 0x55, 0xAA};
+
+static void bench_clear_bytes(void *ctx)
+{
+    uint8_t *data = bench_buffer;
+    (void)ctx;
+
+    for (uint16_t i = 0; i < sizeof(bench_buffer); i++) {
+        data[i] = 0x00;
+        BENCH_BARRIER();
+    }
+}
+
+static void bench_clear_words(void *ctx)
+{
+    (void)ctx;
+    ssd1306_bitmap_clear(&bench_bm);
+}
+
+static void bench_fill_bytes(void *ctx)
+{
+    uint8_t *data = bench_buffer;
+    (void)ctx;
+
+    for (uint16_t i = 0; i < sizeof(bench_buffer); i++) {
+        data[i] = bench_pattern[i & 7u];
+        BENCH_BARRIER();
+    }
+}
+
+static void bench_fill_words(void *ctx)
+{
+    (void)ctx;
+    ssd1306_bitmap_fill(&bench_bm, bench_pattern);
+}
+
+static void bench_invert_bytes(void *ctx)
+{
+    uint8_t *data = bench_buffer;
+    (void)ctx;
+
+    for (uint16_t i = 0; i < sizeof(bench_buffer); i++) {
+        data[i] ^= 0xFF;
+        BENCH_BARRIER();
+    }
+}
+
+static void bench_invert_words(void *ctx)
+{
+    (void)ctx;
+    ssd1306_bitmap_invert(&bench_bm);
+}
+
+static void bench_copy_bytes(void *ctx)
+{
+    uint8_t *data = bench_buffer;
+    (void)ctx;
+
+    for (uint16_t i = 0; i < sizeof(bench_buffer); i++) {
+        data[i] = bench_src[i];
+        BENCH_BARRIER();
+    }
+}
+
+static void bench_copy_words(void *ctx)
+{
+    (void)ctx;
+    ssd1306_bitmap_copy(&bench_bm, &bench_src_bm);
+}
+
+static void bench_xor_bytes(void *ctx)
+{
+    uint8_t *data = bench_buffer;
+    (void)ctx;
+
+    for (uint16_t i = 0; i < sizeof(bench_buffer); i++) {
+        data[i] ^= bench_src[i];
+        BENCH_BARRIER();
+    }
+}
+
+static void bench_xor_words(void *ctx)
+{
+    (void)ctx;
+    ssd1306_bitmap_merge(&bench_bm, &bench_src_bm, SSD1306_ROP_XOR);
+}
+
+void bench_bitmap(void)
+{
+    char name[32];
+    uint32_t pixels = sizeof(bench_buffer) * 8u;
+    unsigned bits = sizeof(SSD1306_WORD_TYPE) * 8u;
+
+    for (uint16_t i = 0; i < sizeof(bench_src); i++) {
+        bench_src[i] = bench_random();
+    }
+
+    bench_run("bitmap_clear_bytes", bench_clear_bytes, NULL, pixels);
+    snprintf(name, sizeof(name), "bitmap_clear_word%u", bits);
+    bench_run(name, bench_clear_words, NULL, pixels);
+    bench_run("bitmap_fill_bytes", bench_fill_bytes, NULL, pixels);
+    snprintf(name, sizeof(name), "bitmap_fill_word%u", bits);
+    bench_run(name, bench_fill_words, NULL, pixels);
+    bench_run("bitmap_invert_bytes", bench_invert_bytes, NULL, pixels);
+    snprintf(name, sizeof(name), "bitmap_invert_word%u", bits);
+    bench_run(name, bench_invert_words, NULL, pixels);
+    bench_run("bitmap_copy_bytes", bench_copy_bytes, NULL, pixels);
+    snprintf(name, sizeof(name), "bitmap_copy_word%u", bits);
+    bench_run(name, bench_copy_words, NULL, pixels);
+    bench_run("bitmap_xor_bytes", bench_xor_bytes, NULL, pixels);
+    snprintf(name, sizeof(name), "bitmap_xor_word%u", bits);
+    bench_run(name, bench_xor_words, NULL, pixels);
+}
@@ -0,0 +1,120 @@
+/**
+ * @file bench_flush.c
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief Measures the GDDRAM update functions over the mock transport and
+ *        the bytes they send per frame.
+ */
+
+#include "bench.h"
+#include "ssd1306/ssd1306.h"
+#include "ssd1306/ssd1306_graphics.h"
+#include "ssd1306_mock.h"
+#include <stddef.h>
+
+/**
+ * @brief Size of the rectangle redrawn by the partial update benchmarks.
+ */
+#define BENCH_RECT_SIZE 16u
+
+/**
+ * @brief Bitmap array with the control byte reserved by
+ *        ssd1306_update_gddram.
+ */
+static uint8_t bench_frame[SSD1306_FRAMEBUFFER_SIZE(128, 64) + 1u];
+
+static uint8_t bench_shadow_data[SSD1306_FRAMEBUFFER_SIZE(128, 64)];
+
+static struct ssd1306_shadow bench_shadow = {
+    .data = bench_shadow_data,
+    .length = sizeof(bench_shadow_data),
+};
+
+static struct ssd1306_driver bench_driver;
+
+/**
+ * @brief Draws or clears the rectangle, so every partial update has
+ *        something to send.
+ */
+static void bench_toggle_rect(void)
+{
+    static uint8_t lit;
+
+    lit = !lit;
+    if (lit)
+        ssd1306_fill_rect(&bench_bm, 56, 24, BENCH_RECT_SIZE, BENCH_RECT_SIZE,
+                          NULL);
+    else
+        ssd1306_clear_rect(&bench_bm, 56, 24, BENCH_RECT_SIZE,
+                           BENCH_RECT_SIZE);
+}
+
+static void bench_update_gddram(void *ctx)
+{
+    (void)ctx;
+    ssd1306_mock_reset();
+    ssd1306_update_gddram(&bench_driver, bench_frame, sizeof(bench_frame));
+}
+
+static void bench_update_pages(void *ctx)
+{
+    (void)ctx;
+    ssd1306_mock_reset();
+    ssd1306_update_gddram_pages(&bench_driver, &bench_bm, 0, 7);
+}
+
+static void bench_update_dirty(void *ctx)
+{
+    (void)ctx;
+    ssd1306_mock_reset();
+    bench_toggle_rect();
+    ssd1306_update_dirty_gddram(&bench_driver, &bench_bm);
+}
+
+static void bench_update_diff(void *ctx)
+{
+    (void)ctx;
+    ssd1306_mock_reset();
+    bench_toggle_rect();
+    ssd1306_update_gddram_diff(&bench_driver, &bench_bm, &bench_shadow);
+}
+
+/**
+ * @brief Runs a GDDRAM update benchmark, counting the bytes written to the
+ *        mock transport by one frame.
+ * @param name Benchmark name.
+ * @param fn Operation to run.
+ * @param pixels Number of pixels changed by one frame.
+ */
+static void bench_flush_run(const char *name, bench_fn fn, uint32_t pixels)
+{
+    fn(NULL);
+    fn(NULL);
+    bench_run_bytes(name, fn, NULL, pixels, ssd1306_mock.length);
+}
+
+void bench_flush(void)
+{
+    uint32_t frame = 128u * 64u;
+    uint32_t rect = BENCH_RECT_SIZE * BENCH_RECT_SIZE;
+
+    for (uint16_t i = 0; i < sizeof(bench_buffer); i++) {
+        bench_buffer[i] = bench_random();
+        bench_frame[i + 1u] = bench_buffer[i];
+    }
+
+    ssd1306_mock_attach(&bench_driver, &ssd1306_i2c_transport, NULL);
+    bench_flush_run("update_gddram_i2c", bench_update_gddram, frame);
+    bench_flush_run("update_gddram_pages_i2c", bench_update_pages, frame);
+    bench_flush_run("update_dirty_gddram_i2c", bench_update_dirty, rect);
+    bench_flush_run("update_gddram_diff_i2c", bench_update_diff, rect);
+
+    /* Without i2c_writev, the bitmap is sent in place. */
+    bench_driver.i2c_writev = NULL;
+    bench_flush_run("update_gddram_pages_i2c_write", bench_update_pages,
+                    frame);
+    bench_flush_run("update_dirty_gddram_i2c_write", bench_update_dirty, rect);
+
+    ssd1306_mock_attach(&bench_driver, &ssd1306_spi_transport, NULL);
+    bench_flush_run("update_gddram_pages_spi", bench_update_pages, frame);
+    bench_flush_run("update_dirty_gddram_spi", bench_update_dirty, rect);
+}
@@ -0,0 +1,170 @@
+/**
+ * @file bench_lines.c
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief Compares the span kernels against drawing every pixel with
+ *        ssd1306_set_pixel.
+ */
+
+#include "bench.h"
+#include "ssd1306/ssd1306_graphics.h"
+#include <stdlib.h>
+
+/**
+ * @brief Number of shapes drawn by one operation.
+ */
+#define BENCH_LINES 64u
+
+/**
+ * @brief Struct holding a set of lines.
+ */
+struct bench_line_set {
+    int8_t x1[BENCH_LINES]; /**< Start points on the x-axis. */
+    int8_t y1[BENCH_LINES]; /**< Start points on the y-axis. */
+    int8_t x2[BENCH_LINES]; /**< End points on the x-axis. */
+    int8_t y2[BENCH_LINES]; /**< End points on the y-axis. */
+    uint32_t pixels;        /**< Number of pixels of all the lines. */
+};
+
+/**
+ * @brief Draws a line pixel by pixel, the way ssd1306_draw_line did before
+ *        the span kernels.
+ */
+static void bench_line_per_pixel(struct ssd1306_bitmap *bm, int8_t x1,
+                                 int8_t y1, int8_t x2, int8_t y2)
+{
+    int16_t dx = abs(x2 - x1);
+    int16_t dy = -abs(y2 - y1);
+    int16_t sx = x1 < x2 ? 1 : -1;
+    int16_t sy = y1 < y2 ? 1 : -1;
+    int16_t e = dx + dy;
+    int16_t de;
+
+    for (;;) {
+        ssd1306_set_pixel(bm, x1, y1);
+        de = 2 * e;
+
+        if (de >= dy) {
+            if (x1 == x2)
+                break;
+            e += dy;
+            x1 += sx;
+        }
+
+        if (de <= dx) {
+            if (y1 == y2)
+                break;
+            e += dx;
+            y1 += sy;
+        }
+    }
+}
+
+/**
+ * @brief Fills a set with random lines.
+ * @param set Pointer to a bench_line_set struct.
+ * @param steep Non-zero to generate steep lines, zero for shallow lines.
+ */
+static void bench_line_set_init(struct bench_line_set *set, uint8_t steep)
+{
+    set->pixels = 0;
+
+    for (uint8_t i = 0; i < BENCH_LINES; i++) {
+        int16_t a1 = bench_random() % 64u;
+        int16_t a2 = bench_random() % 64u;
+        int16_t b1 = bench_random() % 128u;
+        int16_t b2 = b1 + (a2 - a1) / 4;
+
+        if (b2 < 0 || b2 > 127)
+            b2 = b1;
+
+        set->x1[i] = steep ? b1 : a1 * 2;
+        set->x2[i] = steep ? b2 : a2 * 2;
+        set->y1[i] = steep ? a1 : b1 / 2;
+        set->y2[i] = steep ? a2 : b2 / 2;
+
+        int16_t dx = abs(set->x2[i] - set->x1[i]);
+        int16_t dy = abs(set->y2[i] - set->y1[i]);
+        set->pixels += (dx > dy ? dx : dy) + 1u;
+    }
+}
+
+static void bench_lines_per_pixel(void *ctx)
+{
+    struct bench_line_set *set = ctx;
+
+    for (uint8_t i = 0; i < BENCH_LINES; i++) {
+        bench_line_per_pixel(&bench_bm, set->x1[i], set->y1[i], set->x2[i],
+                             set->y2[i]);
+    }
+}
+
+static void bench_lines_spans(void *ctx)
+{
+    struct bench_line_set *set = ctx;
+
+    for (uint8_t i = 0; i < BENCH_LINES; i++) {
+        ssd1306_draw_line(&bench_bm, set->x1[i], set->y1[i], set->x2[i],
+                          set->y2[i]);
+    }
+}
+
+static void bench_hlines_per_pixel(void *ctx)
+{
+    (void)ctx;
+
+    for (uint8_t y = 0; y < 64u; y++) {
+        for (uint8_t x = 0; x < 128u; x++) {
+            ssd1306_set_pixel(&bench_bm, x, y);
+        }
+    }
+}
+
+static void bench_hlines_spans(void *ctx)
+{
+    (void)ctx;
+
+    for (uint8_t y = 0; y < 64u; y++) {
+        ssd1306_draw_hline(&bench_bm, 0, y, 128u);
+    }
+}
+
+static void bench_vlines_per_pixel(void *ctx)
+{
+    (void)ctx;
+
+    for (uint8_t x = 0; x < 128u; x++) {
+        for (uint8_t y = 0; y < 64u; y++) {
+            ssd1306_set_pixel(&bench_bm, x, y);
+        }
+    }
+}
+
+static void bench_vlines_spans(void *ctx)
+{
+    (void)ctx;
+
+    for (uint8_t x = 0; x < 128u; x++) {
+        ssd1306_draw_vline(&bench_bm, x, 0, 64u);
+    }
+}
+
+void bench_lines(void)
+{
+    static struct bench_line_set shallow;
+    static struct bench_line_set steep;
+
+    bench_line_set_init(&shallow, 0);
+    bench_line_set_init(&steep, 1);
+
+    bench_run("line_shallow_per_pixel", bench_lines_per_pixel, &shallow,
+              shallow.pixels);
+    bench_run("line_shallow_spans", bench_lines_spans, &shallow,
+              shallow.pixels);
+    bench_run("line_steep_per_pixel", bench_lines_per_pixel, &steep,
+              steep.pixels);
+    bench_run("line_steep_spans", bench_lines_spans, &steep, steep.pixels);
+    bench_run("hline_per_pixel", bench_hlines_per_pixel, NULL, 128u * 64u);
+    bench_run("hline_spans", bench_hlines_spans, NULL, 128u * 64u);
+    bench_run("vline_per_pixel", bench_vlines_per_pixel, NULL, 128u * 64u);
+    bench_run("vline_spans", bench_vlines_spans, NULL, 128u * 64u);
+}
@@ -0,0 +1,21 @@
+/**
+ * @file bench_main.c
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief Runs every host-side benchmark.
+ */
+
+#include "bench.h"
+
+int main(void)
+{
+    static void (*const groups[])(void) = {
+        bench_lines, bench_shapes,   bench_bitmap,   bench_sprite,
+        bench_text,  bench_numbers,  bench_segments, bench_flush,
+    };
+
+    for (uint8_t i = 0; i < sizeof(groups) / sizeof(groups[0]); i++) {
+        bench_reset();
+        groups[i]();
+    }
+    return 0;
+}
@@ -0,0 +1,96 @@
+/**
+ * @file bench_number.c
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief Compares drawing a changing sensor value through snprintf and
+ *        ssd1306_draw_text_at with a ssd1306_number field.
+ */
+
+#include "bench.h"
+#include "ssd1306/font/ssd1306_font_7x11.h"
+#include "ssd1306/ssd1306_graphics.h"
+#include "ssd1306/ssd1306_number.h"
+#include <stddef.h>
+#include <stdio.h>
+
+/**
+ * @brief Characters of the benchmark field.
+ */
+#define BENCH_NUMBER_WIDTH 7u
+
+static struct ssd1306_text bench_renderer = {
+    .bitmap = &bench_bm,
+    .font = &font_7x11,
+};
+
+static char bench_drawn[BENCH_NUMBER_WIDTH];
+
+static struct ssd1306_number bench_field = {
+    .text = &bench_renderer,
+    .x = 0,
+    .y = 16,
+    .width = BENCH_NUMBER_WIDTH,
+    .precision = 2,
+    .drawn = bench_drawn,
+};
+
+/**
+ * @brief Sensor value, which drifts by a few hundredths on each frame.
+ */
+static float bench_value = 21.5f;
+
+/**
+ * @brief Moves the sensor value to the next frame.
+ */
+static void bench_next_value(void)
+{
+    bench_value += (float)(bench_random() % 7u) * 0.01f - 0.03f;
+}
+
+static void bench_number_snprintf(void *ctx)
+{
+    char str[16];
+
+    (void)ctx;
+    bench_next_value();
+    snprintf(str, sizeof(str), "%*.*f", (int)bench_field.width,
+             (int)bench_field.precision, (double)bench_value);
+    ssd1306_clear_rect(&bench_bm, bench_field.x, bench_field.y,
+                       ssd1306_number_width(&bench_field), 16);
+    ssd1306_draw_text_at(&bench_renderer, bench_field.x, bench_field.y, str,
+                         SSD1306_ROP_OR);
+}
+
+static void bench_number_float(void *ctx)
+{
+    (void)ctx;
+    bench_next_value();
+    ssd1306_draw_float(&bench_field, bench_value);
+}
+
+static void bench_number_float_full(void *ctx)
+{
+    (void)ctx;
+    bench_next_value();
+    ssd1306_number_invalidate(&bench_field);
+    ssd1306_draw_float(&bench_field, bench_value);
+}
+
+static void bench_number_fixed(void *ctx)
+{
+    (void)ctx;
+    bench_next_value();
+    ssd1306_draw_fixed(&bench_field, (int32_t)(bench_value * 256.0f), 8);
+}
+
+void bench_numbers(void)
+{
+    uint32_t pixels;
+
+    ssd1306_number_init(&bench_field);
+    pixels = ssd1306_number_width(&bench_field) * 16u;
+
+    bench_run("number_snprintf", bench_number_snprintf, NULL, pixels);
+    bench_run("number_float", bench_number_float, NULL, pixels);
+    bench_run("number_float_full", bench_number_float_full, NULL, pixels);
+    bench_run("number_fixed", bench_number_fixed, NULL, pixels);
+}
@@ -0,0 +1,114 @@
+/**
+ * @file bench_segment.c
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief Compares a counter drawn with font_7segment and with the procedural
+ *        seven-segment readout, and the bitmap bytes each update dirties.
+ */
+
+#include "bench.h"
+#include "ssd1306/font/ssd1306_font_7seg_17x30.h"
+#include "ssd1306/ssd1306_graphics.h"
+#include "ssd1306/ssd1306_segment.h"
+#include "ssd1306/ssd1306_text.h"
+#include <stddef.h>
+#include <string.h>
+
+/**
+ * @brief Digits of the counter.
+ */
+#define BENCH_SEGMENT_DIGITS 4u
+
+static struct ssd1306_text bench_renderer = {
+    .bitmap = &bench_bm,
+    .font = &font_7segment,
+};
+
+static uint8_t bench_drawn[BENCH_SEGMENT_DIGITS];
+
+/**
+ * @brief Readout with the size and spacing of font_7segment.
+ */
+static struct ssd1306_segment_display bench_display = {
+    .bitmap = &bench_bm,
+    .x = 0,
+    .y = 16,
+    .digit_width = 17,
+    .digit_height = 30,
+    .thickness = 3,
+    .spacing = 4,
+    .digits = BENCH_SEGMENT_DIGITS,
+    .drawn = bench_drawn,
+};
+
+static char bench_counter[BENCH_SEGMENT_DIGITS + 1u] = "0000";
+
+/**
+ * @brief Increments the decimal counter string.
+ */
+static void bench_next_counter(void)
+{
+    for (uint8_t i = BENCH_SEGMENT_DIGITS; i-- > 0;) {
+        if (bench_counter[i] != '9') {
+            bench_counter[i]++;
+            return;
+        }
+        bench_counter[i] = '0';
+    }
+}
+
+static void bench_segment_font(void *ctx)
+{
+    (void)ctx;
+    bench_next_counter();
+    ssd1306_clear_rect(&bench_bm, 0, 16, 84, 32);
+    ssd1306_draw_text_at(&bench_renderer, 0, 16, bench_counter,
+                         SSD1306_ROP_OR);
+}
+
+static void bench_segment_full(void *ctx)
+{
+    (void)ctx;
+    bench_next_counter();
+    ssd1306_segment_invalidate(&bench_display);
+    ssd1306_segment_print(&bench_display, bench_counter);
+}
+
+static void bench_segment_incremental(void *ctx)
+{
+    (void)ctx;
+    bench_next_counter();
+    ssd1306_segment_print(&bench_display, bench_counter);
+}
+
+/**
+ * @brief Runs a counter benchmark, counting the bitmap bytes dirtied by one
+ *        update.
+ * @param name Benchmark name.
+ * @param fn Operation to run.
+ * @param pixels Number of pixels of the counter.
+ */
+static void bench_segment_run(const char *name, bench_fn fn, uint32_t pixels)
+{
+    uint32_t bytes = 0;
+
+    /* The bytes are counted from the same value on every run. */
+    memcpy(bench_counter, "0000", sizeof(bench_counter));
+    fn(NULL);
+    ssd1306_bitmap_reset_dirty(&bench_bm);
+    fn(NULL);
+    for (uint8_t p = 0; p < ssd1306_bitmap_pages(&bench_bm); p++) {
+        if (bench_bm.dirty_end[p])
+            bytes += bench_bm.dirty_end[p] - bench_bm.dirty_start[p];
+    }
+    bench_run_bytes(name, fn, NULL, pixels, bytes);
+}
+
+void bench_segments(void)
+{
+    uint32_t pixels = 84u * 32u;
+
+    bench_segment_run("segment_font_7segment", bench_segment_font, pixels);
+    bench_segment_run("segment_full", bench_segment_full, pixels);
+    bench_segment_run("segment_incremental", bench_segment_incremental,
+                      pixels);
+}
@@ -0,0 +1,58 @@
+/**
+ * @file bench_shapes.c
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief Measures ssd1306_draw_circle and ssd1306_draw_polygon.
+ */
+
+#include "bench.h"
+#include "ssd1306/ssd1306_bitmap.h"
+#include "ssd1306/ssd1306_graphics.h"
+#include <stddef.h>
+
+/**
+ * @brief Number of vertices of the benchmarked polygon.
+ */
+#define BENCH_POLYGON_POINTS 12u
+
+static int8_t bench_polygon_x[BENCH_POLYGON_POINTS];
+static int8_t bench_polygon_y[BENCH_POLYGON_POINTS];
+
+static void bench_circles(void *ctx)
+{
+    (void)ctx;
+
+    for (int8_t r = 4; r < 32; r += 4) {
+        ssd1306_draw_circle(&bench_bm, 64, 32, r);
+    }
+}
+
+static void bench_polygon(void *ctx)
+{
+    (void)ctx;
+    ssd1306_draw_polygon(&bench_bm, bench_polygon_x, bench_polygon_y,
+                         BENCH_POLYGON_POINTS);
+}
+
+/**
+ * @brief Returns the number of pixels drawn by an operation on a clear
+ *        bitmap.
+ * @param fn Operation to run.
+ */
+static uint32_t bench_shape_pixels(bench_fn fn)
+{
+    ssd1306_bitmap_clear(&bench_bm);
+    fn(NULL);
+    return bench_count_pixels(bench_buffer, sizeof(bench_buffer));
+}
+
+void bench_shapes(void)
+{
+    for (uint8_t i = 0; i < BENCH_POLYGON_POINTS; i++) {
+        bench_polygon_x[i] = bench_random() % 128u;
+        bench_polygon_y[i] = bench_random() % 64u;
+    }
+
+    bench_run("circle", bench_circles, NULL, bench_shape_pixels(bench_circles));
+    bench_run("polygon", bench_polygon, NULL,
+              bench_shape_pixels(bench_polygon));
+}
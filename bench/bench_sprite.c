@@ -0,0 +1,67 @@
+/**
+ * @file bench_sprite.c
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief Compares ssd1306_draw_sprite against drawing every pixel with
+ *        ssd1306_set_pixel.
+ */
+
+#include "bench.h"
+#include "ssd1306/ssd1306_graphics.h"
+#include "ssd1306/ssd1306_sprite.h"
+#include <stddef.h>
+
+static uint8_t bench_icon_data[2 * 16];
+
+static const struct ssd1306_sprite bench_icon = {
+    .width = 16,
+    .height = 16,
+    .data = bench_icon_data,
+};
+
+static void bench_sprite_per_pixel(void *ctx)
+{
+    (void)ctx;
+
+    for (uint8_t y = 0; y < 48u; y += 5u) {
+        for (uint8_t sy = 0; sy < 16u; sy++) {
+            for (uint8_t sx = 0; sx < 16u; sx++) {
+                uint8_t byte = bench_icon_data[(sy >> 3u) * 16u + sx];
+
+                if (byte & (1u << (sy & 7u)))
+                    ssd1306_set_pixel(&bench_bm, y * 2u + sx, y + sy);
+            }
+        }
+    }
+}
+
+static void bench_sprite_or(void *ctx)
+{
+    (void)ctx;
+
+    for (uint8_t y = 0; y < 48u; y += 5u) {
+        ssd1306_draw_sprite(&bench_bm, &bench_icon, y * 2u, y, SSD1306_ROP_OR);
+    }
+}
+
+static void bench_sprite_copy(void *ctx)
+{
+    (void)ctx;
+
+    for (uint8_t y = 0; y < 48u; y += 5u) {
+        ssd1306_draw_sprite(&bench_bm, &bench_icon, y * 2u, y,
+                            SSD1306_ROP_COPY);
+    }
+}
+
+void bench_sprite(void)
+{
+    uint32_t pixels = 10u * 16u * 16u;
+
+    for (uint8_t i = 0; i < sizeof(bench_icon_data); i++) {
+        bench_icon_data[i] = bench_random();
+    }
+
+    bench_run("sprite16_per_pixel", bench_sprite_per_pixel, NULL, pixels);
+    bench_run("sprite16_or", bench_sprite_or, NULL, pixels);
+    bench_run("sprite16_copy", bench_sprite_copy, NULL, pixels);
+}
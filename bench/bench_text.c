@@ -0,0 +1,162 @@
+/**
+ * @file bench_text.c
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief Compares page-aligned and pixel-addressed text rendering, and
+ *        measures each bundled font and a digits subset of font_7x11 raw
+ *        and RLE encoded.
+ */
+
+#include "bench.h"
+#include "font_7x11_digits.h"
+#include "ssd1306/font/ssd1306_font_5x7.h"
+#include "ssd1306/font/ssd1306_font_7seg_17x30.h"
+#include "ssd1306/font/ssd1306_font_7x11.h"
+#include "ssd1306/ssd1306_text.h"
+#include "ssd1306_font_rle.h"
+#include <stddef.h>
+#include <stdio.h>
+
+/**
+ * @brief Size of the buffer receiving a RLE encoded font.
+ */
+#define BENCH_RLE_SIZE 2048u
+
+static struct ssd1306_text bench_renderer = {
+    .bitmap = &bench_bm,
+    .font = &font_7x11,
+};
+
+static const char bench_str[] = "The quick brown fox";
+
+static const char bench_digits[] = "12:34";
+
+static const char bench_number[] = "12.5%";
+
+/**
+ * @brief Struct holding a font benchmark.
+ */
+struct bench_font {
+    const char *name;                /**< Font name. */
+    const struct ssd1306_font *font; /**< Raw font. */
+    const char *str;                 /**< Text to draw. */
+};
+
+static const struct bench_font bench_fonts[] = {
+    {"font_5x7", &font_5x7, bench_str},
+    {"font_7x11", &font_7x11, bench_str},
+    {"font_7segment", &font_7segment, bench_digits},
+    {"font_7x11_digits", &font_7x11_digits, bench_number},
+};
+
+/**
+ * @brief Struct holding the text drawn by a font benchmark.
+ */
+struct bench_font_text {
+    struct ssd1306_text text; /**< Bitmap and font to draw with. */
+    const char *str;          /**< Text to draw. */
+};
+
+static void bench_text_cursor(void *ctx)
+{
+    (void)ctx;
+    ssd1306_set_cursor_position(&bench_renderer, 0, 2);
+    ssd1306_draw_text(&bench_renderer, bench_str);
+}
+
+static void bench_text_aligned(void *ctx)
+{
+    (void)ctx;
+    ssd1306_draw_text_at(&bench_renderer, 0, 16, bench_str,
+                         SSD1306_ROP_COPY);
+}
+
+static void bench_text_unaligned(void *ctx)
+{
+    (void)ctx;
+    ssd1306_draw_text_at(&bench_renderer, 0, 19, bench_str,
+                         SSD1306_ROP_OR);
+}
+
+static void bench_text_font(void *ctx)
+{
+    struct bench_font_text *f = ctx;
+
+    ssd1306_set_cursor_position(&f->text, 0, 0);
+    ssd1306_draw_text(&f->text, f->str);
+}
+
+static void bench_text_font_unaligned(void *ctx)
+{
+    struct bench_font_text *f = ctx;
+
+    ssd1306_draw_text_at(&f->text, 0, 3, f->str, SSD1306_ROP_OR);
+}
+
+/**
+ * @brief Measures a raw font and its RLE encoding, and prints the flash used
+ *        by the glyph data and offsets of each one.
+ * @param f Pointer to a bench_font struct.
+ */
+static void bench_font_encodings(const struct bench_font *f)
+{
+    static uint8_t data[BENCH_RLE_SIZE];
+    static uint16_t offsets[256];
+    const struct ssd1306_font *raw = f->font;
+    uint16_t glyphs = ssd1306_font_glyphs(raw);
+    uint16_t length = ssd1306_font_rle_encode(raw, data, sizeof(data), offsets);
+    struct ssd1306_font rle = {
+        .type = raw->type,
+        .first_char = raw->first_char,
+        .last_char = raw->last_char,
+        .space_width = raw->space_width,
+        .horizontal_separation = raw->horizontal_separation,
+        .page_alignment = raw->page_alignment,
+        .data = data,
+        .data_length = length,
+        .char_width = raw->char_width,
+        .char_offset = offsets,
+        .encoding = SSD1306_RLE_FONT,
+        .ranges = raw->ranges,
+        .range_count = raw->range_count,
+    };
+    struct bench_font_text text = {{&bench_bm, raw, 0, 0}, f->str};
+    uint32_t pixels =
+        ssd1306_text_width(&text.text, f->str) * raw->page_alignment * 8u;
+    uint32_t raw_bytes =
+        raw->data_length + ssd1306_font_offsets(raw) * sizeof(uint16_t);
+    uint32_t rle_bytes =
+        length + ssd1306_font_offsets(&rle) * sizeof(uint16_t);
+    char name[48];
+
+    if (raw->type == SSD1306_VARIABLE_WIDTH_FONT) {
+        raw_bytes += glyphs * sizeof(uint8_t);
+        rle_bytes += glyphs * sizeof(uint8_t);
+    }
+    printf("{\"name\": \"%s\", \"raw_bytes\": %u, \"rle_bytes\": %u}\n",
+           f->name, (unsigned)raw_bytes, (unsigned)rle_bytes);
+
+    snprintf(name, sizeof(name), "text_%s", f->name);
+    bench_run(name, bench_text_font, &text, pixels);
+    snprintf(name, sizeof(name), "text_at_%s", f->name);
+    bench_run(name, bench_text_font_unaligned, &text, pixels);
+
+    text.text.font = &rle;
+    snprintf(name, sizeof(name), "text_%s_rle", f->name);
+    bench_run(name, bench_text_font, &text, pixels);
+    snprintf(name, sizeof(name), "text_at_%s_rle", f->name);
+    bench_run(name, bench_text_font_unaligned, &text, pixels);
+}
+
+void bench_text(void)
+{
+    uint32_t pixels = ssd1306_text_width(&bench_renderer, bench_str) * 16u;
+
+    bench_run("text_cursor", bench_text_cursor, NULL, pixels);
+    bench_run("text_at_aligned_copy", bench_text_aligned, NULL, pixels);
+    bench_run("text_at_unaligned_or", bench_text_unaligned, NULL, pixels);
+
+    for (uint8_t i = 0; i < sizeof(bench_fonts) / sizeof(bench_fonts[0]);
+         i++) {
+        bench_font_encodings(&bench_fonts[i]);
+    }
+}
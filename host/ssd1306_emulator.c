@@ -0,0 +1,523 @@
+/**
+ * @file ssd1306_emulator.c
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief Host-side model of the SSD1306 controller. It decodes the I2C or
+ *        SPI byte stream written by the driver into a GDDRAM image and
+ *        renders the panel as seen by the user.
+ */
+
+#include "ssd1306_emulator.h"
+#include <string.h>
+
+/**
+ * @brief Value of the I2C decoder state when a control byte is expected.
+ */
+#define SSD1306_EMULATOR_CONTROL 0x100u
+
+/**
+ * @brief Driver whose transfer is being written. The bus functions don't
+ *        take a driver, so the emulator transport sets it before calling the
+ *        I2C or SPI transport, and the emulator is found in its context.
+ */
+static struct ssd1306_driver *emulator_driver;
+
+/**
+ * @brief Frames between steps of each ssd1306_scrolling_rate value.
+ */
+static const uint16_t ssd1306_emulator_rates[8] = {5, 64, 128, 256,
+                                                   3, 4,  25,  2};
+
+/**
+ * @brief Returns the number of arguments of a command.
+ * @param cmd Command byte.
+ */
+static uint8_t _ssd1306_emulator_arguments(uint8_t cmd)
+{
+    switch (cmd) {
+    case SSD1306_COMMAND_SET_CONTRAST_CONTROL:
+    case SSD1306_COMMAND_CHARGE_PUMP_SETTING:
+    case SSD1306_COMMAND_SET_MEMORY_ADDRESSING_MODE:
+    case SSD1306_COMMAND_SET_MUX_RATIO:
+    case SSD1306_COMMAND_SET_DISPLAY_OFFSET:
+    case SSD1306_COMMAND_SET_COM_PINS_CONFIGURATION:
+    case SSD1306_COMMAND_SET_OSCILLATOR_FREQUENCY:
+    case SSD1306_COMMAND_SET_PRECHARGE_PERIOD:
+    case SSD1306_COMMAND_SET_DESELECT_LEVEL:
+        return 1;
+    case SSD1306_COMMAND_SET_COLUMN_ADDRESS:
+    case SSD1306_COMMAND_SET_PAGE_ADDRESS:
+    case SSD1306_COMMAND_SET_VERTICAL_SCROLL_AREA:
+        return 2;
+    case SSD1306_COMMAND_VERTICAL_AND_RIGHT_SCROLL_SETUP:
+    case SSD1306_COMMAND_VERTICAL_AND_LEFT_SCROLL_SETUP:
+        return 5;
+    case SSD1306_COMMAND_RIGHT_SCROLL_SETUP:
+    case SSD1306_COMMAND_LEFT_SCROLL_SETUP:
+    case SSD1306_COMMAND_RIGHT_ONE_COLUMN_SCROLL:
+    case SSD1306_COMMAND_LEFT_ONE_COLUMN_SCROLL:
+        return 6;
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief Shifts the GDDRAM contents of some pages by one column.
+ * @param emu Pointer to a ssd1306_emulator struct.
+ * @param start_page First page.
+ * @param end_page Last page.
+ * @param left 1 to shift to the left, 0 to shift to the right.
+ */
+static void _ssd1306_emulator_shift(struct ssd1306_emulator *emu,
+                                    uint8_t start_page, uint8_t end_page,
+                                    uint8_t left)
+{
+    uint8_t last = SSD1306_EMULATOR_WIDTH - 1u;
+
+    for (uint8_t p = start_page; p <= end_page && p < SSD1306_MAX_PAGES;
+         p++) {
+        uint8_t *row = emu->gddram[p];
+
+        if (left) {
+            uint8_t first = row[0];
+            memmove(row, row + 1, last);
+            row[last] = first;
+        } else {
+            uint8_t end = row[last];
+            memmove(row + 1, row, last);
+            row[0] = end;
+        }
+    }
+}
+
+/**
+ * @brief Executes the command stored in the command buffer.
+ * @param emu Pointer to a ssd1306_emulator struct.
+ */
+static void _ssd1306_emulator_execute(struct ssd1306_emulator *emu)
+{
+    const uint8_t *c = emu->command;
+
+    switch (c[0]) {
+    case SSD1306_COMMAND_SET_CONTRAST_CONTROL:
+        emu->contrast = c[1];
+        break;
+    case SSD1306_COMMAND_CHARGE_PUMP_SETTING:
+        emu->charge_pump = c[1];
+        break;
+    case SSD1306_COMMAND_SET_MEMORY_ADDRESSING_MODE:
+        emu->addressing_mode = c[1] & 0x03;
+        break;
+    case SSD1306_COMMAND_SET_COLUMN_ADDRESS:
+        emu->start_column = c[1] & 0x7F;
+        emu->end_column = c[2] & 0x7F;
+        emu->column = emu->start_column;
+        break;
+    case SSD1306_COMMAND_SET_PAGE_ADDRESS:
+        emu->start_page = c[1] & 0x07;
+        emu->end_page = c[2] & 0x07;
+        emu->page = emu->start_page;
+        break;
+    case SSD1306_COMMAND_SET_MUX_RATIO:
+        emu->mux_ratio = c[1] & 0x3F;
+        break;
+    case SSD1306_COMMAND_SET_DISPLAY_OFFSET:
+        emu->display_offset = c[1] & 0x3F;
+        break;
+    case SSD1306_COMMAND_SET_COM_PINS_CONFIGURATION:
+        emu->com_pins = c[1];
+        break;
+    case SSD1306_COMMAND_SET_VERTICAL_SCROLL_AREA:
+        emu->fixed_rows = c[1] & 0x3F;
+        emu->scroll_rows = c[2] & 0x7F;
+        break;
+    case SSD1306_COMMAND_RIGHT_SCROLL_SETUP:
+    case SSD1306_COMMAND_LEFT_SCROLL_SETUP:
+    case SSD1306_COMMAND_VERTICAL_AND_RIGHT_SCROLL_SETUP:
+    case SSD1306_COMMAND_VERTICAL_AND_LEFT_SCROLL_SETUP:
+        memcpy(emu->scroll_setup, c, sizeof(emu->scroll_setup));
+        break;
+    case SSD1306_COMMAND_RIGHT_ONE_COLUMN_SCROLL:
+    case SSD1306_COMMAND_LEFT_ONE_COLUMN_SCROLL:
+        _ssd1306_emulator_shift(emu, c[2] & 0x07, c[4] & 0x07,
+                                c[0] == SSD1306_COMMAND_LEFT_ONE_COLUMN_SCROLL);
+        break;
+    case SSD1306_COMMAND_DEACTIVATE_SCROLL:
+        emu->scroll_active = 0;
+        emu->vertical_scroll = 0;
+        break;
+    case SSD1306_COMMAND_ACTIVATE_SCROLL:
+        emu->scroll_active = 1;
+        emu->scroll_frames = 0;
+        break;
+    case SSD1306_COMMAND_MAP_COL0_TO_SEG0:
+    case SSD1306_COMMAND_MAP_COL127_TO_SEG0:
+        emu->seg_remap = c[0] & 0x01;
+        break;
+    case SSD1306_COMMAND_RESUME_TO_RAM_CONTENT:
+    case SSD1306_COMMAND_ENTIRE_DISPLAY_ON:
+        emu->entire_on = c[0] & 0x01;
+        break;
+    case SSD1306_COMMAND_SET_NORMAL_DISPLAY:
+    case SSD1306_COMMAND_SET_INVERSE_DISPLAY:
+        emu->inverse = c[0] & 0x01;
+        break;
+    case SSD1306_COMMAND_SET_DISPLAY_OFF:
+    case SSD1306_COMMAND_SET_DISPLAY_ON:
+        emu->display_on = c[0] & 0x01;
+        break;
+    case SSD1306_COMMAND_SET_NORMAL_SCAN_DIRECTION:
+    case SSD1306_COMMAND_SET_REMAPPED_SCAN_DIRECTION:
+        emu->com_remap = (c[0] & 0x08) >> 3u;
+        break;
+    default:
+        if (c[0] >= 0x40 && c[0] <= 0x7F) {
+            emu->start_line = c[0] & 0x3F;
+        } else if (emu->addressing_mode != PAGE_ADDRESSING_MODE) {
+            /* The remaining commands only apply to page addressing mode. */
+        } else if (c[0] <= 0x0F) {
+            emu->page_column = (emu->page_column & 0xF0) | c[0];
+            emu->column = emu->page_column;
+        } else if (c[0] <= 0x1F) {
+            emu->page_column =
+                (emu->page_column & 0x0F) | ((c[0] & 0x07) << 4u);
+            emu->column = emu->page_column;
+        } else if (c[0] >= 0xB0 && c[0] <= 0xB7) {
+            emu->page = c[0] & 0x07;
+        }
+        break;
+    }
+}
+
+/**
+ * @brief Writes a byte of display data and advances the address pointers.
+ * @param emu Pointer to a ssd1306_emulator struct.
+ * @param value Display data byte.
+ */
+static void _ssd1306_emulator_data(struct ssd1306_emulator *emu, uint8_t value)
+{
+    emu->gddram[emu->page][emu->column] = value;
+
+    switch (emu->addressing_mode) {
+    case HORIZONTAL_ADDRESSING_MODE:
+        if (emu->column++ < emu->end_column)
+            break;
+        emu->column = emu->start_column;
+        emu->page =
+            emu->page < emu->end_page ? emu->page + 1u : emu->start_page;
+        break;
+    case VERTICAL_ADDRESSING_MODE:
+        if (emu->page++ < emu->end_page)
+            break;
+        emu->page = emu->start_page;
+        emu->column = emu->column < emu->end_column ? emu->column + 1u
+                                                    : emu->start_column;
+        break;
+    default:
+        emu->column = emu->column < SSD1306_EMULATOR_WIDTH - 1u
+                          ? emu->column + 1u
+                          : emu->page_column;
+        break;
+    }
+}
+
+/**
+ * @brief Decodes a command byte, executing the command once all of its
+ *        arguments have been received.
+ * @param emu Pointer to a ssd1306_emulator struct.
+ * @param value Command byte.
+ */
+static void _ssd1306_emulator_command(struct ssd1306_emulator *emu,
+                                      uint8_t value)
+{
+    emu->command[emu->command_length++] = value;
+    if (emu->command_length > _ssd1306_emulator_arguments(emu->command[0])) {
+        _ssd1306_emulator_execute(emu);
+        emu->command_length = 0;
+    }
+}
+
+/**
+ * @brief Decodes part of an I2C transfer.
+ * @param emu Pointer to a ssd1306_emulator struct.
+ * @param control Control byte of the bytes being received, or
+ *        SSD1306_EMULATOR_CONTROL if a control byte comes next.
+ * @param src Bytes to decode.
+ * @param length Number of bytes.
+ * @return Control state after the bytes.
+ */
+static uint16_t _ssd1306_emulator_i2c_part(struct ssd1306_emulator *emu,
+                                           uint16_t control,
+                                           const uint8_t *src, uint16_t length)
+{
+    uint16_t i = 0;
+
+    while (i < length) {
+        if (control == SSD1306_EMULATOR_CONTROL) {
+            control = src[i++];
+            continue;
+        }
+
+        enum ssd1306_transfer_type type = (control & 0x40)
+                                              ? SSD1306_DATA_TRANSFER
+                                              : SSD1306_COMMAND_TRANSFER;
+        /* Without the continuation bit, the rest of the transfer is data or
+         * commands. With it, a single byte follows before the next control
+         * byte. */
+        uint16_t n = (control & 0x80) ? 1u : (uint16_t)(length - i);
+
+        ssd1306_emulator_write(emu, type, src + i, n);
+        i += n;
+        if (control & 0x80)
+            control = SSD1306_EMULATOR_CONTROL;
+    }
+    return control;
+}
+
+/**
+ * @brief Blocking I2C write function.
+ */
+static void _ssd1306_emulator_i2c_write(uint8_t address, uint8_t *src,
+                                        uint16_t length)
+{
+    (void)address;
+    ssd1306_emulator_i2c(emulator_driver->context, src, length);
+}
+
+/**
+ * @brief I2C scatter-gather write function. The segments are decoded as a
+ *        single transfer, as the control byte is sent in its own segment.
+ */
+static void _ssd1306_emulator_i2c_writev(uint8_t address,
+                                         const struct ssd1306_iovec *iov,
+                                         uint8_t count)
+{
+    struct ssd1306_emulator *emu = emulator_driver->context;
+    uint16_t control = SSD1306_EMULATOR_CONTROL;
+
+    (void)address;
+    emu->transfers++;
+    for (uint8_t i = 0; i < count; i++) {
+        control = _ssd1306_emulator_i2c_part(emu, control, iov[i].base,
+                                             iov[i].length);
+    }
+}
+
+/**
+ * @brief Non-blocking I2C write function. The transfer is decoded and
+ *        completed immediately.
+ */
+static void _ssd1306_emulator_i2c_writev_async(uint8_t address,
+                                               const struct ssd1306_iovec *iov,
+                                               uint8_t count)
+{
+    _ssd1306_emulator_i2c_writev(address, iov, count);
+    ssd1306_transfer_complete(emulator_driver);
+}
+
+/**
+ * @brief SPI write function.
+ */
+static void _ssd1306_emulator_spi_write(const uint8_t *src, uint16_t length)
+{
+    struct ssd1306_emulator *emu = emulator_driver->context;
+
+    emu->transfers++;
+    ssd1306_emulator_write(emu,
+                           emu->dc ? SSD1306_DATA_TRANSFER
+                                   : SSD1306_COMMAND_TRANSFER,
+                           src, length);
+}
+
+/**
+ * @brief Non-blocking SPI write function. The transfer is decoded and
+ *        completed immediately.
+ */
+static void _ssd1306_emulator_spi_write_async(const uint8_t *src,
+                                              uint16_t length)
+{
+    _ssd1306_emulator_spi_write(src, length);
+    ssd1306_transfer_complete(emulator_driver);
+}
+
+/**
+ * @brief SPI D/C pin function.
+ */
+static void _ssd1306_emulator_spi_set_dc(uint8_t level)
+{
+    struct ssd1306_emulator *emu = emulator_driver->context;
+
+    emu->dc = level;
+}
+
+/**
+ * @brief Transport write function. It writes with the I2C or SPI transport
+ *        the emulator is attached to.
+ */
+static void _ssd1306_emulator_transport_write(struct ssd1306_driver *driver,
+                                              enum ssd1306_transfer_type type,
+                                              const uint8_t *src,
+                                              uint16_t length)
+{
+    struct ssd1306_emulator *emu = driver->context;
+
+    emulator_driver = driver;
+    emu->bus->write(driver, type, src, length);
+}
+
+/**
+ * @brief Transport non-blocking write function. It writes with the I2C or
+ *        SPI transport the emulator is attached to.
+ */
+static void
+_ssd1306_emulator_transport_write_async(struct ssd1306_driver *driver,
+                                        struct ssd1306_transfer *transfer)
+{
+    struct ssd1306_emulator *emu = driver->context;
+
+    emulator_driver = driver;
+    emu->bus->write_async(driver, transfer);
+}
+
+/**
+ * @brief Transport connecting a driver to the emulator in its context.
+ */
+static const struct ssd1306_transport ssd1306_emulator_transport = {
+    .write = _ssd1306_emulator_transport_write,
+    .write_async = _ssd1306_emulator_transport_write_async};
+
+void ssd1306_emulator_reset(struct ssd1306_emulator *emu)
+{
+    const struct ssd1306_transport *bus = emu->bus;
+
+    memset(emu, 0, sizeof(*emu));
+    emu->bus = bus;
+    emu->addressing_mode = PAGE_ADDRESSING_MODE;
+    emu->end_column = SSD1306_EMULATOR_WIDTH - 1u;
+    emu->end_page = SSD1306_MAX_PAGES - 1u;
+    emu->mux_ratio = SSD1306_EMULATOR_HEIGHT - 1u;
+    emu->com_pins = ALTERNATIVE_COM_PIN_CONFIGURATION | 0x02;
+    emu->contrast = 0x7F;
+    emu->charge_pump = DISABLE_CHARGE_PUMP;
+    emu->scroll_rows = SSD1306_EMULATOR_HEIGHT;
+}
+
+void ssd1306_emulator_attach(struct ssd1306_driver *driver,
+                             struct ssd1306_emulator *emu,
+                             const struct ssd1306_transport *bus)
+{
+    driver->context = emu;
+    driver->transport = &ssd1306_emulator_transport;
+    driver->i2c_write = _ssd1306_emulator_i2c_write;
+    driver->i2c_writev = _ssd1306_emulator_i2c_writev;
+    driver->i2c_writev_async = _ssd1306_emulator_i2c_writev_async;
+    driver->spi_write = _ssd1306_emulator_spi_write;
+    driver->spi_write_async = _ssd1306_emulator_spi_write_async;
+    driver->spi_set_dc = _ssd1306_emulator_spi_set_dc;
+    emu->bus = bus;
+    ssd1306_emulator_reset(emu);
+}
+
+void ssd1306_emulator_i2c(struct ssd1306_emulator *emu, const uint8_t *src,
+                          uint16_t length)
+{
+    emu->transfers++;
+    _ssd1306_emulator_i2c_part(emu, SSD1306_EMULATOR_CONTROL, src, length);
+}
+
+void ssd1306_emulator_write(struct ssd1306_emulator *emu,
+                            enum ssd1306_transfer_type type,
+                            const uint8_t *src, uint16_t length)
+{
+    if (type == SSD1306_DATA_TRANSFER) {
+        emu->data_bytes += length;
+        for (uint16_t i = 0; i < length; i++) {
+            _ssd1306_emulator_data(emu, src[i]);
+        }
+    } else {
+        emu->command_bytes += length;
+        for (uint16_t i = 0; i < length; i++) {
+            _ssd1306_emulator_command(emu, src[i]);
+        }
+    }
+}
+
+void ssd1306_emulator_tick(struct ssd1306_emulator *emu, uint16_t frames)
+{
+    const uint8_t *setup = emu->scroll_setup;
+    uint16_t rate = ssd1306_emulator_rates[setup[3] & 0x07];
+    uint8_t left = setup[0] == SSD1306_COMMAND_LEFT_SCROLL_SETUP ||
+                   setup[0] == SSD1306_COMMAND_VERTICAL_AND_LEFT_SCROLL_SETUP;
+    uint8_t vertical =
+        setup[0] == SSD1306_COMMAND_VERTICAL_AND_RIGHT_SCROLL_SETUP ||
+        setup[0] == SSD1306_COMMAND_VERTICAL_AND_LEFT_SCROLL_SETUP;
+
+    if (!emu->scroll_active || !setup[0])
+        return;
+
+    emu->scroll_frames += frames;
+    while (emu->scroll_frames >= rate) {
+        emu->scroll_frames -= rate;
+        _ssd1306_emulator_shift(emu, setup[2] & 0x07, setup[4] & 0x07, left);
+        if (vertical && emu->scroll_rows)
+            emu->vertical_scroll =
+                (emu->vertical_scroll + (setup[5] & 0x3F)) % emu->scroll_rows;
+    }
+}
+
+uint8_t ssd1306_emulator_pixel(const struct ssd1306_emulator *emu, uint8_t x,
+                               uint8_t y)
+{
+    if (!emu->display_on || y > emu->mux_ratio)
+        return 0;
+    if (emu->entire_on)
+        return 1;
+
+    uint8_t com = emu->com_remap ? emu->mux_ratio - y : y;
+    uint8_t row = (com + emu->start_line + emu->display_offset) & 0x3F;
+    uint8_t column = emu->seg_remap ? SSD1306_EMULATOR_WIDTH - 1u - x : x;
+
+    if (emu->scroll_active && row >= emu->fixed_rows &&
+        row < emu->fixed_rows + emu->scroll_rows)
+        row = emu->fixed_rows +
+              (row - emu->fixed_rows + emu->vertical_scroll) % emu->scroll_rows;
+
+    return ((emu->gddram[(row & 0x3F) >> 3u][column] >> (row & 0x07)) & 1u) ^
+           emu->inverse;
+}
+
+uint8_t ssd1306_emulator_write_pbm(const struct ssd1306_emulator *emu,
+                                   FILE *file)
+{
+    fprintf(file, "P4\n%u %u\n", SSD1306_EMULATOR_WIDTH,
+            SSD1306_EMULATOR_HEIGHT);
+
+    for (uint8_t y = 0; y < SSD1306_EMULATOR_HEIGHT; y++) {
+        for (uint8_t x = 0; x < SSD1306_EMULATOR_WIDTH; x += 8u) {
+            uint8_t bits = 0;
+
+            /* PBM uses 1 for black, lit pixels are written as white. */
+            for (uint8_t k = 0; k < 8u; k++) {
+                bits |= !ssd1306_emulator_pixel(emu, x + k, y) << (7u - k);
+            }
+            fputc(bits, file);
+        }
+    }
+    return ferror(file) ? 1 : 0;
+}
+
+uint8_t ssd1306_emulator_write_pgm(const struct ssd1306_emulator *emu,
+                                   FILE *file)
+{
+    uint8_t lit = 64u + emu->contrast * 191u / 255u;
+
+    fprintf(file, "P5\n%u %u\n255\n", SSD1306_EMULATOR_WIDTH,
+            SSD1306_EMULATOR_HEIGHT);
+
+    for (uint8_t y = 0; y < SSD1306_EMULATOR_HEIGHT; y++) {
+        for (uint8_t x = 0; x < SSD1306_EMULATOR_WIDTH; x++) {
+            fputc(ssd1306_emulator_pixel(emu, x, y) ? lit : 0, file);
+        }
+    }
+    return ferror(file) ? 1 : 0;
+}
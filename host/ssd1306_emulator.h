@@ -0,0 +1,145 @@
+/**
+ * @file ssd1306_emulator.h
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief Host-side model of the SSD1306 controller. It decodes the I2C or
+ *        SPI byte stream written by the driver into a GDDRAM image and
+ *        renders the panel as seen by the user, so the library can be tested
+ *        and measured on a desktop machine.
+ */
+
+#ifndef __SSD1306_EMULATOR_H
+#define __SSD1306_EMULATOR_H
+
+#include "ssd1306/ssd1306.h"
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * @brief Emulated panel width in pixels.
+ */
+#define SSD1306_EMULATOR_WIDTH 128u
+
+/**
+ * @brief Emulated panel height in pixels.
+ */
+#define SSD1306_EMULATOR_HEIGHT 64u
+
+/**
+ * @brief Struct holding the state of the emulated controller.
+ */
+struct ssd1306_emulator {
+    uint8_t gddram[SSD1306_MAX_PAGES][SSD1306_EMULATOR_WIDTH]; /**< GDDRAM. */
+    uint8_t addressing_mode;   /**< Memory addressing mode (20h). */
+    uint8_t column;            /**< Column address pointer. */
+    uint8_t page;              /**< Page address pointer. */
+    uint8_t start_column;      /**< Column window start (21h). */
+    uint8_t end_column;        /**< Column window end (21h). */
+    uint8_t start_page;        /**< Page window start (22h). */
+    uint8_t end_page;          /**< Page window end (22h). */
+    uint8_t page_column;       /**< Page mode column start (00h-1Fh). */
+    uint8_t start_line;        /**< Display start line (40h-7Fh). */
+    uint8_t display_offset;    /**< Display offset (D3h). */
+    uint8_t mux_ratio;         /**< Multiplex ratio (A8h). */
+    uint8_t seg_remap;         /**< 1 if column 127 is mapped to SEG0. */
+    uint8_t com_remap;         /**< 1 if the COM scan direction is remapped. */
+    uint8_t com_pins;          /**< COM pins configuration (DAh). */
+    uint8_t contrast;          /**< Contrast (81h). */
+    uint8_t inverse;           /**< 1 in inverse display mode. */
+    uint8_t entire_on;         /**< 1 if the entire display is on (A5h). */
+    uint8_t display_on;        /**< 1 if the display is on. */
+    uint8_t charge_pump;       /**< Charge pump setting (8Dh). */
+    uint8_t scroll_setup[7];   /**< Last scroll setup command and arguments. */
+    uint8_t scroll_active;     /**< 1 while scrolling is active. */
+    uint16_t scroll_frames;    /**< Frames elapsed since the last step. */
+    uint8_t vertical_scroll;   /**< Rows scrolled in the vertical area. */
+    uint8_t fixed_rows;        /**< Rows of the top fixed area (A3h). */
+    uint8_t scroll_rows;       /**< Rows of the vertical scroll area (A3h). */
+    uint8_t command[8];        /**< Command being received. */
+    uint8_t command_length;    /**< Bytes of the command received. */
+    uint8_t dc;                /**< Level of the SPI D/C pin. */
+    const struct ssd1306_transport *bus; /**< Transport of the driver, I2C
+                                              or SPI. */
+    uint32_t transfers;        /**< Number of transfers received. */
+    uint32_t command_bytes;    /**< Command bytes received. */
+    uint32_t data_bytes;       /**< Display data bytes received. */
+};
+
+/**
+ * @brief Sets the emulator to the SSD1306 reset state. The bus it is
+ *        attached to is kept.
+ * @param emu Pointer to a ssd1306_emulator struct.
+ */
+void ssd1306_emulator_reset(struct ssd1306_emulator *emu);
+
+/**
+ * @brief Resets the emulator and connects it to a driver through the I2C or
+ *        SPI transport, whose bus functions are set to decode the bytes
+ *        written. The emulator is stored in the driver context, so each
+ *        driver can have its own. Asynchronous transfers are completed
+ *        immediately.
+ * @param driver Pointer to a ssd1306 struct.
+ * @param emu Pointer to a ssd1306_emulator struct.
+ * @param bus ssd1306_i2c_transport or ssd1306_spi_transport.
+ */
+void ssd1306_emulator_attach(struct ssd1306_driver *driver,
+                             struct ssd1306_emulator *emu,
+                             const struct ssd1306_transport *bus);
+
+/**
+ * @brief Decodes an I2C transfer, starting with a control byte.
+ * @param emu Pointer to a ssd1306_emulator struct.
+ * @param src Transfer bytes, without the address.
+ * @param length Number of bytes.
+ */
+void ssd1306_emulator_i2c(struct ssd1306_emulator *emu, const uint8_t *src,
+                          uint16_t length);
+
+/**
+ * @brief Decodes a stream of commands or display data.
+ * @param emu Pointer to a ssd1306_emulator struct.
+ * @param type Command or data transfer.
+ * @param src Bytes to decode.
+ * @param length Number of bytes.
+ */
+void ssd1306_emulator_write(struct ssd1306_emulator *emu,
+                            enum ssd1306_transfer_type type,
+                            const uint8_t *src, uint16_t length);
+
+/**
+ * @brief Advances the continuous scroll by a number of frames.
+ * @param emu Pointer to a ssd1306_emulator struct.
+ * @param frames Number of frames.
+ */
+void ssd1306_emulator_tick(struct ssd1306_emulator *emu, uint16_t frames);
+
+/**
+ * @brief Returns the state of a pixel of the panel, after applying the start
+ *        line, offset, remaps, multiplex ratio and display modes.
+ * @param emu Pointer to a ssd1306_emulator struct.
+ * @param x Panel column.
+ * @param y Panel row.
+ * @return 1 if the pixel is lit, 0 otherwise.
+ */
+uint8_t ssd1306_emulator_pixel(const struct ssd1306_emulator *emu, uint8_t x,
+                               uint8_t y);
+
+/**
+ * @brief Writes the panel as a binary PBM image.
+ * @param emu Pointer to a ssd1306_emulator struct.
+ * @param file Output file.
+ * @return 1 if the file can't be written, 0 otherwise.
+ */
+uint8_t ssd1306_emulator_write_pbm(const struct ssd1306_emulator *emu,
+                                   FILE *file);
+
+/**
+ * @brief Writes the panel as a binary PGM image. Lit pixels are brighter
+ *        with a higher contrast.
+ * @param emu Pointer to a ssd1306_emulator struct.
+ * @param file Output file.
+ * @return 1 if the file can't be written, 0 otherwise.
+ */
+uint8_t ssd1306_emulator_write_pgm(const struct ssd1306_emulator *emu,
+                                   FILE *file);
+
+#endif /* !__SSD1306_EMULATOR_H */
@@ -0,0 +1,94 @@
+/**
+ * @file ssd1306_font_rle.c
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief Host-side encoder of SSD1306_RLE_FONT glyph data, used to compress
+ *        raw fonts and measure the flash they save.
+ */
+
+#include "ssd1306_font_rle.h"
+#include <string.h>
+
+/**
+ * @brief Longest literal run.
+ */
+#define SSD1306_RLE_MAX_LITERAL 128u
+
+/**
+ * @brief Longest repeated run.
+ */
+#define SSD1306_RLE_MAX_REPEAT 129u
+
+/**
+ * @brief Encodes one glyph.
+ * @param src Raw glyph bytes.
+ * @param length Number of raw bytes.
+ * @param dst Array receiving the encoded glyph.
+ * @param size Size of the dst array.
+ * @return Length of the encoded glyph, or 0 if it doesn't fit in dst.
+ */
+static uint16_t _ssd1306_rle_glyph(const uint8_t *src, uint16_t length,
+                                   uint8_t *dst, uint16_t size)
+{
+    uint16_t n = 0;
+    uint16_t literal = 0;
+    uint16_t i = 0;
+
+    while (i < length) {
+        uint16_t run = 1;
+
+        while (i + run < length && run < SSD1306_RLE_MAX_REPEAT &&
+               src[i + run] == src[i]) {
+            run++;
+        }
+
+        /* A pair only pays off when it doesn't split a literal run. */
+        if (run >= 3u || (run == 2u && !literal)) {
+            if (n + 2u > size)
+                return 0;
+            dst[n++] = 0x7Eu + run;
+            dst[n++] = src[i];
+            literal = 0;
+            i += run;
+            continue;
+        }
+
+        /* literal is the index after the control byte of the open literal
+         * run, or 0. The control byte counts the bytes minus one. */
+        if (!literal || dst[literal - 1u] == SSD1306_RLE_MAX_LITERAL - 1u) {
+            if (n + 1u > size)
+                return 0;
+            dst[n++] = 0xFF;
+            literal = n;
+        }
+        if (n + 1u > size)
+            return 0;
+        dst[literal - 1u]++;
+        dst[n++] = src[i++];
+    }
+
+    return n;
+}
+
+uint16_t ssd1306_font_rle_encode(const struct ssd1306_font *font,
+                                 uint8_t *data, uint16_t size,
+                                 uint16_t *offsets)
+{
+    uint16_t length = 0;
+
+    for (uint16_t x = 0; x < ssd1306_font_glyphs(font); x++) {
+        uint16_t raw = ssd1306_glyph_width(font, x) * font->page_alignment;
+        uint16_t n = _ssd1306_rle_glyph(
+            font->data + ssd1306_glyph_offset(font, x), raw, data + length,
+            size - length);
+
+        if (raw && !n)
+            return 0;
+        if (font->type == SSD1306_VARIABLE_WIDTH_FONT)
+            offsets[x] = length;
+        else if (x % SSD1306_RLE_GROUP == 0)
+            offsets[x / SSD1306_RLE_GROUP] = length;
+        length += n;
+    }
+
+    return length;
+}
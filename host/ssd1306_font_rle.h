@@ -0,0 +1,30 @@
+/**
+ * @file ssd1306_font_rle.h
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief Host-side encoder of SSD1306_RLE_FONT glyph data, used to compress
+ *        raw fonts and measure the flash they save.
+ */
+
+#ifndef __SSD1306_FONT_RLE_H
+#define __SSD1306_FONT_RLE_H
+
+#include "ssd1306/font/ssd1306_font.h"
+#include <stdint.h>
+
+/**
+ * @brief Encodes the glyphs of a raw font with run-length encoding. The
+ *        encoded font uses the same fields as the raw font, except for data,
+ *        data_length, char_offset and encoding.
+ * @param font Pointer to a raw ssd1306_font struct.
+ * @param data Array receiving the encoded glyphs.
+ * @param size Size of the data array.
+ * @param offsets Array receiving the char_offset entries of the encoded
+ *        font: the offset of each glyph for variable width fonts, or of
+ *        every SSD1306_RLE_GROUP-th glyph for fixed width fonts.
+ * @return Length of the encoded glyphs, or 0 if they don't fit in data.
+ */
+uint16_t ssd1306_font_rle_encode(const struct ssd1306_font *font,
+                                 uint8_t *data, uint16_t size,
+                                 uint16_t *offsets);
+
+#endif /* !__SSD1306_FONT_RLE_H */
@@ -0,0 +1,167 @@
+/**
+ * @file ssd1306_mock.c
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief Host-side mock transport that records every byte written to the
+ *        SSD1306.
+ */
+
+#include "ssd1306_mock.h"
+#include <string.h>
+
+struct ssd1306_mock ssd1306_mock;
+
+/**
+ * @brief Driver the mock transport is attached to.
+ */
+static struct ssd1306_driver *mock_driver;
+
+/**
+ * @brief Appends a transfer to the record. Bytes that do not fit are dropped.
+ * @param address I2C address.
+ * @param iov Transfer segments.
+ * @param count Number of segments.
+ */
+static void _ssd1306_mock_record(uint8_t address,
+                                 const struct ssd1306_iovec *iov,
+                                 uint8_t count)
+{
+    struct ssd1306_mock *m = &ssd1306_mock;
+
+    if (m->transfers >= SSD1306_MOCK_MAX_TRANSFERS)
+        return;
+
+    m->offset[m->transfers] = m->length;
+    m->address[m->transfers] = address;
+    m->dc[m->transfers] = m->dc_level;
+    m->transfers++;
+
+    for (uint8_t i = 0; i < count; i++) {
+        uint32_t len = iov[i].length;
+        if (len > SSD1306_MOCK_LOG_SIZE - m->length)
+            len = SSD1306_MOCK_LOG_SIZE - m->length;
+        memcpy(m->data + m->length, iov[i].base, len);
+        m->length += len;
+    }
+}
+
+/**
+ * @brief Non-blocking write: puts the segments on the wire until
+ *        ssd1306_mock_complete is called.
+ * @param address I2C address.
+ * @param iov Transfer segments.
+ * @param count Number of segments (up to 2).
+ */
+static void _ssd1306_mock_start(uint8_t address,
+                                const struct ssd1306_iovec *iov, uint8_t count)
+{
+    for (uint8_t i = 0; i < count; i++) {
+        ssd1306_mock.pending[i] = iov[i];
+    }
+    ssd1306_mock.pending_addr = address;
+    ssd1306_mock.pending_count = count;
+}
+
+/**
+ * @brief Blocking I2C write function with a contiguous buffer.
+ */
+static void _ssd1306_mock_write(uint8_t address, uint8_t *src, uint16_t len)
+{
+    struct ssd1306_iovec iov = {src, len};
+    _ssd1306_mock_record(address, &iov, 1u);
+}
+
+/**
+ * @brief Blocking I2C scatter-gather write function.
+ */
+static void _ssd1306_mock_writev(uint8_t address,
+                                 const struct ssd1306_iovec *iov,
+                                 uint8_t count)
+{
+    _ssd1306_mock_record(address, iov, count);
+}
+
+/**
+ * @brief Blocking SPI write function.
+ */
+static void _ssd1306_mock_spi_write(const uint8_t *src, uint16_t len)
+{
+    struct ssd1306_iovec iov = {src, len};
+    _ssd1306_mock_record(0, &iov, 1u);
+}
+
+/**
+ * @brief Non-blocking SPI write function.
+ */
+static void _ssd1306_mock_spi_write_async(const uint8_t *src, uint16_t len)
+{
+    struct ssd1306_iovec iov = {src, len};
+    _ssd1306_mock_start(0, &iov, 1u);
+}
+
+/**
+ * @brief SPI D/C pin function.
+ */
+static void _ssd1306_mock_spi_set_dc(uint8_t level)
+{
+    ssd1306_mock.dc_level = level;
+}
+
+/**
+ * @brief Yield function: lets the bus progress by one transfer.
+ */
+static void _ssd1306_mock_yield(void)
+{
+    if (ssd1306_mock.auto_complete)
+        ssd1306_mock_complete();
+}
+
+void ssd1306_mock_attach(struct ssd1306_driver *driver,
+                         const struct ssd1306_transport *transport,
+                         struct ssd1306_async *async)
+{
+    mock_driver = driver;
+    driver->transport = transport;
+    driver->i2c_write = _ssd1306_mock_write;
+    driver->i2c_writev = _ssd1306_mock_writev;
+    driver->i2c_writev_async = _ssd1306_mock_start;
+    driver->spi_write = _ssd1306_mock_spi_write;
+    driver->spi_write_async = _ssd1306_mock_spi_write_async;
+    driver->spi_set_dc = _ssd1306_mock_spi_set_dc;
+    driver->yield = _ssd1306_mock_yield;
+    driver->async = async;
+    if (async)
+        memset(async, 0, sizeof(*async));
+    ssd1306_mock.pending_count = 0;
+    ssd1306_mock.dc_level = 0;
+    ssd1306_mock.auto_complete = 1;
+    ssd1306_mock_reset();
+}
+
+void ssd1306_mock_reset(void)
+{
+    ssd1306_mock.length = 0;
+    ssd1306_mock.transfers = 0;
+}
+
+uint8_t ssd1306_mock_complete(void)
+{
+    uint8_t count = ssd1306_mock.pending_count;
+
+    if (!count)
+        return 0;
+
+    ssd1306_mock.pending_count = 0;
+    _ssd1306_mock_record(ssd1306_mock.pending_addr, ssd1306_mock.pending,
+                         count);
+    ssd1306_transfer_complete(mock_driver);
+    return 1;
+}
+
+const uint8_t *ssd1306_mock_transfer(uint16_t n, uint16_t *length)
+{
+    uint32_t end = (n + 1u < ssd1306_mock.transfers)
+                       ? ssd1306_mock.offset[n + 1u]
+                       : ssd1306_mock.length;
+    *length = end - ssd1306_mock.offset[n];
+    return ssd1306_mock.data + ssd1306_mock.offset[n];
+}
@@ -0,0 +1,85 @@
+/**
+ * @file ssd1306_mock.h
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief Host-side mock transport that records every byte written to the
+ *        SSD1306. It can complete asynchronous transfers on demand, so the
+ *        library can be exercised on a desktop machine.
+ */
+
+#ifndef __SSD1306_MOCK_H
+#define __SSD1306_MOCK_H
+
+#include "ssd1306/ssd1306.h"
+#include <stdint.h>
+
+/**
+ * @brief Maximum number of recorded bytes.
+ */
+#define SSD1306_MOCK_LOG_SIZE 65536u
+
+/**
+ * @brief Maximum number of recorded transfers.
+ */
+#define SSD1306_MOCK_MAX_TRANSFERS 4096u
+
+/**
+ * @brief Struct holding the recorded byte stream.
+ */
+struct ssd1306_mock {
+    uint8_t data[SSD1306_MOCK_LOG_SIZE]; /**< Recorded bytes. */
+    uint32_t length;                     /**< Number of recorded bytes. */
+    uint32_t offset[SSD1306_MOCK_MAX_TRANSFERS]; /**< Start of each transfer
+                                                      in data. */
+    uint8_t address[SSD1306_MOCK_MAX_TRANSFERS]; /**< I2C address of each
+                                                      transfer. */
+    uint8_t dc[SSD1306_MOCK_MAX_TRANSFERS]; /**< SPI D/C level of each
+                                                 transfer. */
+    uint8_t dc_level;       /**< Current SPI D/C level. */
+    uint16_t transfers;     /**< Number of recorded transfers. */
+    struct ssd1306_iovec pending[2]; /**< Segments of the asynchronous
+                                          transfer on the wire. */
+    uint8_t pending_count;  /**< Number of segments on the wire (0 if the
+                                 bus is idle). */
+    uint8_t pending_addr;   /**< I2C address of the transfer on the wire. */
+    uint8_t auto_complete;  /**< If not 0, the yield function completes the
+                                 transfer on the wire. */
+};
+
+/**
+ * @brief Recorded byte stream.
+ */
+extern struct ssd1306_mock ssd1306_mock;
+
+/**
+ * @brief Attaches the mock I2C and SPI functions to a driver and clears the
+ *        record.
+ * @param driver Pointer to a ssd1306 struct.
+ * @param transport Transport to use (ssd1306_i2c_transport or
+ *        ssd1306_spi_transport).
+ * @param async Pointer to a ssd1306_async struct to use the asynchronous
+ *        mode, or NULL to use the blocking mode.
+ */
+void ssd1306_mock_attach(struct ssd1306_driver *driver,
+                         const struct ssd1306_transport *transport,
+                         struct ssd1306_async *async);
+
+/**
+ * @brief Clears the recorded byte stream.
+ */
+void ssd1306_mock_reset(void);
+
+/**
+ * @brief Completes the asynchronous transfer on the wire, recording its
+ *        bytes as they are at this moment.
+ * @return 1 if a transfer was completed, 0 if the bus was idle.
+ */
+uint8_t ssd1306_mock_complete(void);
+
+/**
+ * @brief Returns a pointer to the bytes of a recorded transfer.
+ * @param n Transfer number.
+ * @param length Pointer where the transfer length is stored.
+ */
+const uint8_t *ssd1306_mock_transfer(uint16_t n, uint16_t *length);
+
+#endif /* !__SSD1306_MOCK_H */
@@ -8,7 +8,16 @@
 #ifndef __SSD1306_FONT_H
 #define __SSD1306_FONT_H
 
+#include <stddef.h>
 #include <stdint.h>
+#include <string.h>
+
+/**
+ * @brief Glyphs per char_offset entry of a fixed width RLE font. The glyphs
+ *        before the wanted one in its group are skipped while decoding, so
+ *        the offsets take 2 bytes per 8 glyphs instead of per glyph.
+ */
+#define SSD1306_RLE_GROUP 8u
 
 /**
  * @brief SSD1306 font type.
@@ -18,12 +27,30 @@ enum ssd1306_font_type {
     SSD1306_VARIABLE_WIDTH_FONT /**< Characters have different widths. */
 };
 
+/**
+ * @brief Encoding of the glyph data.
+ */
+enum ssd1306_font_encoding {
+    SSD1306_RAW_FONT, /**< Glyphs are stored as page-format arrays. */
+    SSD1306_RLE_FONT  /**< Glyphs are run-length encoded, see
+                           ssd1306_glyph_read. */
+};
+
+/**
+ * @brief Range of consecutive codepoints drawn with consecutive glyphs.
+ */
+struct ssd1306_glyph_range {
+    uint32_t first; /**< First codepoint. */
+    uint16_t count; /**< Number of codepoints. */
+    uint16_t glyph; /**< Glyph index of the first codepoint. */
+};
+
 /**
  * @brief Struct for managing a bitmap-based font.
  */
 struct ssd1306_font {
     enum ssd1306_font_type type; /**< Fixed width or variable width font. */
-    char first_char;             /**< First ASCII character. */
+    char first_char;             /**< First ASCII character, glyph 0. */
     char last_char;              /**< Last ASCII character. */
     uint8_t space_width;         /**< Space width and fixed character width. */
     uint8_t horizontal_separation; /**< Separation between characters. */
@@ -32,6 +59,243 @@ struct ssd1306_font {
     const uint16_t data_length;    /**< Font bitmap data length. */
     const uint8_t *char_width;     /**< Array containing character widths. */
     const uint16_t *char_offset;   /** Array containing character offset. < */
+    enum ssd1306_font_encoding encoding; /**< Glyph data encoding. RLE fonts
+                                              need char_offset, also with a
+                                              fixed width, with one entry per
+                                              SSD1306_RLE_GROUP glyphs. */
+    const struct ssd1306_glyph_range *ranges; /**< Codepoints outside
+                                                   first_char..last_char,
+                                                   sorted and without
+                                                   overlaps (optional). */
+    uint8_t range_count; /**< Number of ranges. */
+};
+
+/**
+ * @brief Struct for reading the bytes of a glyph in page order.
+ */
+struct ssd1306_glyph_reader {
+    const uint8_t *src; /**< Next byte of the glyph data. */
+    uint8_t rle;        /**< 1 if the glyph data is run-length encoded. */
+    uint8_t run;        /**< Bytes left in the current run. */
+    uint8_t repeat;     /**< 1 if the current run repeats a single byte. */
 };
 
+/**
+ * @brief Returns the number of glyphs of the first_char..last_char range.
+ * @param font Pointer to a ssd1306_font struct.
+ */
+static inline uint8_t ssd1306_font_ascii_glyphs(const struct ssd1306_font *font)
+{
+    uint8_t first = font->first_char;
+    uint8_t last = font->last_char;
+
+    return last >= first ? last - first + 1u : 0;
+}
+
+/**
+ * @brief Returns the number of glyphs of a font.
+ * @param font Pointer to a ssd1306_font struct.
+ */
+static inline uint16_t ssd1306_font_glyphs(const struct ssd1306_font *font)
+{
+    uint16_t count = ssd1306_font_ascii_glyphs(font);
+
+    for (uint8_t i = 0; i < font->range_count; i++) {
+        const struct ssd1306_glyph_range *range = &font->ranges[i];
+
+        if (range->glyph + range->count > count)
+            count = range->glyph + range->count;
+    }
+    return count;
+}
+
+/**
+ * @brief Looks up a codepoint in the sorted ranges of a font.
+ * @param font Pointer to a ssd1306_font struct.
+ * @param c Codepoint.
+ * @return Glyph index, or -1 if the font has no glyph for the codepoint.
+ */
+static inline int32_t _ssd1306_font_range_glyph(const struct ssd1306_font *font,
+                                                uint32_t c)
+{
+    uint8_t low = 0;
+    uint8_t high = font->range_count;
+
+    while (low < high) {
+        uint8_t mid = (low + high) >> 1u;
+        const struct ssd1306_glyph_range *range = &font->ranges[mid];
+
+        if (c < range->first)
+            high = mid;
+        else if (c - range->first >= range->count)
+            low = mid + 1u;
+        else
+            return range->glyph + (c - range->first);
+    }
+    return -1;
+}
+
+/**
+ * @brief Returns the glyph index of a codepoint. Codepoints of the
+ *        first_char..last_char range take a subtraction and a comparison,
+ *        the ranges are searched in O(log range_count).
+ * @param font Pointer to a ssd1306_font struct.
+ * @param c Codepoint.
+ * @return Glyph index, or -1 if the font has no glyph for the codepoint.
+ */
+static inline int32_t ssd1306_font_glyph(const struct ssd1306_font *font,
+                                         uint32_t c)
+{
+    uint32_t x = c - (uint8_t)font->first_char;
+
+    if (x < ssd1306_font_ascii_glyphs(font))
+        return x;
+    if (!font->range_count)
+        return -1;
+    return _ssd1306_font_range_glyph(font, c);
+}
+
+/**
+ * @brief Returns the number of char_offset entries of a font.
+ * @param font Pointer to a ssd1306_font struct.
+ */
+static inline uint16_t ssd1306_font_offsets(const struct ssd1306_font *font)
+{
+    if (font->type == SSD1306_VARIABLE_WIDTH_FONT)
+        return ssd1306_font_glyphs(font);
+    if (font->encoding == SSD1306_RLE_FONT)
+        return (ssd1306_font_glyphs(font) + SSD1306_RLE_GROUP - 1u) /
+               SSD1306_RLE_GROUP;
+    return 0;
+}
+
+/**
+ * @brief Returns the width of a glyph.
+ * @param font Pointer to a ssd1306_font struct.
+ * @param x Glyph index, see ssd1306_font_glyph.
+ */
+static inline uint8_t ssd1306_glyph_width(const struct ssd1306_font *font,
+                                          uint16_t x)
+{
+    return font->type == SSD1306_VARIABLE_WIDTH_FONT ? font->char_width[x]
+                                                     : font->space_width;
+}
+
+/**
+ * @brief Returns the offset of a glyph in the font data. For fixed width RLE
+ *        fonts, it is the offset of the first glyph of its group.
+ * @param font Pointer to a ssd1306_font struct.
+ * @param x Glyph index, see ssd1306_font_glyph.
+ */
+static inline uint16_t ssd1306_glyph_offset(const struct ssd1306_font *font,
+                                            uint16_t x)
+{
+    if (font->type == SSD1306_VARIABLE_WIDTH_FONT)
+        return font->char_offset[x];
+    if (font->encoding == SSD1306_RLE_FONT)
+        return font->char_offset[x / SSD1306_RLE_GROUP];
+    return x * font->space_width * font->page_alignment;
+}
+
+/**
+ * @brief Starts the next run of a RLE glyph if the current one has ended.
+ * @param r Pointer to a ssd1306_glyph_reader struct.
+ */
+static inline void _ssd1306_glyph_run(struct ssd1306_glyph_reader *r)
+{
+    if (!r->run) {
+        uint8_t control = *r->src++;
+
+        r->repeat = control >> 7u;
+        r->run = r->repeat ? control - 0x7Eu : control + 1u;
+    }
+}
+
+/**
+ * @brief Returns the next byte of a glyph. Every RLE glyph is encoded on its
+ *        own, in the same page order as a raw glyph. A control byte n below
+ *        0x80 is followed by n + 1 literal bytes, and a control byte n from
+ *        0x80 is followed by a single byte repeated n - 0x7E times.
+ * @param r Pointer to a ssd1306_glyph_reader struct.
+ */
+static inline uint8_t ssd1306_glyph_read(struct ssd1306_glyph_reader *r)
+{
+    if (!r->rle)
+        return *r->src++;
+
+    _ssd1306_glyph_run(r);
+    r->run--;
+    if (r->repeat && r->run)
+        return *r->src;
+    return *r->src++;
+}
+
+/**
+ * @brief Reads bytes of a glyph a run at a time.
+ * @param r Pointer to a ssd1306_glyph_reader struct.
+ * @param dst Array receiving the bytes, or NULL to skip them.
+ * @param n Number of bytes.
+ */
+static inline void ssd1306_glyph_read_n(struct ssd1306_glyph_reader *r,
+                                        uint8_t *dst, uint16_t n)
+{
+    if (!r->rle) {
+        if (dst)
+            memcpy(dst, r->src, n);
+        r->src += n;
+        return;
+    }
+
+    while (n) {
+        _ssd1306_glyph_run(r);
+
+        uint8_t k = r->run < n ? r->run : n;
+
+        if (r->repeat) {
+            if (dst)
+                memset(dst, *r->src, k);
+        } else {
+            if (dst)
+                memcpy(dst, r->src, k);
+            r->src += k;
+        }
+        r->run -= k;
+        if (r->repeat && !r->run)
+            r->src++;
+        if (dst)
+            dst += k;
+        n -= k;
+    }
+}
+
+/**
+ * @brief Skips bytes of a glyph.
+ * @param r Pointer to a ssd1306_glyph_reader struct.
+ * @param n Number of bytes to skip.
+ */
+static inline void ssd1306_glyph_skip(struct ssd1306_glyph_reader *r,
+                                      uint16_t n)
+{
+    ssd1306_glyph_read_n(r, NULL, n);
+}
+
+/**
+ * @brief Starts reading a glyph. With fixed width RLE fonts, the glyphs
+ *        before it in its group are skipped, a run at a time.
+ * @param r Pointer to a ssd1306_glyph_reader struct.
+ * @param font Pointer to a ssd1306_font struct.
+ * @param x Glyph index, see ssd1306_font_glyph.
+ */
+static inline void ssd1306_glyph_begin(struct ssd1306_glyph_reader *r,
+                                       const struct ssd1306_font *font,
+                                       uint16_t x)
+{
+    r->src = font->data + ssd1306_glyph_offset(font, x);
+    r->rle = font->encoding == SSD1306_RLE_FONT;
+    r->run = 0;
+    if (r->rle && font->type == SSD1306_FIXED_WIDTH_FONT)
+        ssd1306_glyph_skip(r, (x % SSD1306_RLE_GROUP) * font->space_width *
+                                  font->page_alignment);
+}
+
 #endif /* !__SSD1306_FONT_H */
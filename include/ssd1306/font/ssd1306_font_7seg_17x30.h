@@ -2,86 +2,14 @@
  * @file ssd1306_font_7seg_17x30.h
  * @author Iván Santiago (https://github.com/ivansntg)
  * @brief 17x30 seven-segment font to use with the ssd1306-lib text rendering
- *        functions.
+ *        functions. Generated by ssd1306_fontc.py from 7-segment_17x30.png.
  */
 
 #ifndef __SSD1306_FONT_7SEG_17X30_H
 #define __SSD1306_FONT_7SEG_17X30_H
 
-#include "ssd1306_font.h"
+#include "ssd1306/font/ssd1306_font.h"
 
-const uint8_t font_seven_segment_17x30[748] = {
-    0xf0, 0xf8, 0xf8, 0xf6, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f,
-    0x0f, 0xf6, 0xf8, 0xf8, 0xf0, 0x1f, 0x3f, 0x3f, 0x1f, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1f, 0x3f, 0x3f, 0x1f, 0xfe, 0xff,
-    0xff, 0xfe, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xfe,
-    0xff, 0xff, 0xfe, 0x03, 0x07, 0x07, 0x1b, 0x3c, 0x3c, 0x3c, 0x3c, 0x3c,
-    0x3c, 0x3c, 0x3c, 0x3c, 0x1b, 0x07, 0x07, 0x03, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf0, 0xf8, 0xf8,
-    0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x1f, 0x3f, 0x3f, 0x1f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xfe, 0xff, 0xff, 0xfe, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x03, 0x07, 0x07, 0x03, 0x00, 0x00, 0x00, 0x06, 0x0f, 0x0f, 0x0f, 0x0f,
-    0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0xf6, 0xf8, 0xf8, 0xf0, 0x00, 0x00, 0x00,
-    0xc0, 0xe0, 0xe0, 0xe0, 0xe0, 0xe0, 0xe0, 0xe0, 0xe0, 0xe0, 0xdf, 0x3f,
-    0x3f, 0x1f, 0xfe, 0xff, 0xff, 0xfe, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
-    0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x03, 0x07, 0x07, 0x1b, 0x3c,
-    0x3c, 0x3c, 0x3c, 0x3c, 0x3c, 0x3c, 0x3c, 0x3c, 0x18, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x06, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f,
-    0x0f, 0xf6, 0xf8, 0xf8, 0xf0, 0x00, 0x00, 0x00, 0xc0, 0xe0, 0xe0, 0xe0,
-    0xe0, 0xe0, 0xe0, 0xe0, 0xe0, 0xe0, 0xdf, 0x3f, 0x3f, 0x1f, 0x00, 0x00,
-    0x00, 0x00, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0xfe,
-    0xff, 0xff, 0xfe, 0x00, 0x00, 0x00, 0x18, 0x3c, 0x3c, 0x3c, 0x3c, 0x3c,
-    0x3c, 0x3c, 0x3c, 0x3c, 0x1b, 0x07, 0x07, 0x03, 0xf0, 0xf8, 0xf8, 0xf0,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf0, 0xf8, 0xf8,
-    0xf0, 0x1f, 0x3f, 0x3f, 0xdf, 0xe0, 0xe0, 0xe0, 0xe0, 0xe0, 0xe0, 0xe0,
-    0xe0, 0xe0, 0xdf, 0x3f, 0x3f, 0x1f, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01,
-    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0xfe, 0xff, 0xff, 0xfe, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x03, 0x07, 0x07, 0x03, 0xf0, 0xf8, 0xf8, 0xf6, 0x0f, 0x0f, 0x0f, 0x0f,
-    0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x06, 0x00, 0x00, 0x00, 0x1f, 0x3f, 0x3f,
-    0xdf, 0xe0, 0xe0, 0xe0, 0xe0, 0xe0, 0xe0, 0xe0, 0xe0, 0xe0, 0xc0, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
-    0x01, 0x01, 0x01, 0xfe, 0xff, 0xff, 0xfe, 0x00, 0x00, 0x00, 0x18, 0x3c,
-    0x3c, 0x3c, 0x3c, 0x3c, 0x3c, 0x3c, 0x3c, 0x3c, 0x1b, 0x07, 0x07, 0x03,
-    0xf0, 0xf8, 0xf8, 0xf6, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f,
-    0x0f, 0x06, 0x00, 0x00, 0x00, 0x1f, 0x3f, 0x3f, 0xdf, 0xe0, 0xe0, 0xe0,
-    0xe0, 0xe0, 0xe0, 0xe0, 0xe0, 0xe0, 0xc0, 0x00, 0x00, 0x00, 0xfe, 0xff,
-    0xff, 0xfe, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0xfe,
-    0xff, 0xff, 0xfe, 0x03, 0x07, 0x07, 0x1b, 0x3c, 0x3c, 0x3c, 0x3c, 0x3c,
-    0x3c, 0x3c, 0x3c, 0x3c, 0x1b, 0x07, 0x07, 0x03, 0x00, 0x00, 0x00, 0x06,
-    0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0xf6, 0xf8, 0xf8,
-    0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x1f, 0x3f, 0x3f, 0x1f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xfe, 0xff, 0xff, 0xfe, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x03, 0x07, 0x07, 0x03, 0xf0, 0xf8, 0xf8, 0xf6, 0x0f, 0x0f, 0x0f, 0x0f,
-    0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0xf6, 0xf8, 0xf8, 0xf0, 0x1f, 0x3f, 0x3f,
-    0xdf, 0xe0, 0xe0, 0xe0, 0xe0, 0xe0, 0xe0, 0xe0, 0xe0, 0xe0, 0xdf, 0x3f,
-    0x3f, 0x1f, 0xfe, 0xff, 0xff, 0xfe, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
-    0x01, 0x01, 0x01, 0xfe, 0xff, 0xff, 0xfe, 0x03, 0x07, 0x07, 0x1b, 0x3c,
-    0x3c, 0x3c, 0x3c, 0x3c, 0x3c, 0x3c, 0x3c, 0x3c, 0x1b, 0x07, 0x07, 0x03,
-    0xf0, 0xf8, 0xf8, 0xf6, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f,
-    0x0f, 0xf6, 0xf8, 0xf8, 0xf0, 0x1f, 0x3f, 0x3f, 0xdf, 0xe0, 0xe0, 0xe0,
-    0xe0, 0xe0, 0xe0, 0xe0, 0xe0, 0xe0, 0xdf, 0x3f, 0x3f, 0x1f, 0x00, 0x00,
-    0x00, 0x00, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0xfe,
-    0xff, 0xff, 0xfe, 0x00, 0x00, 0x00, 0x18, 0x3c, 0x3c, 0x3c, 0x3c, 0x3c,
-    0x3c, 0x3c, 0x3c, 0x3c, 0x1b, 0x07, 0x07, 0x03, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0xc0, 0xe0, 0xf0, 0xf0, 0xf0, 0xe0, 0xc0, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x03, 0x03, 0x03, 0x01,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
-    0xc0, 0xe0, 0xe0, 0xe0, 0xc0, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x01, 0x03, 0x07, 0x07, 0x07, 0x03, 0x01, 0x00,
-    0x00, 0x00, 0x00, 0x00};
-
-const struct ssd1306_font font_7segment = {.type = SSD1306_FIXED_WIDTH_FONT,
-                                           .first_char = '0',
-                                           .last_char = ':',
-                                           .space_width = 17,
-                                           .horizontal_separation = 4,
-                                           .page_alignment = 4,
-                                           .data = font_seven_segment_17x30,
-                                           .data_length = 748};
+extern const struct ssd1306_font font_7segment;
 
 #endif /* !__SSD1306_FONT_7SEG_17X30_H */
@@ -8,6 +8,7 @@
 #ifndef __SSD1306_H
 #define __SSD1306_H
 
+#include "ssd1306_bitmap.h"
 #include <stdint.h>
 
 #define SSD1306_COMMAND_SET_CONTRAST_CONTROL 0x81
@@ -21,6 +22,8 @@
 #define SSD1306_COMMAND_LEFT_SCROLL_SETUP 0x27
 #define SSD1306_COMMAND_VERTICAL_AND_RIGHT_SCROLL_SETUP 0x29
 #define SSD1306_COMMAND_VERTICAL_AND_LEFT_SCROLL_SETUP 0x2A
+#define SSD1306_COMMAND_RIGHT_ONE_COLUMN_SCROLL 0x2C
+#define SSD1306_COMMAND_LEFT_ONE_COLUMN_SCROLL 0x2D
 #define SSD1306_COMMAND_DEACTIVATE_SCROLL 0x2E
 #define SSD1306_COMMAND_ACTIVATE_SCROLL 0x2F
 #define SSD1306_COMMAND_SET_VERTICAL_SCROLL_AREA 0xA3
@@ -128,14 +131,199 @@ enum ssd1306_scrolling_rate {
     SCROLL_RATE_2_FRAMES
 };
 
+/**
+ * @brief Number of transfers that can be queued in asynchronous mode. It must
+ *        be a power of two not greater than 128.
+ */
+#ifndef SSD1306_ASYNC_QUEUE_LENGTH
+#define SSD1306_ASYNC_QUEUE_LENGTH 8u
+#endif
+
+/**
+ * @brief Transfers up to this length are copied into the queue, so the source
+ *        can be reused as soon as the write function returns.
+ */
+#ifndef SSD1306_ASYNC_INLINE_SIZE
+#define SSD1306_ASYNC_INLINE_SIZE 32u
+#endif
+
+/**
+ * @brief Barrier issued before a queued transfer is published to the
+ *        completion interrupt, so that the interrupt never sees a half-written
+ *        transfer. It is a DMB on ARMv7 and later cores, e.g. a Cortex-M7 with
+ *        a write buffer, and a compiler barrier on other GCC and Clang
+ *        targets. Other compilers must define it.
+ */
+#ifndef SSD1306_MEMORY_BARRIER
+#if defined(__GNUC__) && defined(__ARM_ARCH) && __ARM_ARCH >= 7
+#define SSD1306_MEMORY_BARRIER() __asm__ volatile("dmb" ::: "memory")
+#elif defined(__GNUC__)
+#define SSD1306_MEMORY_BARRIER() __asm__ volatile("" ::: "memory")
+#else
+#define SSD1306_MEMORY_BARRIER()
+#endif
+#endif
+
+/**
+ * @brief Size of the buffer used to gather whole columns of display data in
+ *        vertical addressing mode. Up to SSD1306_ASYNC_INLINE_SIZE bytes, the
+ *        columns are copied into the queue in asynchronous mode.
+ */
+#ifndef SSD1306_COLUMN_BUFFER_SIZE
+#define SSD1306_COLUMN_BUFFER_SIZE 32u
+#endif
+
+/**
+ * @brief I2C clock frequencies used to estimate the bus time.
+ */
+#define SSD1306_I2C_STANDARD_MODE 100000u
+#define SSD1306_I2C_FAST_MODE 400000u
+#define SSD1306_I2C_FAST_MODE_PLUS 1000000u
+
+/**
+ * @brief Maximum payload of each I2C transfer when the payload has to be copied
+ *        after the control byte because neither i2c_writev nor i2c_buffer is
+ *        available. The buffer is on the stack. Display data held in a bitmap
+ *        is sent in place and doesn't go through it.
+ */
+#ifndef SSD1306_I2C_BOUNCE_SIZE
+#define SSD1306_I2C_BOUNCE_SIZE 32u
+#endif
+
+/**
+ * @brief Struct describing a segment of a scatter-gather write.
+ */
+struct ssd1306_iovec {
+    const uint8_t *base; /**< Pointer to the segment bytes. */
+    uint16_t length;     /**< Segment length. */
+};
+
+/**
+ * @brief Kind of bytes sent in a transfer.
+ */
+enum ssd1306_transfer_type {
+    SSD1306_COMMAND_TRANSFER, /**< Commands and command arguments. */
+    SSD1306_DATA_TRANSFER     /**< Graphics display data. */
+};
+
+/**
+ * @brief Struct describing a queued transfer.
+ */
+struct ssd1306_transfer {
+    const uint8_t *src; /**< Pointer to the bytes to write. */
+    uint16_t length;    /**< Number of bytes to write. */
+    enum ssd1306_transfer_type type; /**< Command or data transfer. */
+    uint8_t header;                  /**< Transport header (control byte). */
+    struct ssd1306_iovec iov[2];     /**< Header and payload segments. */
+    uint8_t buffer[SSD1306_ASYNC_INLINE_SIZE]; /**< Storage for short
+                                                    transfers. */
+};
+
+/**
+ * @brief Struct holding the transfer queue used in asynchronous mode.
+ */
+struct ssd1306_async {
+    struct ssd1306_transfer queue[SSD1306_ASYNC_QUEUE_LENGTH]; /**< Queue. */
+    volatile uint8_t head; /**< Number of submitted transfers. */
+    volatile uint8_t tail; /**< Number of completed transfers. */
+    volatile uint8_t busy; /**< 1 while a transfer is on the wire. */
+};
+
+struct ssd1306_driver;
+
+/**
+ * @brief Struct describing how bytes are sent to the SSD1306 chip. The
+ *        transport adds whatever header is needed to select between commands
+ *        and data, so payloads are never modified.
+ */
+struct ssd1306_transport {
+    /** Writes a burst of bytes and returns when it has been sent. */
+    void (*write)(struct ssd1306_driver *, enum ssd1306_transfer_type,
+                  const uint8_t *, uint16_t);
+    /** Starts a non-blocking write of a queued transfer.
+     *  ssd1306_transfer_complete must be called once it has finished. */
+    void (*write_async)(struct ssd1306_driver *, struct ssd1306_transfer *);
+};
+
+/**
+ * @brief I2C transport. The control byte selects between commands and data.
+ */
+extern const struct ssd1306_transport ssd1306_i2c_transport;
+
+/**
+ * @brief 4-wire SPI transport. The D/C pin selects between commands and data.
+ */
+extern const struct ssd1306_transport ssd1306_spi_transport;
+
+/**
+ * @brief Struct holding the transport counters. They are only updated when
+ *        the library is built with SSD1306_STATS defined, and stay at 0
+ *        otherwise.
+ */
+struct ssd1306_stats {
+    uint32_t transactions;  /**< Number of transfers on the bus. */
+    uint32_t command_bytes; /**< Command bytes, without control bytes. */
+    uint32_t data_bytes;    /**< Display data bytes, without control bytes. */
+    uint32_t time;          /**< Clock ticks spent writing to the transport,
+                                 including waits for the asynchronous queue. */
+};
+
 /**
  * @brief Struct for driving a SSD1306-based display.
  */
 struct ssd1306_driver {
     /** SSD1306 I2C address. */
     uint8_t i2c_address;
-    /** Function to write to the SSD1306 chip using the I2C interface. */
+    /** Function to write to the SSD1306 chip using the I2C interface. The
+     *  first byte is the control byte. Display data held in a bitmap is sent
+     *  in place, with the control byte written over the byte before it for
+     *  the duration of the call. */
     void (*i2c_write)(uint8_t, uint8_t *, uint16_t);
+    /** Transport used to write to the SSD1306 chip, NULL for I2C. */
+    const struct ssd1306_transport *transport;
+    /** Function to write a list of segments in a single I2C transfer. If set,
+     *  it is used instead of i2c_write. It is the recommended I2C function,
+     *  as no payload is ever copied or split. */
+    void (*i2c_writev)(uint8_t, const struct ssd1306_iovec *, uint8_t);
+    /** Buffer used by i2c_write to prepend the control byte to payloads that
+     *  can't be sent in place, e.g. commands and ssd1306_write_gddram data
+     *  (optional). Payloads are split to fit in it. If NULL, a
+     *  SSD1306_I2C_BOUNCE_SIZE byte buffer on the stack is used. */
+    uint8_t *i2c_buffer;
+    uint16_t i2c_buffer_size; /**< I2C buffer size. */
+    /** Function to start a non-blocking I2C write of a list of segments. The
+     *  platform must call ssd1306_transfer_complete once it has finished. */
+    void (*i2c_writev_async)(uint8_t, const struct ssd1306_iovec *, uint8_t);
+    /** Function to write to the SSD1306 chip using the SPI interface. */
+    void (*spi_write)(const uint8_t *, uint16_t);
+    /** Function to start a non-blocking SPI write. The platform must call
+     *  ssd1306_transfer_complete once the transfer has finished. */
+    void (*spi_write_async)(const uint8_t *, uint16_t);
+    /** Function to set the D/C pin level (0 for commands, 1 for data). */
+    void (*spi_set_dc)(uint8_t);
+    /** Function called while waiting for a transfer to finish (optional). */
+    void (*yield)(void);
+    /** Transfer queue. If not NULL, transfers are non-blocking. */
+    struct ssd1306_async *async;
+    /** Buffer collecting commands between ssd1306_begin_batch and
+     *  ssd1306_end_batch, NULL when commands are sent immediately. */
+    uint8_t *batch;
+    uint16_t batch_size;   /**< Batch buffer size. */
+    uint16_t batch_length; /**< Bytes in the batch buffer. */
+    /** Addressing mode of the SSD1306, recorded by ssd1306_configure and
+     *  ssd1306_set_addressing_mode. The GDDRAM update functions use it to
+     *  choose the address commands. */
+    enum ssd1306_addressing_mode addressing_mode;
+    /** Maximum number of display data bytes per transfer, 0 for no limit. */
+    uint16_t max_transfer;
+    /** User data for custom transports, e.g. the device a transport writes
+     *  to. It is not used by the library. */
+    void *context;
+    /** Function returning a timestamp in any unit, used to measure the time
+     *  spent in the transport (optional). */
+    uint32_t (*clock)(void);
+    /** Transport counters since the last ssd1306_stats_reset. */
+    struct ssd1306_stats stats;
 };
 
 /**
@@ -177,6 +365,19 @@ struct ssd1306_scrolling_config {
     uint8_t rows;      /**< Number of rows for vertical scrolling. */
 };
 
+/**
+ * @brief Struct holding a copy of the SSD1306 GDDRAM contents. It is used to
+ *        compute the minimal set of bytes that need to be sent to the display.
+ */
+struct ssd1306_shadow {
+    uint8_t *data;   /**< Shadow buffer (width * height / 8 bytes). */
+    uint16_t length; /**< Shadow buffer length. */
+    uint8_t valid;   /**< 0 if the shadow does not match the GDDRAM. */
+    uint16_t bytes_sent;  /**< Bytes sent by the last update. */
+    uint16_t bytes_saved; /**< Bytes saved by the last update compared to a
+                               full GDDRAM update. */
+};
+
 /**
  * @brief Sets the contrast value.
  * @param driver Pointer to a ssd1306 struct.
@@ -234,6 +435,34 @@ void ssd1306_activate_scroll(struct ssd1306_driver *driver,
  */
 void ssd1306_deactivate_scroll(struct ssd1306_driver *driver);
 
+/**
+ * @brief Shifts the GDDRAM contents of some pages by one column. Unlike the
+ *        continuous scroll, the GDDRAM can be written right after the shift.
+ *        Only the SSD1306B supports this command; on other controllers,
+ *        the shifted pages have to be sent again.
+ * @param driver Pointer to a ssd1306 struct.
+ * @param config Scrolling configuration. Only the direction of the mode, the
+ *        start page and the end page are used.
+ */
+void ssd1306_scroll_one_column(struct ssd1306_driver *driver,
+                               struct ssd1306_scrolling_config config);
+
+/**
+ * @brief Sets the GDDRAM row shown at the top of the display. Scrolls the
+ *        display vertically without sending the GDDRAM contents again.
+ * @param driver Pointer to a ssd1306 struct.
+ * @param line Start line (0-63).
+ */
+void ssd1306_set_start_line(struct ssd1306_driver *driver, uint8_t line);
+
+/**
+ * @brief Sets the GDDRAM addressing mode.
+ * @param driver Pointer to a ssd1306 struct.
+ * @param mode Addressing mode.
+ */
+void ssd1306_set_addressing_mode(struct ssd1306_driver *driver,
+                                 enum ssd1306_addressing_mode mode);
+
 /**
  * @brief Configures the SSD1306 chip.
  * @param driver Pointer to a ssd1306 struct.
@@ -249,13 +478,198 @@ void ssd1306_configure(struct ssd1306_driver *driver,
 struct ssd1306_config ssd1306_get_default_config(void);
 
 /**
- * @brief Updates SSD1306 Graphics Display Data RAM.
+ * @brief Updates SSD1306 Graphics Display Data RAM. A frame of whole
+ *        128-column pages is sent like ssd1306_update_gddram_pages, from page
+ *        0, in the addressing mode of the driver and split by max_transfer.
+ *        Other lengths are written as is at the current GDDRAM address, and
+ *        nothing is sent if lenght is below 2.
  * @param driver Pointer to a ssd1306 struct.
  * @param bitmap Array containing graphics display data.
- * @pram length Number of bytes to write.
- * @note The first byte in the bitmap array is reserved as a control byte.
+ * @param lenght Number of bytes of the array, including the first byte.
+ * @note The first byte in the bitmap array is not sent. It is only kept for
+ *       compatibility with SSD1306_BUFFER_SIZE buffers.
+ * @deprecated Use ssd1306_update_gddram_pages with a ssd1306_bitmap, or
+ *             ssd1306_write_gddram for raw display data.
+ * @note In asynchronous mode the bitmap array is sent without being copied,
+ *       so it must not be modified until ssd1306_async_buffer_busy returns 0.
  */
 void ssd1306_update_gddram(struct ssd1306_driver *driver, uint8_t *bitmap,
                            uint16_t lenght);
 
+/**
+ * @brief Writes graphics display data to the SSD1306 GDDRAM at the current
+ *        address. The data is never modified, so it can be stored in flash.
+ * @param driver Pointer to a ssd1306 struct.
+ * @param data Array containing graphics display data.
+ * @param length Number of bytes to write.
+ * @note In asynchronous mode the data is sent without being copied, so it
+ *       must not be modified until ssd1306_async_buffer_busy returns 0.
+ */
+void ssd1306_write_gddram(struct ssd1306_driver *driver, const uint8_t *data,
+                          uint16_t length);
+
+/**
+ * @brief Updates a rectangular window of the SSD1306 GDDRAM. The address
+ *        commands depend on the addressing mode of the driver: a column/page
+ *        window in horizontal and vertical modes, or the page start and column
+ *        start commands for each page in page mode. In vertical mode, whole
+ *        columns are gathered into SSD1306_COLUMN_BUFFER_SIZE byte transfers.
+ * @param driver Pointer to a ssd1306 struct.
+ * @param bm Pointer to a ssd1306_bitmap struct containing the display data.
+ * @param start_column First column of the window.
+ * @param end_column Last column of the window.
+ * @param start_page First page of the window.
+ * @param end_page Last page of the window.
+ * @note In asynchronous mode the bitmap is sent without being copied, so it
+ *       must not be modified until ssd1306_async_buffer_busy returns 0.
+ */
+void ssd1306_update_gddram_window(struct ssd1306_driver *driver,
+                                  struct ssd1306_bitmap *bm,
+                                  uint8_t start_column, uint8_t end_column,
+                                  uint8_t start_page, uint8_t end_page);
+
+/**
+ * @brief Updates whole pages of the SSD1306 GDDRAM.
+ * @param driver Pointer to a ssd1306 struct.
+ * @param bm Pointer to a ssd1306_bitmap struct containing the display data.
+ * @param start_page First page to update.
+ * @param end_page Last page to update.
+ * @note In asynchronous mode the bitmap is sent without being copied, so it
+ *       must not be modified until ssd1306_async_buffer_busy returns 0.
+ */
+void ssd1306_update_gddram_pages(struct ssd1306_driver *driver,
+                                 struct ssd1306_bitmap *bm, uint8_t start_page,
+                                 uint8_t end_page);
+
+/**
+ * @brief Updates only the dirty regions of the SSD1306 GDDRAM and marks the
+ *        bitmap as clean. Dirty spans of different pages are merged into a
+ *        single window when it takes fewer bytes on the bus.
+ * @param driver Pointer to a ssd1306 struct.
+ * @param bm Pointer to a ssd1306_bitmap struct containing the display data.
+ * @note In asynchronous mode the bitmap is sent without being copied, so it
+ *       must not be modified until ssd1306_async_buffer_busy returns 0.
+ */
+void ssd1306_update_dirty_gddram(struct ssd1306_driver *driver,
+                                 struct ssd1306_bitmap *bm);
+
+/**
+ * @brief Updates the SSD1306 GDDRAM by sending only the byte runs that differ
+ *        from the shadow copy, then updates the shadow copy. A full update is
+ *        performed when the shadow is not valid or when it is cheaper.
+ * @param driver Pointer to a ssd1306 struct.
+ * @param bm Pointer to a ssd1306_bitmap struct containing the display data.
+ * @param shadow Pointer to a ssd1306_shadow struct.
+ * @return Number of bytes saved compared to a full GDDRAM update.
+ * @note In asynchronous mode the bitmap is sent without being copied, so it
+ *       must not be modified until ssd1306_async_buffer_busy returns 0.
+ */
+uint16_t ssd1306_update_gddram_diff(struct ssd1306_driver *driver,
+                                    struct ssd1306_bitmap *bm,
+                                    struct ssd1306_shadow *shadow);
+
+/**
+ * @brief Notifies the end of a non-blocking transfer and starts the next
+ *        queued transfer, if any. It is meant to be called from the I2C/SPI
+ *        interrupt or DMA completion handler.
+ * @param driver Pointer to a ssd1306 struct.
+ */
+void ssd1306_transfer_complete(struct ssd1306_driver *driver);
+
+/**
+ * @brief Returns the number of transfers that have not been completed yet.
+ * @param driver Pointer to a ssd1306 struct.
+ * @return Number of pending transfers (0 in blocking mode).
+ */
+uint8_t ssd1306_async_pending(struct ssd1306_driver *driver);
+
+/**
+ * @brief Waits until all the queued transfers have been completed, calling
+ *        the yield function while waiting.
+ * @param driver Pointer to a ssd1306 struct.
+ */
+void ssd1306_async_wait(struct ssd1306_driver *driver);
+
+/**
+ * @brief Checks whether a buffer is referenced by a pending transfer.
+ * @param driver Pointer to a ssd1306 struct.
+ * @param buffer Pointer to the buffer.
+ * @param length Buffer length.
+ * @return 1 if the buffer must not be modified yet, 0 otherwise.
+ */
+uint8_t ssd1306_async_buffer_busy(struct ssd1306_driver *driver,
+                                  const uint8_t *buffer, uint16_t length);
+
+/**
+ * @brief Waits until a buffer is not referenced by any pending transfer,
+ *        calling the yield function while waiting.
+ * @param driver Pointer to a ssd1306 struct.
+ * @param buffer Pointer to the buffer.
+ * @param length Buffer length.
+ */
+void ssd1306_async_wait_buffer(struct ssd1306_driver *driver,
+                               const uint8_t *buffer, uint16_t length);
+
+/**
+ * @brief Starts collecting commands in a buffer instead of sending each one in
+ *        its own transfer. All the commands are sent in a single transfer by
+ *        ssd1306_end_batch, or earlier if the buffer gets full or display data
+ *        has to be written.
+ * @param driver Pointer to a ssd1306 struct.
+ * @param buffer Buffer for the commands.
+ * @param size Buffer size.
+ */
+void ssd1306_begin_batch(struct ssd1306_driver *driver, uint8_t *buffer,
+                         uint16_t size);
+
+/**
+ * @brief Sends the collected commands and goes back to sending each command
+ *        immediately.
+ * @param driver Pointer to a ssd1306 struct.
+ */
+void ssd1306_end_batch(struct ssd1306_driver *driver);
+
+/**
+ * @brief Returns the transport counters since the last reset.
+ * @param driver Pointer to a ssd1306 struct.
+ */
+struct ssd1306_stats
+ssd1306_stats_snapshot(const struct ssd1306_driver *driver);
+
+/**
+ * @brief Resets the transport counters, e.g. at the start of a frame.
+ * @param driver Pointer to a ssd1306 struct.
+ */
+void ssd1306_stats_reset(struct ssd1306_driver *driver);
+
+/**
+ * @brief Returns the counters accumulated between two snapshots, e.g. taken
+ *        before and after an API call.
+ * @param before Earlier snapshot.
+ * @param after Later snapshot.
+ */
+struct ssd1306_stats ssd1306_stats_delta(struct ssd1306_stats before,
+                                         struct ssd1306_stats after);
+
+/**
+ * @brief Estimates the time the counted transfers take on an I2C bus. Each
+ *        byte takes 9 clock cycles, and each transfer adds the start and stop
+ *        conditions, the address and the control byte.
+ * @param stats Pointer to a ssd1306_stats struct.
+ * @param clock_hz I2C clock frequency, e.g. SSD1306_I2C_FAST_MODE.
+ * @return Bus time in microseconds.
+ */
+uint32_t ssd1306_stats_i2c_us(const struct ssd1306_stats *stats,
+                              uint32_t clock_hz);
+
+/**
+ * @brief Estimates the time the counted transfers take on a SPI bus, 8 clock
+ *        cycles per byte.
+ * @param stats Pointer to a ssd1306_stats struct.
+ * @param clock_hz SPI clock frequency.
+ * @return Bus time in microseconds.
+ */
+uint32_t ssd1306_stats_spi_us(const struct ssd1306_stats *stats,
+                              uint32_t clock_hz);
+
 #endif /* !__SSD1306_H */
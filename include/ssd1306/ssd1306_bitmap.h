@@ -15,7 +15,52 @@
  * @param WIDTH Display width in pixels.
  * @param HEIGHT Display height in pixels.
  */
-#define SSD1306_BUFFER_SIZE(WIDTH, HEIGHT) (1u + (WIDTH) * ((HEIGHT) >> 3u))
+#define SSD1306_FRAMEBUFFER_SIZE(WIDTH, HEIGHT) ((WIDTH) * ((HEIGHT) >> 3u))
+
+/**
+ * @brief Macro to compute the size of a buffer whose first byte is reserved as
+ *        a control byte. This layout is kept for compatibility: a bitmap whose
+ *        length includes the reserved byte stores the pixels from data[1].
+ * @param WIDTH Display width in pixels.
+ * @param HEIGHT Display height in pixels.
+ */
+#define SSD1306_BUFFER_SIZE(WIDTH, HEIGHT)                                     \
+    (1u + SSD1306_FRAMEBUFFER_SIZE(WIDTH, HEIGHT))
+
+/**
+ * @brief Maximum number of pages of the SSD1306 GDDRAM.
+ */
+#define SSD1306_MAX_PAGES 8u
+
+/**
+ * @brief Unsigned integer type used by the bulk bitmap operations. It should
+ *        be the native word of the MCU, e.g. uint32_t on Cortex-M, and can't
+ *        be wider than 8 bytes.
+ */
+#ifndef SSD1306_WORD_TYPE
+#define SSD1306_WORD_TYPE uintptr_t
+#endif
+
+/**
+ * @brief Struct holding a rectangular area of the display.
+ */
+struct ssd1306_rect {
+    int16_t x;      /**< Left position of the area. */
+    int16_t y;      /**< Top position of the area. */
+    uint8_t width;  /**< Area width in pixels. */
+    uint8_t height; /**< Area height in pixels. */
+};
+
+/**
+ * @brief Logical operations used to combine pixel data.
+ */
+enum ssd1306_raster_op {
+    SSD1306_ROP_COPY, /**< dst = src */
+    SSD1306_ROP_OR,   /**< dst = dst | src */
+    SSD1306_ROP_AND,  /**< dst = dst & src */
+    SSD1306_ROP_XOR,  /**< dst = dst ^ src */
+    SSD1306_ROP_MASK, /**< dst = (dst & ~mask) | (src & mask) */
+};
 
 /**
  * @brief Struct for writing graphic primitives and text to the SSD1306 display.
@@ -25,17 +70,201 @@ struct ssd1306_bitmap {
     uint8_t height;  /**< Display height in pixels. */
     uint16_t length; /**< Buffer length. */
     uint8_t *data;   /**< Pointer to buffer data. */
+    uint8_t band_page;  /**< First page held in data when the bitmap is used
+                             as a band of the display. */
+    uint8_t band_pages; /**< Number of pages held in data, 0 if the bitmap
+                             holds the whole display. */
+    uint8_t ring_page;  /**< GDDRAM page holding the first page of the
+                             bitmap, when the display start line is used to
+                             scroll. Only for bitmaps holding the whole
+                             display. */
+    uint8_t dirty_start[SSD1306_MAX_PAGES]; /**< First dirty column. */
+    uint8_t dirty_end[SSD1306_MAX_PAGES]; /**< Last dirty column + 1 (0 if
+                                               the page is clean). */
 };
 
 /**
- * @brief Fills the canvas data with 0x00.
- * @param canvas Pointer to a ssd1306_canvas struct.
+ * @brief Returns the number of pages held in the bitmap data.
+ * @param bm Pointer to a ssd1306_bitmap struct.
  */
-static inline void ssd1306_bitmap_clear(struct ssd1306_bitmap *bm)
+static inline uint8_t ssd1306_bitmap_pages(const struct ssd1306_bitmap *bm)
 {
-    for (uint16_t i = 1; i < bm->length; i++) {
-        bm->data[i] = 0x00;
+    return bm->band_pages ? bm->band_pages : bm->height >> 3u;
+}
+
+/**
+ * @brief Returns the first row held in the bitmap data.
+ * @param bm Pointer to a ssd1306_bitmap struct.
+ */
+static inline uint8_t ssd1306_bitmap_top(const struct ssd1306_bitmap *bm)
+{
+    return bm->band_page << 3u;
+}
+
+/**
+ * @brief Returns the last row held in the bitmap data.
+ * @param bm Pointer to a ssd1306_bitmap struct.
+ */
+static inline uint8_t ssd1306_bitmap_bottom(const struct ssd1306_bitmap *bm)
+{
+    uint16_t end = (bm->band_page + ssd1306_bitmap_pages(bm)) << 3u;
+    return (end < bm->height ? end : bm->height) - 1u;
+}
+
+/**
+ * @brief Returns the number of bytes of pixel data of a bitmap.
+ * @param bm Pointer to a ssd1306_bitmap struct.
+ */
+static inline uint16_t ssd1306_bitmap_size(const struct ssd1306_bitmap *bm)
+{
+    return bm->width * ssd1306_bitmap_pages(bm);
+}
+
+/**
+ * @brief Returns a pointer to the first byte of pixel data, skipping the
+ *        reserved byte of bitmaps that use the SSD1306_BUFFER_SIZE layout.
+ * @param bm Pointer to a ssd1306_bitmap struct.
+ */
+static inline uint8_t *ssd1306_bitmap_pixels(const struct ssd1306_bitmap *bm)
+{
+    return bm->data + (bm->length > ssd1306_bitmap_size(bm));
+}
+
+/**
+ * @brief Returns the GDDRAM page that holds a page of the bitmap.
+ * @param bm Pointer to a ssd1306_bitmap struct.
+ * @param page Page number.
+ */
+static inline uint8_t ssd1306_bitmap_ring(const struct ssd1306_bitmap *bm,
+                                          uint8_t page)
+{
+    uint8_t pages = bm->height >> 3u;
+
+    page += bm->ring_page;
+    return page >= pages ? page - pages : page;
+}
+
+/**
+ * @brief Returns a pointer to the first byte of a page held in the bitmap
+ *        data.
+ * @param bm Pointer to a ssd1306_bitmap struct.
+ * @param page Page number.
+ */
+static inline uint8_t *ssd1306_bitmap_page(const struct ssd1306_bitmap *bm,
+                                           uint8_t page)
+{
+    return ssd1306_bitmap_pixels(bm) +
+           (ssd1306_bitmap_ring(bm, page) - bm->band_page) * bm->width;
+}
+
+/**
+ * @brief Marks the columns [start, end) of a page as modified.
+ * @param bm Pointer to a ssd1306_bitmap struct.
+ * @param page Page number.
+ * @param start First modified column.
+ * @param end Last modified column + 1.
+ */
+static inline void ssd1306_bitmap_mark_page(struct ssd1306_bitmap *bm,
+                                            uint8_t page, uint8_t start,
+                                            uint8_t end)
+{
+    page = ssd1306_bitmap_ring(bm, page);
+    if (bm->dirty_end[page] == 0 || start < bm->dirty_start[page])
+        bm->dirty_start[page] = start;
+    if (end > bm->dirty_end[page])
+        bm->dirty_end[page] = end;
+}
+
+/**
+ * @brief Marks a rectangular area of the bitmap as modified. The area is
+ *        clipped to the bitmap dimensions.
+ * @param bm Pointer to a ssd1306_bitmap struct.
+ * @param x Left position of the area.
+ * @param y Top position of the area.
+ * @param w Area width in pixels.
+ * @param h Area height in pixels.
+ */
+static inline void ssd1306_bitmap_mark_dirty(struct ssd1306_bitmap *bm,
+                                             uint8_t x, uint8_t y, uint8_t w,
+                                             uint8_t h)
+{
+    if (x >= bm->width || y >= bm->height || w == 0 || h == 0)
+        return;
+
+    uint8_t end = (w > bm->width - x) ? bm->width : x + w;
+    uint8_t last = (h > bm->height - y) ? bm->height - 1 : y + h - 1;
+
+    for (uint8_t p = y >> 3u; p <= (last >> 3u); p++) {
+        ssd1306_bitmap_mark_page(bm, p, x, end);
+    }
+}
+
+/**
+ * @brief Marks the whole bitmap as clean, e.g. after a GDDRAM update.
+ * @param bm Pointer to a ssd1306_bitmap struct.
+ */
+static inline void ssd1306_bitmap_reset_dirty(struct ssd1306_bitmap *bm)
+{
+    for (uint8_t p = 0; p < SSD1306_MAX_PAGES; p++) {
+        bm->dirty_end[p] = 0;
     }
 }
 
+/**
+ * @brief Checks whether the bitmap has been modified since the last reset.
+ * @param bm Pointer to a ssd1306_bitmap struct.
+ * @return 1 if any page is dirty, 0 otherwise.
+ */
+static inline uint8_t ssd1306_bitmap_is_dirty(const struct ssd1306_bitmap *bm)
+{
+    for (uint8_t p = 0; p < SSD1306_MAX_PAGES; p++) {
+        if (bm->dirty_end[p])
+            return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Fills the bitmap data with 0x00 and marks it as dirty. Only the
+ *        pages held in the data are cleared and marked.
+ * @param bm Pointer to a ssd1306_bitmap struct.
+ */
+void ssd1306_bitmap_clear(struct ssd1306_bitmap *bm);
+
+/**
+ * @brief Fills the bitmap data with an 8x8 pattern and marks it as dirty.
+ * @param bm Pointer to a ssd1306_bitmap struct.
+ * @param pattern 8x8 pattern, one byte per column.
+ */
+void ssd1306_bitmap_fill(struct ssd1306_bitmap *bm, const uint8_t *pattern);
+
+/**
+ * @brief Inverts every pixel of the bitmap data and marks it as dirty.
+ * @param bm Pointer to a ssd1306_bitmap struct.
+ */
+void ssd1306_bitmap_invert(struct ssd1306_bitmap *bm);
+
+/**
+ * @brief Copies the pixel data of a bitmap into another one and marks it as
+ *        dirty.
+ * @param dst Pointer to the destination ssd1306_bitmap struct.
+ * @param src Pointer to the source ssd1306_bitmap struct.
+ * @return 1 if the bitmaps don't hold the same number of bytes, 0 otherwise.
+ */
+uint8_t ssd1306_bitmap_copy(struct ssd1306_bitmap *dst,
+                            const struct ssd1306_bitmap *src);
+
+/**
+ * @brief Combines the pixel data of a bitmap into another one and marks it as
+ *        dirty.
+ * @param dst Pointer to the destination ssd1306_bitmap struct.
+ * @param src Pointer to the source ssd1306_bitmap struct.
+ * @param op Logical operation, SSD1306_ROP_MASK is not supported.
+ * @return 1 if the bitmaps don't hold the same number of bytes or the
+ *         operation is not supported, 0 otherwise.
+ */
+uint8_t ssd1306_bitmap_merge(struct ssd1306_bitmap *dst,
+                             const struct ssd1306_bitmap *src,
+                             enum ssd1306_raster_op op);
+
 #endif /* !__SSD1306_BITMAP_H */
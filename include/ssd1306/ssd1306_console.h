@@ -0,0 +1,60 @@
+/**
+ * @file ssd1306_console.h
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief This file provides a scrolling text console. When the console is
+ *        full, the display is scrolled with the start line register, so only
+ *        the new line is sent to the GDDRAM.
+ */
+
+#ifndef __SSD1306_CONSOLE_H
+#define __SSD1306_CONSOLE_H
+
+#include "ssd1306.h"
+#include "ssd1306_bitmap.h"
+#include "ssd1306_text.h"
+#include <stdint.h>
+
+/**
+ * @brief Struct holding the state of a console.
+ */
+struct ssd1306_console {
+    struct ssd1306_driver *driver; /**< Pointer to a ssd1306 struct. */
+    struct ssd1306_text *text;     /**< Bitmap and font used to draw the
+                                        lines. The bitmap must hold the whole
+                                        GDDRAM (64 rows). */
+    uint8_t line;                  /**< Number of lines printed, up to the
+                                        number of lines of the display. */
+    uint8_t rows;                  /**< Rows seen on the display, a multiple
+                                        of 8 (32 on 128x32 panels), or 0 if
+                                        the display shows the whole
+                                        GDDRAM. */
+};
+
+/**
+ * @brief Clears the bitmap and the display and resets the start line.
+ * @param con Pointer to a ssd1306_console struct with the driver and text
+ *        set.
+ * @return 1 if the bitmap doesn't hold the whole GDDRAM, rows isn't a
+ *         multiple of 8 up to 64 or the font is taller than the display, 0
+ *         otherwise.
+ */
+uint8_t ssd1306_console_init(struct ssd1306_console *con);
+
+/**
+ * @brief Prints a line at the bottom of the console. If the console is full,
+ *        the oldest line is scrolled out by moving the start line.
+ *
+ *        When the display shows fewer rows than the GDDRAM, such as 128x32
+ *        panels, and its height is a multiple of the line height, the new
+ *        line is drawn in the hidden rows first, so it is never seen half
+ *        sent. Otherwise, the start line is moved first and the slot of the
+ *        oldest line shows at the bottom until the new line is sent.
+ *
+ *        The bitmap keeps the scroll position in its ring_page field, so the
+ *        other drawing functions still use the rows seen on the display.
+ * @param con Pointer to a ssd1306_console struct.
+ * @param str Line to print. It is clipped at the right edge.
+ */
+void ssd1306_console_print(struct ssd1306_console *con, const char *str);
+
+#endif /* !__SSD1306_CONSOLE_H */
@@ -0,0 +1,147 @@
+/**
+ * @file ssd1306_display_list.h
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief This file provides functions for recording graphic primitives and
+ *        text in a display list and rendering it one band of pages at a time,
+ *        so that a full frame can be drawn without a full frame buffer.
+ */
+
+#ifndef __SSD1306_DISPLAY_LIST_H
+#define __SSD1306_DISPLAY_LIST_H
+
+#include "font/ssd1306_font.h"
+#include "ssd1306.h"
+#include "ssd1306_bitmap.h"
+#include <stdint.h>
+
+/**
+ * @brief Display list entry type.
+ */
+enum ssd1306_dl_type {
+    SSD1306_DL_LINE,     /**< Line drawn with ssd1306_draw_line. */
+    SSD1306_DL_CIRCLE,   /**< Circle drawn with ssd1306_draw_circle. */
+    SSD1306_DL_POLYGON,  /**< Polygon drawn with ssd1306_draw_polygon. */
+    SSD1306_DL_POLYLINE, /**< Polyline drawn with ssd1306_draw_polyline. */
+    SSD1306_DL_TEXT      /**< Text drawn with ssd1306_draw_text. */
+};
+
+/**
+ * @brief Struct holding a recorded draw call.
+ */
+struct ssd1306_dl_entry {
+    enum ssd1306_dl_type type; /**< Entry type. */
+    int16_t top;               /**< First row touched by the entry. */
+    int16_t bottom;            /**< Last row touched by the entry. */
+    union {
+        struct {
+            int8_t x1, y1, x2, y2;
+        } line; /**< Line end points. */
+        struct {
+            int8_t cx, cy, r;
+        } circle; /**< Circle center and radius. */
+        struct {
+            int8_t *x, *y;
+            uint16_t n;
+        } poly; /**< Polygon or polyline points. */
+        struct {
+            const struct ssd1306_font *font;
+            const char *str;
+            uint8_t col, row;
+            uint16_t width;
+        } text; /**< Text font, string, cursor position and width. */
+    } params; /**< Draw call parameters. */
+};
+
+/**
+ * @brief Struct holding a list of recorded draw calls.
+ */
+struct ssd1306_display_list {
+    struct ssd1306_dl_entry *entries; /**< Array of entries. */
+    uint16_t capacity;                /**< Number of entries in the array. */
+    uint16_t count;                   /**< Number of recorded entries. */
+};
+
+/**
+ * @brief Removes all the entries of a display list.
+ * @param dl Pointer to a ssd1306_display_list struct.
+ */
+static inline void ssd1306_dl_clear(struct ssd1306_display_list *dl)
+{
+    dl->count = 0;
+}
+
+/**
+ * @brief Records a line. See ssd1306_draw_line.
+ * @param dl Pointer to a ssd1306_display_list struct.
+ * @param x1 Start point position on the x-axis.
+ * @param y1 Start point position on the y-axis.
+ * @param x2 End point position on the x-axis.
+ * @param y2 End point position on the y-axis.
+ * @return 0 on success, 1 if the display list is full.
+ */
+uint8_t ssd1306_dl_line(struct ssd1306_display_list *dl, int8_t x1, int8_t y1,
+                        int8_t x2, int8_t y2);
+
+/**
+ * @brief Records a circle. See ssd1306_draw_circle.
+ * @param dl Pointer to a ssd1306_display_list struct.
+ * @param cx Center x-axis position.
+ * @param cy Center y-axis position.
+ * @param r Radius.
+ * @return 0 on success, 1 if the display list is full.
+ */
+uint8_t ssd1306_dl_circle(struct ssd1306_display_list *dl, int8_t cx,
+                          int8_t cy, int8_t r);
+
+/**
+ * @brief Records a polygon. See ssd1306_draw_polygon.
+ * @param dl Pointer to a ssd1306_display_list struct.
+ * @param x Array containing points x-axis positions.
+ * @param y Array containing points y-axis positions.
+ * @param n Number of points in the array.
+ * @return 0 on success, 1 if the display list is full or n is 0.
+ * @note The arrays are not copied and must be valid until rendering.
+ */
+uint8_t ssd1306_dl_polygon(struct ssd1306_display_list *dl, int8_t *x,
+                           int8_t *y, uint16_t n);
+
+/**
+ * @brief Records a polyline. See ssd1306_draw_polyline.
+ * @param dl Pointer to a ssd1306_display_list struct.
+ * @param x Array containing points x-axis positions.
+ * @param y Array containing points y-axis positions.
+ * @param n Number of points in the array.
+ * @return 0 on success, 1 if the display list is full or n is 0.
+ * @note The arrays are not copied and must be valid until rendering.
+ */
+uint8_t ssd1306_dl_polyline(struct ssd1306_display_list *dl, int8_t *x,
+                            int8_t *y, uint16_t n);
+
+/**
+ * @brief Records some text. See ssd1306_draw_text.
+ * @param dl Pointer to a ssd1306_display_list struct.
+ * @param font Pointer to a ssd1306_font struct.
+ * @param col Cursor column.
+ * @param row Cursor row.
+ * @param str Text to draw.
+ * @return 0 on success, 1 if the display list is full.
+ * @note The string is not copied and must be valid until rendering.
+ */
+uint8_t ssd1306_dl_text(struct ssd1306_display_list *dl,
+                        const struct ssd1306_font *font, uint8_t col,
+                        uint8_t row, const char *str);
+
+/**
+ * @brief Renders a display list band by band and sends each band to the
+ *        SSD1306 GDDRAM before rendering the next one. Entries that do not
+ *        touch a band are skipped.
+ * @param driver Pointer to a ssd1306 struct.
+ * @param dl Pointer to a ssd1306_display_list struct.
+ * @param band Pointer to a ssd1306_bitmap struct with the display dimensions
+ *        whose data holds band_pages pages (1 if band_pages is 0).
+ */
+void ssd1306_dl_render(struct ssd1306_driver *driver,
+                       struct ssd1306_display_list *dl,
+                       struct ssd1306_bitmap *band);
+
+#endif /* !__SSD1306_DISPLAY_LIST_H */
@@ -11,6 +11,22 @@
 #include "ssd1306_bitmap.h"
 #include <stdint.h>
 
+/**
+ * @brief Maximum number of edges of a filled polygon crossing the same row.
+ *        ssd1306_fill_polygon keeps the crossings of 8 rows on the stack.
+ */
+#ifndef SSD1306_POLYGON_MAX_NODES
+#define SSD1306_POLYGON_MAX_NODES 16u
+#endif
+
+/**
+ * @brief 8x8 dither patterns for the fill functions. Each byte holds the rows
+ *        of a column, in the same layout as the display pages.
+ */
+extern const uint8_t ssd1306_pattern_dither25[8];
+extern const uint8_t ssd1306_pattern_dither50[8];
+extern const uint8_t ssd1306_pattern_dither75[8];
+
 /**
  * @brief Sets a pixel at the (x, y) position.
  * @param bm Pointer to a ssd1306_bitmap stuct.
@@ -20,16 +36,50 @@
 static inline void ssd1306_set_pixel(struct ssd1306_bitmap *bm, uint8_t x,
                                      uint8_t y)
 {
-    if (x < bm->width && y < bm->height) {
-        uint16_t index = 1u + x + (y >> 3u) * bm->width;
+    uint8_t page = (y >> 3u) - bm->band_page;
+
+    if (x < bm->width && y < bm->height && page < ssd1306_bitmap_pages(bm)) {
         uint8_t value = 1u << (y - ((y >> 3u) << 3u));
-        bm->data[index] |= value;
+        ssd1306_bitmap_page(bm, y >> 3u)[x] |= value;
+        ssd1306_bitmap_mark_page(bm, y >> 3u, x, x + 1u);
     }
 }
 
+/**
+ * @brief Draws a horizontal line from (x, y) to (x + w - 1, y).
+ * @param bm Pointer to a ssd1306_bitmap struct.
+ * @param x Start point position on the x-axis.
+ * @param y Position on the y-axis.
+ * @param w Line width in pixels.
+ */
+void ssd1306_draw_hline(struct ssd1306_bitmap *bm, int8_t x, int8_t y,
+                        uint8_t w);
+
+/**
+ * @brief Draws a vertical line from (x, y) to (x, y + h - 1).
+ * @param bm Pointer to a ssd1306_bitmap struct.
+ * @param x Position on the x-axis.
+ * @param y Start point position on the y-axis.
+ * @param h Line height in pixels.
+ */
+void ssd1306_draw_vline(struct ssd1306_bitmap *bm, int8_t x, int8_t y,
+                        uint8_t h);
+
+/**
+ * @brief Clears the pixels from (x, y) to (x, y + h - 1), one masked byte per
+ *        page.
+ * @param bm Pointer to a ssd1306_bitmap struct.
+ * @param x Position on the x-axis.
+ * @param y Start point position on the y-axis.
+ * @param h Line height in pixels.
+ */
+void ssd1306_clear_vline(struct ssd1306_bitmap *bm, int8_t x, int8_t y,
+                         uint8_t h);
+
 /**
  * @brief Draws a line from (x1, y1) to (x2, y2) using the Bresenham's line
- *        algorithm.
+ *        algorithm. Pixels are drawn in horizontal runs for shallow lines and
+ *        in vertical runs for steep lines.
  * @param bm Pointer to a ssd1306_bitmap struct.
  * @param x1 Start point position on the x-axis.
  * @param y1 Start point position on the y-axis.
@@ -69,4 +119,56 @@ void ssd1306_draw_polygon(struct ssd1306_bitmap *bm, int8_t *x, int8_t *y,
 void ssd1306_draw_polyline(struct ssd1306_bitmap *bm, int8_t *x, int8_t *y,
                            uint16_t n);
 
+/**
+ * @brief Fills a rectangle. Whole pages are written a byte at a time.
+ * @param bm Pointer to a ssd1306_bitmap struct.
+ * @param x Top left corner position on the x-axis.
+ * @param y Top left corner position on the y-axis.
+ * @param w Width in pixels.
+ * @param h Height in pixels.
+ * @param pattern 8x8 pattern, one byte per column, or NULL to fill solid.
+ */
+void ssd1306_fill_rect(struct ssd1306_bitmap *bm, int8_t x, int8_t y,
+                       uint8_t w, uint8_t h, const uint8_t *pattern);
+
+/**
+ * @brief Clears the pixels of a rectangle.
+ * @param bm Pointer to a ssd1306_bitmap struct.
+ * @param x Top left corner position on the x-axis.
+ * @param y Top left corner position on the y-axis.
+ * @param w Width in pixels.
+ * @param h Height in pixels.
+ */
+void ssd1306_clear_rect(struct ssd1306_bitmap *bm, int8_t x, int8_t y,
+                        uint8_t w, uint8_t h);
+
+/**
+ * @brief Fills a circle using the midpoint algorithm, one vertical span per
+ *        column.
+ * @param bm Pointer to a ssd1306_bitmap struct.
+ * @param cx Center x-axis position.
+ * @param cy Center y-axis position.
+ * @param r Radius.
+ * @param pattern 8x8 pattern, one byte per column, or NULL to fill solid.
+ */
+void ssd1306_fill_circle(struct ssd1306_bitmap *bm, int8_t cx, int8_t cy,
+                         int8_t r, const uint8_t *pattern);
+
+/**
+ * @brief Fills a convex or concave polygon with the even-odd rule. The spans
+ *        of the 8 rows of a page are combined, so each byte is written once
+ *        and columns whose 8 rows are inside are written a whole byte at a
+ *        time. Solid polygons also get their outline, so they cover what
+ *        ssd1306_draw_polygon draws.
+ * @param bm Pointer to ssd1306_bitmap struct.
+ * @param x Array containing points x-axis positions.
+ * @param y Array containing points y-axis positions.
+ * @param n Number of points in the array.
+ * @param pattern 8x8 pattern, one byte per column, or NULL to fill solid.
+ * @return 1 if a row is crossed by more than SSD1306_POLYGON_MAX_NODES edges
+ *         and nothing is drawn, 0 otherwise.
+ */
+uint8_t ssd1306_fill_polygon(struct ssd1306_bitmap *bm, int8_t *x, int8_t *y,
+                             uint16_t n, const uint8_t *pattern);
+
 #endif /** !__SSD1306_GRAPHICS_H */
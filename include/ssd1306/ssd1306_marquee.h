@@ -0,0 +1,74 @@
+/**
+ * @file ssd1306_marquee.h
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief This file provides a marquee that scrolls a line of text to the
+ *        left. On a SSD1306B, only the column entering the display is sent
+ *        on each step.
+ */
+
+#ifndef __SSD1306_MARQUEE_H
+#define __SSD1306_MARQUEE_H
+
+#include "ssd1306.h"
+#include "ssd1306_bitmap.h"
+#include "ssd1306_text.h"
+#include <stdint.h>
+
+/**
+ * @brief Struct holding the state of a marquee.
+ */
+struct ssd1306_marquee {
+    struct ssd1306_driver *driver; /**< Pointer to a ssd1306 struct. */
+    struct ssd1306_text *text;     /**< Bitmap and font used to draw the
+                                        text. The bitmap must hold the whole
+                                        display. */
+    const char *str;               /**< Text to scroll. It is not copied. */
+    uint8_t page;                  /**< First page of the marquee. */
+    uint8_t gap;                   /**< Blank columns between the end of the
+                                        text and its next repetition. */
+    uint16_t frames;               /**< Frames between steps. */
+    uint16_t length;               /**< Columns of text and gap. */
+    uint16_t index;                /**< Character of the next column. */
+    uint8_t column;                /**< Next column of that character. */
+    uint8_t hardware;              /**< 1 if the SSD1306 scrolls the text by
+                                        itself. */
+    uint8_t ssd1306b;              /**< 1 if the controller is a SSD1306B,
+                                        which can shift the GDDRAM with
+                                        ssd1306_scroll_one_column. If 0,
+                                        each step sends the marquee pages
+                                        whole. */
+};
+
+/**
+ * @brief Starts a marquee. If the text and the gap divide the display width
+ *        and the step period is one of the SSD1306 scrolling rates, the text
+ *        is drawn once per m->length columns and scrolled by the SSD1306.
+ *        Otherwise, the marquee is cleared and the text enters from the
+ *        right with each call to ssd1306_marquee_step. Both ways, the text
+ *        repeats every m->length columns.
+ * @param m Pointer to a ssd1306_marquee struct with the driver, text, str,
+ *        page, gap, frames and ssd1306b set.
+ * @return 1 if the marquee doesn't fit in the display or the text is empty,
+ *         0 otherwise.
+ */
+uint8_t ssd1306_marquee_start(struct ssd1306_marquee *m);
+
+/**
+ * @brief Moves the marquee one column to the left. It must be called every
+ *        m->frames frames and does nothing if the SSD1306 is scrolling the
+ *        text. The marquee pages are shifted in the bitmap. On a SSD1306B, the
+ *        GDDRAM contents are shifted with ssd1306_scroll_one_column and only
+ *        the new column is sent, in the caller's command batch if one is
+ *        open. Otherwise, the marquee pages are sent whole.
+ * @param m Pointer to a ssd1306_marquee struct.
+ */
+void ssd1306_marquee_step(struct ssd1306_marquee *m);
+
+/**
+ * @brief Stops the marquee. If the SSD1306 was scrolling the text, the
+ *        scroll is deactivated and the marquee pages are sent again.
+ * @param m Pointer to a ssd1306_marquee struct.
+ */
+void ssd1306_marquee_stop(struct ssd1306_marquee *m);
+
+#endif /* !__SSD1306_MARQUEE_H */
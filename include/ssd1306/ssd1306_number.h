@@ -0,0 +1,118 @@
+/**
+ * @file ssd1306_number.h
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief This file provides numeric fields that draw integers, fixed-point
+ *        and floating-point values without formatting them into a string.
+ *        Only the characters that changed since the last value are drawn
+ *        again.
+ */
+
+#ifndef __SSD1306_NUMBER_H
+#define __SSD1306_NUMBER_H
+
+#include "ssd1306_bitmap.h"
+#include "ssd1306_text.h"
+#include <stdint.h>
+
+/**
+ * @brief Maximum number of digits after the decimal point.
+ */
+#define SSD1306_NUMBER_MAX_PRECISION 9u
+
+/**
+ * @brief Struct holding a right-aligned numeric field. Digits and the sign
+ *        are drawn in cells as wide as the widest digit, so that the
+ *        characters don't move when the value changes.
+ */
+struct ssd1306_number {
+    struct ssd1306_text *text; /**< Bitmap and font used to draw the field. */
+    uint8_t x;                 /**< Left position of the field. */
+    uint8_t y;                 /**< Top position of the field. */
+    uint8_t width;             /**< Number of characters, including the sign
+                                    and the decimal point. */
+    uint8_t precision;         /**< Digits after the decimal point, up to
+                                    SSD1306_NUMBER_MAX_PRECISION. */
+    uint8_t zero_pad;          /**< 1 to pad the field with zeros instead of
+                                    spaces. */
+    uint8_t cell_width;        /**< Width of a digit cell in pixels. */
+    uint8_t point_width;       /**< Width of the decimal point cell in
+                                    pixels. */
+    char *drawn;               /**< Characters drawn in the bitmap, width
+                                    elements. */
+    uint8_t valid;             /**< 0 if the bitmap doesn't hold the drawn
+                                    characters, e.g. after clearing it. */
+};
+
+/**
+ * @brief Computes the cell sizes from the font. The first draw draws every
+ *        character.
+ * @param n Pointer to a ssd1306_number struct with the text, position,
+ *        width, precision and buffer set.
+ * @return 1 if the precision is above SSD1306_NUMBER_MAX_PRECISION or the
+ *         field has no room for the decimal point, 0 otherwise.
+ */
+uint8_t ssd1306_number_init(struct ssd1306_number *n);
+
+/**
+ * @brief Forces the next draw to draw every character.
+ * @param n Pointer to a ssd1306_number struct.
+ */
+static inline void ssd1306_number_invalidate(struct ssd1306_number *n)
+{
+    n->valid = 0;
+}
+
+/**
+ * @brief Returns the width of a numeric field in pixels.
+ * @param n Pointer to a ssd1306_number struct.
+ */
+static inline uint16_t ssd1306_number_width(const struct ssd1306_number *n)
+{
+    if (!n->precision || !n->width)
+        return n->width * n->cell_width;
+    return (n->width - 1u) * n->cell_width + n->point_width;
+}
+
+/**
+ * @brief Draws an integer. The digits after the decimal point, if any, are
+ *        zeros.
+ * @param n Pointer to a ssd1306_number struct.
+ * @param value Value to draw.
+ * @return 1 if the value doesn't fit in the field and dashes are drawn
+ *         instead, 0 otherwise.
+ */
+uint8_t ssd1306_draw_int(struct ssd1306_number *n, int32_t value);
+
+/**
+ * @brief Draws a decimal fixed-point value, given in units of the last
+ *        digit: with a precision of 2, 1234 is drawn as 12.34.
+ * @param n Pointer to a ssd1306_number struct.
+ * @param value Value to draw, scaled by 10 ^ precision.
+ * @return 1 if the value doesn't fit in the field and dashes are drawn
+ *         instead, 0 otherwise.
+ */
+uint8_t ssd1306_draw_decimal(struct ssd1306_number *n, int32_t value);
+
+/**
+ * @brief Draws a binary fixed-point value, rounded to the precision of the
+ *        field.
+ * @param n Pointer to a ssd1306_number struct.
+ * @param value Value to draw, scaled by 2 ^ frac_bits.
+ * @param frac_bits Number of fractional bits of value, up to 31.
+ * @return 1 if the value doesn't fit in the field and dashes are drawn
+ *         instead, 0 otherwise.
+ */
+uint8_t ssd1306_draw_fixed(struct ssd1306_number *n, int32_t value,
+                           uint8_t frac_bits);
+
+/**
+ * @brief Draws a floating-point value, rounded to the precision of the
+ *        field.
+ * @param n Pointer to a ssd1306_number struct.
+ * @param value Value to draw.
+ * @return 1 if the value is not finite or doesn't fit in the field and
+ *         dashes are drawn instead, 0 otherwise.
+ */
+uint8_t ssd1306_draw_float(struct ssd1306_number *n, float value);
+
+#endif /* !__SSD1306_NUMBER_H */
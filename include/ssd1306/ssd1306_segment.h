@@ -0,0 +1,97 @@
+/**
+ * @file ssd1306_segment.h
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief This file provides a seven-segment readout drawn from segment
+ *        geometry, at any size and without font data. Only the segments that
+ *        changed since the last update are drawn or cleared.
+ */
+
+#ifndef __SSD1306_SEGMENT_H
+#define __SSD1306_SEGMENT_H
+
+#include "ssd1306_bitmap.h"
+#include <stdint.h>
+
+/**
+ * @brief Segment bits of a digit.
+ *
+ *      -- A --
+ *     |       |
+ *     F       B
+ *     |       |
+ *      -- G --
+ *     |       |
+ *     E       C
+ *     |       |
+ *      -- D --   DP
+ */
+#define SSD1306_SEGMENT_A 0x01u
+#define SSD1306_SEGMENT_B 0x02u
+#define SSD1306_SEGMENT_C 0x04u
+#define SSD1306_SEGMENT_D 0x08u
+#define SSD1306_SEGMENT_E 0x10u
+#define SSD1306_SEGMENT_F 0x20u
+#define SSD1306_SEGMENT_G 0x40u
+#define SSD1306_SEGMENT_DP 0x80u
+
+/**
+ * @brief Struct holding a row of seven-segment digits. Segments are
+ *        hexagons with 45 degree tips, one pixel apart from each other, so
+ *        that any segment can be cleared without touching the others.
+ */
+struct ssd1306_segment_display {
+    struct ssd1306_bitmap *bitmap; /**< Pointer to a ssd1306_bitmap struct. */
+    int8_t x;                      /**< Left position of the first digit. */
+    int8_t y;                      /**< Top position of the digits. */
+    uint8_t digit_width;           /**< Digit width in pixels. */
+    uint8_t digit_height;          /**< Digit height in pixels. */
+    uint8_t thickness;             /**< Segment thickness in pixels. */
+    uint8_t spacing;               /**< Columns between digits. The decimal
+                                        point is drawn centered in them, at
+                                        most spacing - 1 columns wide. */
+    uint8_t digits;                /**< Number of digits. */
+    uint8_t *drawn;                /**< Segments drawn in the bitmap, one
+                                        byte per digit. */
+    uint8_t valid;                 /**< 0 if the bitmap doesn't hold the drawn
+                                        segments, e.g. after clearing it. */
+};
+
+/**
+ * @brief Forces the next update to draw every digit.
+ * @param d Pointer to a ssd1306_segment_display struct.
+ */
+static inline void
+ssd1306_segment_invalidate(struct ssd1306_segment_display *d)
+{
+    d->valid = 0;
+}
+
+/**
+ * @brief Returns the segments of a character: digits, hexadecimal letters,
+ *        '-', '_' and ' '. Other characters have no segments.
+ * @param c Character.
+ */
+uint8_t ssd1306_segment_encode(char c);
+
+/**
+ * @brief Sets the segments of a digit. Segments that are no longer lit are
+ *        cleared and new ones are drawn, one vertical span per column, so an
+ *        update touches only the columns of the segments that changed.
+ * @param d Pointer to a ssd1306_segment_display struct.
+ * @param pos Digit position, from the left.
+ * @param segments Segment bits, see SSD1306_SEGMENT_A.
+ */
+void ssd1306_segment_set(struct ssd1306_segment_display *d, uint8_t pos,
+                         uint8_t segments);
+
+/**
+ * @brief Shows a string, one character per digit from the left. A '.'
+ *        lights the decimal point of the previous digit, and the digits
+ *        after the string are blanked.
+ * @param d Pointer to a ssd1306_segment_display struct.
+ * @param str String to show.
+ */
+void ssd1306_segment_print(struct ssd1306_segment_display *d,
+                           const char *str);
+
+#endif /* !__SSD1306_SEGMENT_H */
@@ -0,0 +1,43 @@
+/**
+ * @file ssd1306_sprite.h
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief This file provides functions for drawing page-format images at any
+ *        position of a ssd1306_bitmap struct.
+ */
+
+#ifndef __SSD1306_SPRITE_H
+#define __SSD1306_SPRITE_H
+
+#include "ssd1306_bitmap.h"
+#include <stdint.h>
+
+/**
+ * @brief Struct holding a page-format image. Every page of the image stores
+ *        one byte per column, with the top row in the least significant bit,
+ *        in the same layout as the display GDDRAM.
+ */
+struct ssd1306_sprite {
+    uint8_t width;       /**< Image width in pixels. */
+    uint8_t height;      /**< Image height in pixels. */
+    const uint8_t *data; /**< Image data, (height + 7) / 8 pages. */
+    const uint8_t *mask; /**< Mask data with the same layout, or NULL. Only
+                              used by SSD1306_ROP_MASK. */
+};
+
+/**
+ * @brief Draws a sprite with its top left corner at (x, y). The sprite is
+ *        clipped to the bitmap data, so it can be partially or completely
+ *        outside of the display.
+ * @param bm Pointer to a ssd1306_bitmap struct.
+ * @param sprite Pointer to a ssd1306_sprite struct.
+ * @param x Top left corner position on the x-axis.
+ * @param y Top left corner position on the y-axis.
+ * @param op Logical operation. SSD1306_ROP_COPY replaces every pixel under
+ *        the sprite. SSD1306_ROP_MASK replaces the pixels set in the mask and
+ *        behaves as SSD1306_ROP_OR if the sprite has no mask.
+ */
+void ssd1306_draw_sprite(struct ssd1306_bitmap *bm,
+                         const struct ssd1306_sprite *sprite, int16_t x,
+                         int16_t y, enum ssd1306_raster_op op);
+
+#endif /* !__SSD1306_SPRITE_H */
@@ -12,6 +12,52 @@
 #include "ssd1306_bitmap.h"
 #include <stdint.h>
 
+/**
+ * @brief Maximum number of lines of a ssd1306_layout struct.
+ */
+#ifndef SSD1306_LAYOUT_MAX_LINES
+#define SSD1306_LAYOUT_MAX_LINES 8u
+#endif
+
+/**
+ * @brief Codepoint returned for invalid UTF-8 sequences.
+ */
+#define SSD1306_UTF8_INVALID 0xFFFDu
+
+/**
+ * @brief Horizontal alignment of the lines of a text layout.
+ */
+enum ssd1306_text_align {
+    SSD1306_ALIGN_LEFT,   /**< Lines start at the left of the box. */
+    SSD1306_ALIGN_CENTER, /**< Lines are centered in the box. */
+    SSD1306_ALIGN_RIGHT   /**< Lines end at the right of the box. */
+};
+
+/**
+ * @brief Struct holding a line of a text layout.
+ */
+struct ssd1306_layout_line {
+    uint16_t start;  /**< Index of the first byte of the line. */
+    uint16_t length; /**< Number of bytes of the line. */
+    int16_t x;       /**< Line offset from the left of the box. */
+    uint16_t width;  /**< Line width in pixels, including the ellipsis. */
+};
+
+/**
+ * @brief Struct holding a laid out text, so that it can be drawn again
+ *        without measuring it.
+ */
+struct ssd1306_layout {
+    const char *str;            /**< Laid out text. It is not copied. */
+    struct ssd1306_rect box;    /**< Area where the text is laid out. */
+    struct ssd1306_rect bounds; /**< Bounding box of the lines. */
+    uint8_t line_height;        /**< Line height in pixels. */
+    uint8_t line_count;         /**< Number of lines. */
+    uint8_t ellipsis;           /**< 1 if the last line ends with an ellipsis
+                                     because the text doesn't fit. */
+    struct ssd1306_layout_line lines[SSD1306_LAYOUT_MAX_LINES]; /**< Lines. */
+};
+
 /**
  * @brief Struct for managing text rendering.
  */
@@ -22,6 +68,58 @@ struct ssd1306_text {
     uint8_t cursor_row;              /**< Cursor row position. */
 };
 
+/**
+ * @brief Decodes the UTF-8 character at the start of a string. ASCII
+ *        characters take a single comparison. Invalid, overlong and
+ *        truncated sequences decode to SSD1306_UTF8_INVALID and consume a
+ *        single byte, so the terminator is never skipped.
+ * @param str String, not at its terminator.
+ * @param c Pointer receiving the codepoint.
+ * @return Number of bytes of the character.
+ */
+static inline uint8_t ssd1306_utf8_decode(const char *str, uint32_t *c)
+{
+    const uint8_t *s = (const uint8_t *)str;
+    uint8_t n;
+    uint32_t min;
+
+    if (s[0] < 0x80u) {
+        *c = s[0];
+        return 1;
+    }
+
+    if ((s[0] & 0xE0u) == 0xC0u) {
+        n = 2;
+        min = 0x80u;
+        *c = s[0] & 0x1Fu;
+    } else if ((s[0] & 0xF0u) == 0xE0u) {
+        n = 3;
+        min = 0x800u;
+        *c = s[0] & 0x0Fu;
+    } else if ((s[0] & 0xF8u) == 0xF0u) {
+        n = 4;
+        min = 0x10000u;
+        *c = s[0] & 0x07u;
+    } else {
+        *c = SSD1306_UTF8_INVALID;
+        return 1;
+    }
+
+    for (uint8_t k = 1; k < n; k++) {
+        if ((s[k] & 0xC0u) != 0x80u) {
+            *c = SSD1306_UTF8_INVALID;
+            return 1;
+        }
+        *c = (*c << 6u) | (s[k] & 0x3Fu);
+    }
+
+    if (*c < min || *c > 0x10FFFFu || (*c >= 0xD800u && *c <= 0xDFFFu)) {
+        *c = SSD1306_UTF8_INVALID;
+        return 1;
+    }
+    return n;
+}
+
 /**
  * @brief Sets cursor position.
  * @param r Pointer to a ssd1306_text struct.
@@ -34,9 +132,67 @@ void ssd1306_set_cursor_position(struct ssd1306_text *t, uint8_t col,
 /**
  * @brief Draws a some text at the current cursor position.
  * @param r Pointer to a ssd1306_text struct.
+ * @param str UTF-8 text to draw. Characters without a glyph are skipped.
+ */
+void ssd1306_draw_text(struct ssd1306_text *t, const char *str);
+
+/**
+ * @brief Draws some text with its top left corner at the pixel (x, y),
+ *        without wrapping. Glyphs are clipped to the bitmap, so y doesn't
+ *        need to be aligned to a page and the text can be partially outside
+ *        of the display. The cursor is not modified.
+ * @param t Pointer to a ssd1306_text struct.
+ * @param x Position on the x-axis.
+ * @param y Position on the y-axis.
  * @param str Text to draw.
+ * @param op Logical operation used to combine the glyphs with the bitmap:
+ *        SSD1306_ROP_COPY overwrites the glyph cells, SSD1306_ROP_OR draws
+ *        transparent text and SSD1306_ROP_XOR inverts the pixels below.
+ * @return Position on the x-axis after the last glyph.
+ */
+int16_t ssd1306_draw_text_at(struct ssd1306_text *t, int16_t x, int16_t y,
+                             const char *str, enum ssd1306_raster_op op);
+
+/**
+ * @brief Draws a single glyph with its top left corner at the pixel (x, y),
+ *        clipped to the bitmap like ssd1306_draw_text_at.
+ * @param t Pointer to a ssd1306_text struct.
+ * @param x Position on the x-axis.
+ * @param y Position on the y-axis.
+ * @param c Glyph index, see ssd1306_font_glyph.
+ * @param op Logical operation used to combine the glyph with the bitmap.
+ * @return Glyph width in pixels.
+ */
+uint8_t ssd1306_draw_glyph(struct ssd1306_text *t, int16_t x, int16_t y,
+                           uint16_t c, enum ssd1306_raster_op op);
+
+/**
+ * @brief Breaks a text into lines that fit in a box, walking the string once.
+ *        Lines are broken at spaces, or inside a word that doesn't fit in a
+ *        line, and at '\n'. If the text needs more lines than fit in the box,
+ *        the last line is truncated and ends with an ellipsis.
+ * @param t Pointer to a ssd1306_text struct.
+ * @param layout Pointer to the ssd1306_layout struct to fill.
+ * @param str Text to lay out. It must outlive the layout.
+ * @param box Area where the text is laid out.
+ * @param align Horizontal alignment of the lines.
+ * @return 1 if the text was truncated, 0 otherwise.
+ */
+uint8_t ssd1306_layout_text(struct ssd1306_text *t,
+                            struct ssd1306_layout *layout, const char *str,
+                            const struct ssd1306_rect *box,
+                            enum ssd1306_text_align align);
+
+/**
+ * @brief Draws a laid out text.
+ * @param t Pointer to a ssd1306_text struct, with the font used for the
+ *        layout.
+ * @param layout Pointer to a ssd1306_layout struct.
+ * @param op Logical operation used to combine the glyphs with the bitmap.
  */
-void ssd1306_draw_text(struct ssd1306_text *t, char *str);
+void ssd1306_draw_layout(struct ssd1306_text *t,
+                         const struct ssd1306_layout *layout,
+                         enum ssd1306_raster_op op);
 
 /**
  * @brief Computes the text width.
@@ -44,6 +200,6 @@ void ssd1306_draw_text(struct ssd1306_text *t, char *str);
  * @param str Text.
  * @return Text width in pixels.
  */
-uint16_t ssd1306_text_width(struct ssd1306_text *t, char *str);
+uint16_t ssd1306_text_width(struct ssd1306_text *t, const char *str);
 
 #endif /* !__SSD1306_TEXT_H */
@@ -0,0 +1,99 @@
+/**
+ * @file ssd1306_tilemap.h
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief This file provides a character-cell layer on top of the text
+ *        rendering functions. Only the cells that changed since the last
+ *        render are drawn again.
+ */
+
+#ifndef __SSD1306_TILEMAP_H
+#define __SSD1306_TILEMAP_H
+
+#include "ssd1306_bitmap.h"
+#include "ssd1306_text.h"
+#include <stdint.h>
+
+/**
+ * @brief Glyph index of an empty cell.
+ */
+#define SSD1306_TILEMAP_BLANK 0xFFFFu
+
+/**
+ * @brief Struct holding a grid of character cells.
+ */
+struct ssd1306_tilemap {
+    struct ssd1306_text *text; /**< Bitmap and font used to draw the cells.
+                                    The bitmap must hold the whole display. */
+    uint8_t x;                 /**< Left position of the grid. */
+    uint8_t y;                 /**< Top position of the grid. */
+    uint8_t cols;              /**< Number of columns. */
+    uint8_t rows;              /**< Number of rows. */
+    uint8_t cell_width;        /**< Cell width in pixels. */
+    uint8_t cell_height;       /**< Cell height in pixels. */
+    uint16_t *cells;           /**< Glyph indices of the cells, see
+                                    ssd1306_font_glyph, cols * rows. */
+    uint16_t *drawn;           /**< Glyph indices drawn in the bitmap,
+                                    cols * rows. */
+    uint8_t valid;             /**< 0 if the bitmap doesn't hold the drawn
+                                    glyphs, e.g. after clearing it. */
+};
+
+/**
+ * @brief Computes the cell size from the font and empties the grid. The
+ *        first render draws every cell.
+ * @param map Pointer to a ssd1306_tilemap struct with the text, position,
+ *        size and buffers set.
+ */
+void ssd1306_tilemap_init(struct ssd1306_tilemap *map);
+
+/**
+ * @brief Forces the next render to draw every cell.
+ * @param map Pointer to a ssd1306_tilemap struct.
+ */
+static inline void ssd1306_tilemap_invalidate(struct ssd1306_tilemap *map)
+{
+    map->valid = 0;
+}
+
+/**
+ * @brief Sets the glyph of a cell.
+ * @param map Pointer to a ssd1306_tilemap struct.
+ * @param col Cell column.
+ * @param row Cell row.
+ * @param glyph Glyph index, see ssd1306_font_glyph, or
+ *        SSD1306_TILEMAP_BLANK.
+ */
+static inline void ssd1306_tilemap_put(struct ssd1306_tilemap *map,
+                                       uint8_t col, uint8_t row,
+                                       uint16_t glyph)
+{
+    if (col < map->cols && row < map->rows)
+        map->cells[col + row * map->cols] = glyph;
+}
+
+/**
+ * @brief Writes a string to the cells of a row, starting at a column. The
+ *        string is clipped at the end of the row.
+ * @param map Pointer to a ssd1306_tilemap struct.
+ * @param col First cell column.
+ * @param row Cell row.
+ * @param str UTF-8 string to write, one character per cell. Spaces and
+ *        characters without a glyph leave the cell empty.
+ */
+void ssd1306_tilemap_print(struct ssd1306_tilemap *map, uint8_t col,
+                           uint8_t row, const char *str);
+
+/**
+ * @brief Draws the cells whose glyph changed since the last render and
+ *        reports them as windows, one per run of changed cells in a row.
+ * @param map Pointer to a ssd1306_tilemap struct.
+ * @param windows Array receiving the modified areas, or NULL.
+ * @param max_windows Size of the array. When there are more runs, the last
+ *        window is grown to cover all of them.
+ * @return Number of windows.
+ */
+uint8_t ssd1306_tilemap_render(struct ssd1306_tilemap *map,
+                               struct ssd1306_rect *windows,
+                               uint8_t max_windows);
+
+#endif /* !__SSD1306_TILEMAP_H */
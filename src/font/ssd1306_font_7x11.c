@@ -0,0 +1,138 @@
+/**
+ * @file ssd1306_font_7x11.c
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief 7x11 text font to use with the ssd1306-lib text rendering functions.
+ *        Generated by ssd1306_fontc.py from ascii_7x11.png.
+ */
+
+#include "ssd1306/font/ssd1306_font_7x11.h"
+
+static const uint8_t font_7x11_data[1138] = {
+    0xfe, 0x04, 0x07, 0x00, 0x07, 0x00, 0x00, 0x00, 0x88, 0xfe, 0x88, 0x88,
+    0xfe, 0x88, 0x00, 0x03, 0x00, 0x00, 0x03, 0x00, 0x98, 0x24, 0xff, 0x24,
+    0xc8, 0x00, 0x01, 0x07, 0x01, 0x00, 0x04, 0x8a, 0x44, 0x20, 0x10, 0x88,
+    0x04, 0x01, 0x00, 0x00, 0x00, 0x01, 0x02, 0x01, 0x80, 0x46, 0x29, 0x51,
+    0x89, 0x06, 0x80, 0x01, 0x02, 0x04, 0x04, 0x04, 0x05, 0x02, 0x07, 0x00,
+    0x70, 0x8c, 0x02, 0x01, 0x00, 0x01, 0x02, 0x04, 0x01, 0x02, 0x8c, 0x70,
+    0x04, 0x02, 0x01, 0x00, 0x88, 0x50, 0x3c, 0x50, 0x88, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x20, 0x20, 0x20, 0xfc, 0x20, 0x20, 0x20, 0x00, 0x00, 0x00,
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0a, 0x06, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x06, 0x06, 0x00, 0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x01, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xfc, 0x82, 0x41, 0x21, 0x11, 0x0a, 0xfc, 0x01,
+    0x02, 0x04, 0x04, 0x04, 0x02, 0x01, 0x04, 0x02, 0xff, 0x00, 0x00, 0x04,
+    0x04, 0x07, 0x04, 0x04, 0x04, 0x02, 0x81, 0x41, 0x21, 0x12, 0x0c, 0x06,
+    0x05, 0x04, 0x04, 0x04, 0x04, 0x04, 0x02, 0x01, 0x21, 0x21, 0x21, 0x52,
+    0x8c, 0x02, 0x04, 0x04, 0x04, 0x04, 0x02, 0x01, 0x60, 0x50, 0x48, 0x44,
+    0x42, 0xff, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07, 0x00, 0x1f, 0x11,
+    0x11, 0x11, 0x11, 0x21, 0xc0, 0x01, 0x02, 0x04, 0x04, 0x04, 0x02, 0x01,
+    0xfc, 0x22, 0x11, 0x11, 0x11, 0x22, 0xc0, 0x01, 0x02, 0x04, 0x04, 0x04,
+    0x02, 0x01, 0x01, 0x01, 0x01, 0xf1, 0x09, 0x05, 0x03, 0x00, 0x00, 0x00,
+    0x07, 0x00, 0x00, 0x00, 0x8c, 0x52, 0x21, 0x21, 0x21, 0x52, 0x8c, 0x01,
+    0x02, 0x04, 0x04, 0x04, 0x02, 0x01, 0x1c, 0x22, 0x41, 0x41, 0x41, 0x22,
+    0xfc, 0x00, 0x02, 0x04, 0x04, 0x04, 0x02, 0x01, 0x8c, 0x8c, 0x01, 0x01,
+    0x8c, 0x8c, 0x02, 0x01, 0x20, 0x50, 0x88, 0x04, 0x02, 0x00, 0x00, 0x00,
+    0x01, 0x02, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x02, 0x04, 0x88, 0x50, 0x20, 0x02, 0x01, 0x00,
+    0x00, 0x00, 0x0c, 0x02, 0x01, 0x81, 0x41, 0x22, 0x1c, 0x00, 0x00, 0x00,
+    0x05, 0x00, 0x00, 0x00, 0xfc, 0x62, 0x91, 0x91, 0x61, 0x82, 0xfc, 0x01,
+    0x02, 0x04, 0x04, 0x04, 0x00, 0x01, 0xfc, 0x42, 0x41, 0x41, 0x41, 0x42,
+    0xfc, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07, 0xff, 0x21, 0x21, 0x21,
+    0x21, 0x52, 0x8c, 0x07, 0x04, 0x04, 0x04, 0x04, 0x02, 0x01, 0xf8, 0x06,
+    0x01, 0x01, 0x01, 0x01, 0x02, 0x00, 0x03, 0x04, 0x04, 0x04, 0x04, 0x02,
+    0xff, 0x01, 0x01, 0x01, 0x02, 0x04, 0xf8, 0x07, 0x04, 0x04, 0x04, 0x02,
+    0x01, 0x00, 0xff, 0x21, 0x21, 0x21, 0x21, 0x21, 0x01, 0x07, 0x04, 0x04,
+    0x04, 0x04, 0x04, 0x04, 0xff, 0x21, 0x21, 0x21, 0x21, 0x21, 0x01, 0x07,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xfc, 0x02, 0x21, 0x21, 0x21, 0x21,
+    0xe2, 0x01, 0x02, 0x04, 0x04, 0x04, 0x04, 0x03, 0xff, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0xff, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07, 0x01, 0x01,
+    0x01, 0xff, 0x01, 0x01, 0x01, 0x04, 0x04, 0x04, 0x07, 0x04, 0x04, 0x04,
+    0x80, 0x01, 0x01, 0x01, 0xff, 0x01, 0x01, 0x01, 0x02, 0x04, 0x04, 0x03,
+    0x00, 0x00, 0xff, 0x60, 0x50, 0x88, 0x04, 0x02, 0x01, 0x07, 0x00, 0x00,
+    0x00, 0x01, 0x02, 0x04, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07,
+    0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0xff, 0x0c, 0x30, 0xc0, 0x30, 0x0c,
+    0xff, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07, 0xff, 0x0c, 0x30, 0x60,
+    0xc0, 0x00, 0xff, 0x07, 0x00, 0x00, 0x00, 0x00, 0x03, 0x07, 0xfc, 0x02,
+    0x01, 0x01, 0x01, 0x02, 0xfc, 0x01, 0x02, 0x04, 0x04, 0x04, 0x02, 0x01,
+    0xff, 0x41, 0x41, 0x41, 0x41, 0x22, 0x1c, 0x07, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0xfc, 0x02, 0x41, 0x81, 0x01, 0x02, 0xfc, 0x01, 0x02, 0x04,
+    0x04, 0x05, 0x02, 0x05, 0xff, 0x41, 0x41, 0xc1, 0x41, 0x22, 0x1c, 0x07,
+    0x00, 0x00, 0x00, 0x01, 0x02, 0x04, 0x0c, 0x12, 0x21, 0x21, 0x21, 0x41,
+    0x82, 0x02, 0x04, 0x04, 0x04, 0x04, 0x02, 0x01, 0x01, 0x01, 0x01, 0xff,
+    0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 0xff, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xff, 0x01, 0x02, 0x04, 0x04, 0x04, 0x02, 0x01,
+    0x7f, 0x80, 0x00, 0x00, 0x00, 0x80, 0x7f, 0x00, 0x01, 0x02, 0x04, 0x02,
+    0x01, 0x00, 0xff, 0x00, 0x00, 0xe0, 0x00, 0x00, 0xff, 0x03, 0x04, 0x02,
+    0x01, 0x02, 0x04, 0x03, 0x03, 0x8c, 0x50, 0x20, 0x50, 0x8c, 0x03, 0x06,
+    0x01, 0x00, 0x00, 0x00, 0x01, 0x06, 0x03, 0x0c, 0x30, 0xc0, 0x30, 0x0c,
+    0x03, 0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 0x01, 0x01, 0xc1, 0x21,
+    0x19, 0x05, 0x03, 0x06, 0x05, 0x04, 0x04, 0x04, 0x04, 0x04, 0xff, 0x01,
+    0x01, 0x01, 0x01, 0x07, 0x04, 0x04, 0x04, 0x04, 0x04, 0x08, 0x10, 0x20,
+    0x40, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x01,
+    0x01, 0x01, 0xff, 0x04, 0x04, 0x04, 0x04, 0x07, 0x04, 0x02, 0x01, 0x02,
+    0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x01, 0x02, 0x04, 0x00,
+    0x00, 0x00, 0xc0, 0x20, 0x10, 0x10, 0x10, 0x20, 0xf0, 0x01, 0x02, 0x04,
+    0x04, 0x04, 0x03, 0x07, 0xff, 0x20, 0x10, 0x10, 0x10, 0x20, 0xc0, 0x07,
+    0x02, 0x04, 0x04, 0x04, 0x02, 0x01, 0xc0, 0x20, 0x10, 0x10, 0x10, 0x10,
+    0x20, 0x01, 0x02, 0x04, 0x04, 0x04, 0x04, 0x02, 0xc0, 0x20, 0x10, 0x10,
+    0x10, 0x20, 0xff, 0x01, 0x02, 0x04, 0x04, 0x04, 0x02, 0x07, 0xc0, 0xa0,
+    0x90, 0x90, 0x90, 0xa0, 0xc0, 0x01, 0x02, 0x04, 0x04, 0x04, 0x04, 0x00,
+    0x20, 0x20, 0xfe, 0x21, 0x21, 0x01, 0x02, 0x00, 0x00, 0x07, 0x00, 0x00,
+    0x00, 0x00, 0xc0, 0x20, 0x10, 0x10, 0x10, 0x20, 0xf0, 0x01, 0x12, 0x24,
+    0x24, 0x24, 0x22, 0x1f, 0xff, 0x20, 0x10, 0x10, 0x10, 0x20, 0xc0, 0x07,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x07, 0x10, 0xf4, 0x00, 0x04, 0x07, 0x04,
+    0x00, 0x00, 0x10, 0xf4, 0x10, 0x20, 0x20, 0x1f, 0xfc, 0x80, 0xc0, 0x20,
+    0x10, 0x07, 0x00, 0x00, 0x01, 0x06, 0x01, 0xff, 0x00, 0x04, 0x07, 0x04,
+    0xe0, 0x10, 0x10, 0xe0, 0x10, 0x10, 0xe0, 0x07, 0x00, 0x00, 0x01, 0x00,
+    0x00, 0x07, 0xf0, 0x20, 0x10, 0x10, 0x10, 0x20, 0xc0, 0x07, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x07, 0xc0, 0x20, 0x10, 0x10, 0x10, 0x20, 0xc0, 0x01,
+    0x02, 0x04, 0x04, 0x04, 0x02, 0x01, 0xf0, 0x20, 0x10, 0x10, 0x10, 0x20,
+    0xc0, 0x3f, 0x02, 0x04, 0x04, 0x04, 0x02, 0x01, 0xc0, 0x20, 0x10, 0x10,
+    0x10, 0x20, 0xf0, 0x01, 0x02, 0x04, 0x04, 0x04, 0x02, 0x3f, 0xf0, 0x20,
+    0x10, 0x10, 0x10, 0x60, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x60, 0x90,
+    0x90, 0x90, 0x90, 0x90, 0x20, 0x02, 0x04, 0x04, 0x04, 0x04, 0x04, 0x03,
+    0x10, 0xff, 0x10, 0x10, 0x00, 0x00, 0x03, 0x04, 0x04, 0x02, 0xf0, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xf0, 0x01, 0x02, 0x04, 0x04, 0x04, 0x02, 0x01,
+    0x30, 0xc0, 0x00, 0x00, 0x00, 0xc0, 0x30, 0x00, 0x00, 0x03, 0x04, 0x03,
+    0x00, 0x00, 0xf0, 0x00, 0x00, 0x80, 0x00, 0x00, 0xf0, 0x03, 0x04, 0x04,
+    0x03, 0x04, 0x04, 0x03, 0x10, 0x20, 0x40, 0x80, 0x40, 0x20, 0x10, 0x04,
+    0x02, 0x01, 0x00, 0x01, 0x02, 0x04, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xf0, 0x01, 0x12, 0x24, 0x24, 0x24, 0x12, 0x0f, 0x10, 0x10, 0x10, 0x90,
+    0x50, 0x30, 0x10, 0x04, 0x06, 0x05, 0x04, 0x04, 0x04, 0x04, 0x20, 0x50,
+    0x8e, 0x01, 0x01, 0x00, 0x00, 0x03, 0x04, 0x04, 0xff, 0x07, 0x01, 0x01,
+    0x8e, 0x50, 0x20, 0x04, 0x04, 0x03, 0x00, 0x00, 0x20, 0x10, 0x10, 0x20,
+    0x40, 0x40, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+
+static const uint8_t font_7x11_width[94] = {
+    1, 3, 6, 5, 7, 7, 1, 4, 4, 5, 7, 2,
+    7, 2, 7, 7, 5, 7, 7, 7, 7, 7, 7, 7,
+    7, 2, 2, 5, 7, 5, 7, 7, 7, 7, 7, 7,
+    7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+    7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 5, 7,
+    5, 5, 7, 3, 7, 7, 7, 7, 7, 7, 7, 7,
+    3, 4, 5, 3, 7, 7, 7, 7, 7, 6, 7, 5,
+    7, 7, 7, 7, 7, 7, 5, 1, 5, 7};
+
+static const uint16_t font_7x11_offset[94] = {
+    0, 2, 8, 20, 30, 44, 58, 60, 68, 76, 86, 100,
+    104, 118, 122, 136, 150, 160, 174, 188, 202, 216, 230, 244,
+    258, 272, 276, 280, 290, 304, 314, 328, 342, 356, 370, 384,
+    398, 412, 426, 440, 454, 468, 482, 496, 510, 524, 538, 552,
+    566, 580, 594, 608, 622, 636, 650, 664, 678, 692, 706, 716,
+    730, 740, 750, 764, 770, 784, 798, 812, 826, 840, 854, 868,
+    882, 888, 896, 906, 912, 926, 940, 954, 968, 982, 994, 1008,
+    1018, 1032, 1046, 1060, 1074, 1088, 1102, 1112, 1114, 1124};
+
+const struct ssd1306_font font_7x11 = {
+    .type = SSD1306_VARIABLE_WIDTH_FONT,
+    .first_char = '!',
+    .last_char = '~',
+    .space_width = 7,
+    .horizontal_separation = 3,
+    .page_alignment = 2,
+    .data = font_7x11_data,
+    .data_length = 1138,
+    .char_width = font_7x11_width,
+    .char_offset = font_7x11_offset,
+};
@@ -5,86 +5,623 @@
  *        configuring a SSD1306-driven OLED display.
  */
 #include "ssd1306/ssd1306.h"
+#include <string.h>
 
 #define SSD1306_COMMAND_SET_START_LINE(LINE) (0x40 | ((LINE) & 0x3F))
 #define SSD1306_PA_LOWER_START_COLUMN(COL) ((COL) & 0x0F)
 #define SSD1306_PA_HIGHER_START_COLUMN(COL) (0x10 | ((COL) & 0x0F))
 #define SSD1306_PA_START_PAGE(PAGE) (0xB0 | ((PAGE) & 0x07))
 
+/** Bytes on the bus to start a transfer: address and control byte. */
+#define SSD1306_TRANSFER_COST 2u
+/** Bytes on the bus to set a column/page window. */
+#define SSD1306_WINDOW_COST (SSD1306_TRANSFER_COST + 6u)
+/** Bytes of the page addressing mode commands to set the page and column. */
+#define SSD1306_PAGE_COMMAND_SIZE 3u
+/** Number of columns of the SSD1306 GDDRAM. */
+#define SSD1306_GDDRAM_WIDTH 128u
+/** Unchanged bytes worth sending to avoid starting a new run in a page. */
+#define SSD1306_DIFF_MAX_GAP (2u * SSD1306_TRANSFER_COST + 3u)
+
+#ifdef SSD1306_STATS
+/** Starts measuring the time spent in the transport. */
+#define SSD1306_STATS_START(DRIVER)                                            \
+    uint32_t _stats_start = (DRIVER)->clock ? (DRIVER)->clock() : 0
+/** Adds the time elapsed since SSD1306_STATS_START to the counters. */
+#define SSD1306_STATS_STOP(DRIVER)                                             \
+    _ssd1306_stats_time((DRIVER), _stats_start)
+/** Counts a transfer of LEN bytes. */
+#define SSD1306_STATS_COUNT(DRIVER, TYPE, LEN)                                 \
+    _ssd1306_stats_count((DRIVER), (TYPE), (LEN))
+/** Counts one more transfer when a payload is split by the I2C fallback. */
+#define SSD1306_STATS_SPLIT(DRIVER) ((DRIVER)->stats.transactions++)
+#else
+#define SSD1306_STATS_START(DRIVER)
+#define SSD1306_STATS_STOP(DRIVER)
+#define SSD1306_STATS_COUNT(DRIVER, TYPE, LEN)
+#define SSD1306_STATS_SPLIT(DRIVER) ((void)(DRIVER))
+#endif
+
 /**
  * @brief SSD1306 control byte.
  */
 enum ssd1306_control_byte {
     CONTROL_BYTE_COMMAND,
     DUMMY_BYTE_00 = 0x00,
+    DUMMY_BYTE_01 = 0x01,
     CONTROL_BYTE_DATA = 0x40,
     DUMMY_BYTE_FF = 0xFF
 };
 
 /**
- * @brief Writes to the SSD1306 chip using a ssd1306_t struct.
+ * @brief Returns the I2C control byte for a transfer type.
+ * @param type Command or data transfer.
+ */
+static inline uint8_t _ssd1306_control_byte(enum ssd1306_transfer_type type)
+{
+    return type == SSD1306_DATA_TRANSFER ? CONTROL_BYTE_DATA
+                                         : CONTROL_BYTE_COMMAND;
+}
+
+/**
+ * @brief Writes a burst of bytes with i2c_write, copying them after the
+ *        control byte into a buffer and splitting them into chunks that fit
+ *        in it.
+ * @param driver Pointer to a ssd1306 struct.
+ * @param buffer Buffer for the control byte and a chunk.
+ * @param size Buffer size.
+ * @param control Control byte.
+ * @param src Pointer to data source.
+ * @param len Number of bytes to write.
+ */
+static void _ssd1306_i2c_write_chunks(struct ssd1306_driver *driver,
+                                      uint8_t *buffer, uint16_t size,
+                                      uint8_t control, const uint8_t *src,
+                                      uint16_t len)
+{
+    buffer[0] = control;
+    while (len) {
+        uint16_t n = len < size - 1u ? len : size - 1u;
+
+        memcpy(buffer + 1, src, n);
+        driver->i2c_write(driver->i2c_address, buffer, n + 1u);
+        src += n;
+        len -= n;
+        if (len)
+            SSD1306_STATS_SPLIT(driver);
+    }
+}
+
+/**
+ * @brief Writes a burst of bytes with i2c_write through a
+ *        SSD1306_I2C_BOUNCE_SIZE byte buffer on the stack.
+ * @param driver Pointer to a ssd1306 struct.
+ * @param control Control byte.
+ * @param src Pointer to data source.
+ * @param len Number of bytes to write.
+ */
+static void _ssd1306_i2c_write_bounce(struct ssd1306_driver *driver,
+                                      uint8_t control, const uint8_t *src,
+                                      uint16_t len)
+{
+    uint8_t buffer[1u + SSD1306_I2C_BOUNCE_SIZE];
+
+    _ssd1306_i2c_write_chunks(driver, buffer, sizeof(buffer), control, src,
+                              len);
+}
+
+/**
+ * @brief Writes a burst of bytes using the I2C interface. The control byte is
+ *        sent as a separate header segment when i2c_writev is available.
+ *        Otherwise the payload is copied after the control byte into the
+ *        i2c_buffer of the driver, or into a SSD1306_I2C_BOUNCE_SIZE byte
+ *        buffer on the stack, and sent in chunks that fit in it.
+ * @param driver Pointer to a ssd1306 struct.
+ * @param type Command or data transfer.
+ * @param src Pointer to data source.
+ * @param len Number of bytes to write.
+ */
+static void _ssd1306_i2c_write(struct ssd1306_driver *driver,
+                               enum ssd1306_transfer_type type,
+                               const uint8_t *src, uint16_t len)
+{
+    uint8_t control = _ssd1306_control_byte(type);
+
+    if (driver->i2c_writev) {
+        struct ssd1306_iovec iov[] = {{&control, 1u}, {src, len}};
+        driver->i2c_writev(driver->i2c_address, iov, 2u);
+    } else if (driver->i2c_buffer && driver->i2c_buffer_size > 1u) {
+        _ssd1306_i2c_write_chunks(driver, driver->i2c_buffer,
+                                  driver->i2c_buffer_size, control, src, len);
+    } else {
+        _ssd1306_i2c_write_bounce(driver, control, src, len);
+    }
+}
+
+/**
+ * @brief Writes a burst of bytes held in a writable buffer with i2c_write,
+ *        without copying it. The byte before the burst is replaced with the
+ *        control byte during the transfer and restored afterwards. A burst
+ *        that starts the buffer sends its first byte through the bounce
+ *        buffer, unless the whole burst fits in it.
+ * @param driver Pointer to a ssd1306 struct.
+ * @param type Command or data transfer.
+ * @param src Pointer to data source, inside the buffer.
+ * @param len Number of bytes to write.
+ * @param base Pointer to the first byte of the buffer.
+ */
+static void _ssd1306_i2c_write_in_place(struct ssd1306_driver *driver,
+                                        enum ssd1306_transfer_type type,
+                                        uint8_t *src, uint16_t len,
+                                        const uint8_t *base)
+{
+    uint8_t saved;
+
+    if (src == base) {
+        uint16_t n = len <= SSD1306_I2C_BOUNCE_SIZE ? len : 1u;
+
+        _ssd1306_i2c_write(driver, type, src, n);
+        src += n;
+        len -= n;
+        if (!len)
+            return;
+        SSD1306_STATS_SPLIT(driver);
+    }
+
+    saved = src[-1];
+    src[-1] = _ssd1306_control_byte(type);
+    driver->i2c_write(driver->i2c_address, src - 1, len + 1u);
+    src[-1] = saved;
+}
+
+/**
+ * @brief Starts a non-blocking I2C write. The segments are stored in the
+ *        transfer, so they remain valid until the transfer is completed.
+ * @param driver Pointer to a ssd1306 struct.
+ * @param t Pointer to the transfer.
+ */
+static void _ssd1306_i2c_write_async(struct ssd1306_driver *driver,
+                                     struct ssd1306_transfer *t)
+{
+    t->header = _ssd1306_control_byte(t->type);
+    t->iov[0].base = &t->header;
+    t->iov[0].length = 1u;
+    t->iov[1].base = t->src;
+    t->iov[1].length = t->length;
+    driver->i2c_writev_async(driver->i2c_address, t->iov, 2u);
+}
+
+/**
+ * @brief Writes a burst of bytes using the 4-wire SPI interface. The D/C pin
+ *        selects between commands and data.
  * @param driver Pointer to a ssd1306 struct.
+ * @param type Command or data transfer.
  * @param src Pointer to data source.
  * @param len Number of bytes to write.
  */
-static inline void _ssd1306_write(struct ssd1306_driver *driver, uint8_t *src,
-                                  uint16_t len)
+static void _ssd1306_spi_write(struct ssd1306_driver *driver,
+                               enum ssd1306_transfer_type type,
+                               const uint8_t *src, uint16_t len)
+{
+    driver->spi_set_dc(type == SSD1306_DATA_TRANSFER);
+    driver->spi_write(src, len);
+}
+
+/**
+ * @brief Starts a non-blocking SPI write.
+ * @param driver Pointer to a ssd1306 struct.
+ * @param t Pointer to the transfer.
+ */
+static void _ssd1306_spi_write_async(struct ssd1306_driver *driver,
+                                     struct ssd1306_transfer *t)
 {
-    driver->i2c_write(driver->i2c_address, src, len);
+    driver->spi_set_dc(t->type == SSD1306_DATA_TRANSFER);
+    driver->spi_write_async(t->src, t->length);
+}
+
+const struct ssd1306_transport ssd1306_i2c_transport = {
+    .write = _ssd1306_i2c_write, .write_async = _ssd1306_i2c_write_async};
+
+const struct ssd1306_transport ssd1306_spi_transport = {
+    .write = _ssd1306_spi_write, .write_async = _ssd1306_spi_write_async};
+
+/**
+ * @brief Returns the transport used by a driver (I2C if none is set).
+ * @param driver Pointer to a ssd1306 struct.
+ */
+static inline const struct ssd1306_transport *
+_ssd1306_transport(struct ssd1306_driver *driver)
+{
+    return driver->transport ? driver->transport : &ssd1306_i2c_transport;
+}
+
+#ifdef SSD1306_STATS
+/**
+ * @brief Counts a transfer.
+ * @param driver Pointer to a ssd1306 struct.
+ * @param type Command or data transfer.
+ * @param len Number of bytes.
+ */
+static void _ssd1306_stats_count(struct ssd1306_driver *driver,
+                                 enum ssd1306_transfer_type type,
+                                 uint16_t len)
+{
+    struct ssd1306_stats *stats = &driver->stats;
+
+    stats->transactions++;
+    if (type == SSD1306_DATA_TRANSFER)
+        stats->data_bytes += len;
+    else
+        stats->command_bytes += len;
+}
+
+/**
+ * @brief Adds the time elapsed since a timestamp to the counters.
+ * @param driver Pointer to a ssd1306 struct.
+ * @param start Timestamp returned by the clock function.
+ */
+static void _ssd1306_stats_time(struct ssd1306_driver *driver, uint32_t start)
+{
+    if (driver->clock)
+        driver->stats.time += driver->clock() - start;
+}
+#endif
+
+/**
+ * @brief Writes a burst of bytes with the driver transport and returns when
+ *        it has been sent. When only i2c_write is available and the bytes are
+ *        held in a writable buffer, they are sent in place.
+ * @param driver Pointer to a ssd1306 struct.
+ * @param type Command or data transfer.
+ * @param src Pointer to data source.
+ * @param len Number of bytes to write.
+ * @param base Pointer to the writable buffer holding the bytes, or NULL.
+ */
+static void _ssd1306_transport_write(struct ssd1306_driver *driver,
+                                     enum ssd1306_transfer_type type,
+                                     const uint8_t *src, uint16_t len,
+                                     uint8_t *base)
+{
+    const struct ssd1306_transport *transport = _ssd1306_transport(driver);
+
+    SSD1306_STATS_COUNT(driver, type, len);
+    if (base && transport == &ssd1306_i2c_transport && !driver->i2c_writev)
+        _ssd1306_i2c_write_in_place(driver, type, base + (src - base), len,
+                                    base);
+    else
+        transport->write(driver, type, src, len);
+}
+
+/**
+ * @brief Calls the driver yield function, if any.
+ * @param driver Pointer to a ssd1306 struct.
+ */
+static inline void _ssd1306_yield(struct ssd1306_driver *driver)
+{
+    if (driver->yield)
+        driver->yield();
+}
+
+/**
+ * @brief Starts the transfer at the tail of the queue.
+ * @param driver Pointer to a ssd1306 struct.
+ */
+static inline void _ssd1306_start(struct ssd1306_driver *driver)
+{
+    struct ssd1306_transfer *t =
+        &driver->async->queue[driver->async->tail %
+                              SSD1306_ASYNC_QUEUE_LENGTH];
+    _ssd1306_transport(driver)->write_async(driver, t);
+}
+
+/**
+ * @brief Queues a transfer, waiting for a free slot if the queue is full.
+ * @param driver Pointer to a ssd1306 struct.
+ * @param type Command or data transfer.
+ * @param src Pointer to data source.
+ * @param len Number of bytes to write.
+ * @param copy If not 0, the data is copied into the queue.
+ */
+static void _ssd1306_submit(struct ssd1306_driver *driver,
+                            enum ssd1306_transfer_type type,
+                            const uint8_t *src, uint16_t len, uint8_t copy)
+{
+    struct ssd1306_async *q = driver->async;
+
+    SSD1306_STATS_COUNT(driver, type, len);
+    while ((uint8_t)(q->head - q->tail) >= SSD1306_ASYNC_QUEUE_LENGTH) {
+        _ssd1306_yield(driver);
+    }
+
+    struct ssd1306_transfer *t =
+        &q->queue[q->head % SSD1306_ASYNC_QUEUE_LENGTH];
+    if (copy) {
+        memcpy(t->buffer, src, len);
+        t->src = t->buffer;
+    } else {
+        t->src = src;
+    }
+    t->length = len;
+    t->type = type;
+    /* The completion interrupt reads the transfer once head is updated. */
+    SSD1306_MEMORY_BARRIER();
+    q->head++;
+
+    if (!q->busy) {
+        q->busy = 1;
+        _ssd1306_start(driver);
+    }
+}
+
+/**
+ * @brief Writes to the SSD1306 chip using a ssd1306_t struct. The source can
+ *        be reused as soon as this function returns.
+ * @param driver Pointer to a ssd1306 struct.
+ * @param type Command or data transfer.
+ * @param src Pointer to data source.
+ * @param len Number of bytes to write.
+ * @param base Pointer to the writable buffer holding the source, or NULL.
+ */
+static inline void _ssd1306_write(struct ssd1306_driver *driver,
+                                  enum ssd1306_transfer_type type,
+                                  const uint8_t *src, uint16_t len,
+                                  uint8_t *base)
+{
+    SSD1306_STATS_START(driver);
+
+    if (!driver->async) {
+        _ssd1306_transport_write(driver, type, src, len, base);
+    } else if (len <= SSD1306_ASYNC_INLINE_SIZE) {
+        _ssd1306_submit(driver, type, src, len, 1);
+    } else {
+        _ssd1306_submit(driver, type, src, len, 0);
+        ssd1306_async_wait_buffer(driver, src, len);
+    }
+
+    SSD1306_STATS_STOP(driver);
+}
+
+/**
+ * @brief Sends the commands collected in the batch buffer, if any.
+ * @param driver Pointer to a ssd1306 struct.
+ */
+static void _ssd1306_flush_batch(struct ssd1306_driver *driver)
+{
+    if (driver->batch && driver->batch_length) {
+        _ssd1306_write(driver, SSD1306_COMMAND_TRANSFER, driver->batch,
+                       driver->batch_length, NULL);
+        driver->batch_length = 0;
+    }
+}
+
+/**
+ * @brief Writes a command sequence, or appends it to the batch buffer when a
+ *        batch has been started.
+ * @param driver Pointer to a ssd1306 struct.
+ * @param cmd Pointer to the commands.
+ * @param len Number of bytes to write.
+ */
+static void _ssd1306_write_commands(struct ssd1306_driver *driver,
+                                    const uint8_t *cmd, uint16_t len)
+{
+    if (!driver->batch) {
+        _ssd1306_write(driver, SSD1306_COMMAND_TRANSFER, cmd, len, NULL);
+        return;
+    }
+
+    if (driver->batch_length + len > driver->batch_size)
+        _ssd1306_flush_batch(driver);
+
+    if (len > driver->batch_size) {
+        _ssd1306_write(driver, SSD1306_COMMAND_TRANSFER, cmd, len, NULL);
+        return;
+    }
+
+    memcpy(driver->batch + driver->batch_length, cmd, len);
+    driver->batch_length += len;
+}
+
+/**
+ * @brief Returns the length of the transfers a payload is split into. When
+ *        the payload exceeds the maximum transfer size, it is split into
+ *        chunks of the same length, so that the last transfer is not much
+ *        shorter than the others.
+ * @param driver Pointer to a ssd1306 struct.
+ * @param len Payload length.
+ */
+static inline uint16_t _ssd1306_chunk_size(struct ssd1306_driver *driver,
+                                           uint16_t len)
+{
+    uint16_t max = driver->max_transfer;
+
+    if (!max || len <= max)
+        return len;
+
+    uint16_t transfers = (len + max - 1u) / max;
+    return (len + transfers - 1u) / transfers;
+}
+
+/**
+ * @brief Writes display data after sending the pending batched commands. In
+ *        asynchronous mode the data is queued without being copied, so the
+ *        caller must not modify it until ssd1306_async_buffer_busy returns 0.
+ * @param driver Pointer to a ssd1306 struct.
+ * @param data Pointer to the display data.
+ * @param len Number of bytes to write.
+ * @param base Pointer to the writable buffer holding the data, e.g. the
+ *        bitmap, or NULL if the data can't be modified.
+ */
+static void _ssd1306_write_data(struct ssd1306_driver *driver,
+                                const uint8_t *data, uint16_t len,
+                                uint8_t *base)
+{
+    uint16_t n = _ssd1306_chunk_size(driver, len);
+
+    _ssd1306_flush_batch(driver);
+    SSD1306_STATS_START(driver);
+    while (len) {
+        if (n > len)
+            n = len;
+        if (driver->async) {
+            _ssd1306_submit(driver, SSD1306_DATA_TRANSFER, data, n, 0);
+        } else {
+            _ssd1306_transport_write(driver, SSD1306_DATA_TRANSFER, data, n,
+                                     base);
+        }
+        data += n;
+        len -= n;
+    }
+    SSD1306_STATS_STOP(driver);
+}
+
+/**
+ * @brief Returns the number of columns gathered in each transfer in vertical
+ *        addressing mode.
+ * @param driver Pointer to a ssd1306 struct.
+ * @param pages Window height in pages.
+ */
+static inline uint8_t _ssd1306_column_chunk(struct ssd1306_driver *driver,
+                                            uint8_t pages)
+{
+    uint16_t size = SSD1306_COLUMN_BUFFER_SIZE;
+
+    if (driver->max_transfer && driver->max_transfer < size)
+        size = driver->max_transfer;
+    return size >= pages ? size / pages : 1u;
+}
+
+/**
+ * @brief Computes the number of bytes on the bus needed to send a payload,
+ *        including the transfers it is split into.
+ * @param driver Pointer to a ssd1306 struct.
+ * @param len Payload length.
+ */
+static inline uint16_t _ssd1306_data_cost(struct ssd1306_driver *driver,
+                                          uint16_t len)
+{
+    uint16_t max = driver->max_transfer;
+    uint16_t transfers = (max && len > max) ? (len + max - 1u) / max : 1u;
+
+    return len + transfers * SSD1306_TRANSFER_COST;
+}
+
+/**
+ * @brief Computes the number of bytes on the bus needed to update a window.
+ * @param driver Pointer to a ssd1306 struct.
+ * @param bm Pointer to a ssd1306_bitmap struct.
+ * @param columns Window width in columns.
+ * @param pages Window height in pages.
+ */
+static inline uint16_t _ssd1306_window_cost(struct ssd1306_driver *driver,
+                                            struct ssd1306_bitmap *bm,
+                                            uint8_t columns, uint8_t pages)
+{
+    uint8_t chunk;
+
+    switch (driver->addressing_mode) {
+    case PAGE_ADDRESSING_MODE:
+        return pages * (SSD1306_TRANSFER_COST + SSD1306_PAGE_COMMAND_SIZE +
+                        _ssd1306_data_cost(driver, columns));
+    case VERTICAL_ADDRESSING_MODE:
+        chunk = _ssd1306_column_chunk(driver, pages);
+        return SSD1306_WINDOW_COST + pages * columns +
+               (columns + chunk - 1u) / chunk * SSD1306_TRANSFER_COST;
+    default:
+        if (columns == bm->width)
+            return SSD1306_WINDOW_COST +
+                   _ssd1306_data_cost(driver, pages * columns);
+        return SSD1306_WINDOW_COST +
+               pages * _ssd1306_data_cost(driver, columns);
+    }
+}
+
+/**
+ * @brief Sends a window of display data in vertical addressing mode. The
+ *        bitmap holds the data page by page, so whole columns are gathered
+ *        into a buffer and sent together.
+ * @param driver Pointer to a ssd1306 struct.
+ * @param bm Pointer to a ssd1306_bitmap struct.
+ * @param data Pointer to the first byte of the window.
+ * @param columns Window width in columns.
+ * @param pages Window height in pages.
+ */
+static void _ssd1306_write_columns(struct ssd1306_driver *driver,
+                                   struct ssd1306_bitmap *bm,
+                                   const uint8_t *data, uint8_t columns,
+                                   uint8_t pages)
+{
+    /* The first byte is left free for the I2C control byte. */
+    uint8_t buffer[1u + (SSD1306_COLUMN_BUFFER_SIZE > SSD1306_MAX_PAGES
+                             ? SSD1306_COLUMN_BUFFER_SIZE
+                             : SSD1306_MAX_PAGES)];
+    uint8_t chunk = _ssd1306_column_chunk(driver, pages);
+
+    _ssd1306_flush_batch(driver);
+    for (uint8_t c = 0; c < columns; c += chunk) {
+        uint8_t n = columns - c < chunk ? columns - c : chunk;
+        uint16_t len = 0;
+
+        for (uint8_t k = 0; k < n; k++) {
+            const uint8_t *src = data + c + k;
+
+            for (uint8_t p = 0; p < pages; p++) {
+                buffer[1u + len++] = *src;
+                src += bm->width;
+            }
+        }
+        _ssd1306_write(driver, SSD1306_DATA_TRANSFER, buffer + 1, len, buffer);
+    }
 }
 
 void ssd1306_set_contrast(struct ssd1306_driver *driver, uint8_t contrast)
 {
-    uint8_t cmd[] = {CONTROL_BYTE_COMMAND, SSD1306_COMMAND_SET_CONTRAST_CONTROL,
-                     contrast};
-    _ssd1306_write(driver, cmd, 3u);
+    uint8_t cmd[] = {SSD1306_COMMAND_SET_CONTRAST_CONTROL, contrast};
+    _ssd1306_write_commands(driver, cmd, sizeof(cmd));
 }
 
 void ssd1306_set_display_on(struct ssd1306_driver *driver)
 {
-    uint8_t cmd[] = {CONTROL_BYTE_COMMAND, SSD1306_COMMAND_CHARGE_PUMP_SETTING,
-                     ENABLE_CHARGE_PUMP, SSD1306_COMMAND_SET_DISPLAY_ON};
-    _ssd1306_write(driver, cmd, 4u);
+    uint8_t cmd[] = {SSD1306_COMMAND_CHARGE_PUMP_SETTING, ENABLE_CHARGE_PUMP,
+                     SSD1306_COMMAND_SET_DISPLAY_ON};
+    _ssd1306_write_commands(driver, cmd, sizeof(cmd));
 }
 
 void ssd1306_set_display_off(struct ssd1306_driver *driver)
 {
-    uint8_t cmd[] = {CONTROL_BYTE_COMMAND, SSD1306_COMMAND_CHARGE_PUMP_SETTING,
-                     DISABLE_CHARGE_PUMP, SSD1306_COMMAND_SET_DISPLAY_OFF};
-    _ssd1306_write(driver, cmd, 4u);
+    uint8_t cmd[] = {SSD1306_COMMAND_CHARGE_PUMP_SETTING, DISABLE_CHARGE_PUMP,
+                     SSD1306_COMMAND_SET_DISPLAY_OFF};
+    _ssd1306_write_commands(driver, cmd, sizeof(cmd));
 }
 
 void ssd1306_set_normal_display(struct ssd1306_driver *driver)
 {
-    uint8_t cmd[] = {CONTROL_BYTE_COMMAND, SSD1306_COMMAND_SET_NORMAL_DISPLAY};
-    _ssd1306_write(driver, cmd, 2u);
+    uint8_t cmd[] = {SSD1306_COMMAND_SET_NORMAL_DISPLAY};
+    _ssd1306_write_commands(driver, cmd, sizeof(cmd));
 }
 
 void ssd1306_set_inverse_display(struct ssd1306_driver *driver)
 {
-    uint8_t cmd[] = {CONTROL_BYTE_COMMAND, SSD1306_COMMAND_SET_INVERSE_DISPLAY};
-    _ssd1306_write(driver, cmd, 2u);
+    uint8_t cmd[] = {SSD1306_COMMAND_SET_INVERSE_DISPLAY};
+    _ssd1306_write_commands(driver, cmd, sizeof(cmd));
 }
 
 void ssd1306_set_entire_display_on(struct ssd1306_driver *driver)
 {
-    uint8_t cmd[] = {CONTROL_BYTE_COMMAND, SSD1306_COMMAND_ENTIRE_DISPLAY_ON};
-    _ssd1306_write(driver, cmd, 2u);
+    uint8_t cmd[] = {SSD1306_COMMAND_ENTIRE_DISPLAY_ON};
+    _ssd1306_write_commands(driver, cmd, sizeof(cmd));
 }
 
 void ssd1306_resume_to_ram_content(struct ssd1306_driver *driver)
 {
-    uint8_t cmd[] = {CONTROL_BYTE_COMMAND,
-                     SSD1306_COMMAND_RESUME_TO_RAM_CONTENT};
-    _ssd1306_write(driver, cmd, 2u);
+    uint8_t cmd[] = {SSD1306_COMMAND_RESUME_TO_RAM_CONTENT};
+    _ssd1306_write_commands(driver, cmd, sizeof(cmd));
 }
 
 void ssd1306_activate_scroll(struct ssd1306_driver *driver,
                              struct ssd1306_scrolling_config config)
 {
     if (config.mode >= VERTICAL_AND_RIGHT_SCROLL) {
-        uint8_t cmd[] = {CONTROL_BYTE_COMMAND,
-                         SSD1306_COMMAND_SET_VERTICAL_SCROLL_AREA,
+        uint8_t cmd[] = {SSD1306_COMMAND_SET_VERTICAL_SCROLL_AREA,
                          config.start_row,
                          config.rows,
                          config.mode,
@@ -94,10 +631,9 @@ void ssd1306_activate_scroll(struct ssd1306_driver *driver,
                          config.end_page,
                          config.vertical_offset,
                          SSD1306_COMMAND_ACTIVATE_SCROLL};
-        _ssd1306_write(driver, cmd, 11u);
+        _ssd1306_write_commands(driver, cmd, sizeof(cmd));
     } else {
-        uint8_t cmd[] = {CONTROL_BYTE_COMMAND,
-                         config.mode,
+        uint8_t cmd[] = {config.mode,
                          DUMMY_BYTE_00,
                          config.start_page,
                          config.rate,
@@ -105,14 +641,44 @@ void ssd1306_activate_scroll(struct ssd1306_driver *driver,
                          DUMMY_BYTE_00,
                          DUMMY_BYTE_FF,
                          SSD1306_COMMAND_ACTIVATE_SCROLL};
-        _ssd1306_write(driver, cmd, 9u);
+        _ssd1306_write_commands(driver, cmd, sizeof(cmd));
     }
 }
 
 void ssd1306_deactivate_scroll(struct ssd1306_driver *driver)
 {
-    uint8_t cmd[] = {CONTROL_BYTE_COMMAND, SSD1306_COMMAND_DEACTIVATE_SCROLL};
-    _ssd1306_write(driver, cmd, 2u);
+    uint8_t cmd[] = {SSD1306_COMMAND_DEACTIVATE_SCROLL};
+    _ssd1306_write_commands(driver, cmd, sizeof(cmd));
+}
+
+void ssd1306_scroll_one_column(struct ssd1306_driver *driver,
+                               struct ssd1306_scrolling_config config)
+{
+    uint8_t left = config.mode == LEFT_HORIZONTAL_SCROLL ||
+                   config.mode == VERTICAL_AND_LEFT_SCROLL;
+    uint8_t cmd[] = {left ? SSD1306_COMMAND_LEFT_ONE_COLUMN_SCROLL
+                          : SSD1306_COMMAND_RIGHT_ONE_COLUMN_SCROLL,
+                     DUMMY_BYTE_00,
+                     config.start_page,
+                     DUMMY_BYTE_01,
+                     config.end_page,
+                     DUMMY_BYTE_00,
+                     DUMMY_BYTE_FF};
+    _ssd1306_write_commands(driver, cmd, sizeof(cmd));
+}
+
+void ssd1306_set_start_line(struct ssd1306_driver *driver, uint8_t line)
+{
+    uint8_t cmd[] = {SSD1306_COMMAND_SET_START_LINE(line)};
+    _ssd1306_write_commands(driver, cmd, sizeof(cmd));
+}
+
+void ssd1306_set_addressing_mode(struct ssd1306_driver *driver,
+                                 enum ssd1306_addressing_mode mode)
+{
+    uint8_t cmd[] = {SSD1306_COMMAND_SET_MEMORY_ADDRESSING_MODE, mode};
+    _ssd1306_write_commands(driver, cmd, sizeof(cmd));
+    driver->addressing_mode = mode;
 }
 
 void ssd1306_configure(struct ssd1306_driver *driver,
@@ -120,7 +686,6 @@ void ssd1306_configure(struct ssd1306_driver *driver,
 {
     ssd1306_set_display_off(driver);
     uint8_t cmd[] = {
-        CONTROL_BYTE_COMMAND,
         SSD1306_COMMAND_SET_MUX_RATIO,
         config.mux_ratio,
         SSD1306_COMMAND_SET_DISPLAY_OFFSET,
@@ -143,7 +708,7 @@ void ssd1306_configure(struct ssd1306_driver *driver,
         SSD1306_COMMAND_SET_MEMORY_ADDRESSING_MODE,
         config.addressing_mode,
         SSD1306_PA_LOWER_START_COLUMN(config.start_column),
-        SSD1306_PA_HIGHER_START_COLUMN(config.start_column),
+        SSD1306_PA_HIGHER_START_COLUMN(config.start_column >> 4u),
         SSD1306_PA_START_PAGE(config.start_page),
         SSD1306_COMMAND_SET_COLUMN_ADDRESS,
         config.start_column,
@@ -151,7 +716,8 @@ void ssd1306_configure(struct ssd1306_driver *driver,
         SSD1306_COMMAND_SET_PAGE_ADDRESS,
         config.start_page,
         config.end_page};
-    _ssd1306_write(driver, cmd, 31u);
+    _ssd1306_write_commands(driver, cmd, sizeof(cmd));
+    driver->addressing_mode = config.addressing_mode;
 }
 
 struct ssd1306_config ssd1306_get_default_config(void)
@@ -182,6 +748,398 @@ struct ssd1306_config ssd1306_get_default_config(void)
 void ssd1306_update_gddram(struct ssd1306_driver *driver, uint8_t *bitmap,
                            uint16_t lenght)
 {
-    bitmap[0] = CONTROL_BYTE_DATA;
-    _ssd1306_write(driver, bitmap, lenght);
+    uint16_t pages;
+
+    /* Only the reserved byte, nothing to send. */
+    if (lenght < 2u)
+        return;
+
+    pages = (lenght - 1u) / SSD1306_GDDRAM_WIDTH;
+    if (!pages || pages > SSD1306_MAX_PAGES ||
+        (lenght - 1u) % SSD1306_GDDRAM_WIDTH) {
+        _ssd1306_write_data(driver, bitmap + 1, lenght - 1u, bitmap);
+        return;
+    }
+
+    /* The length includes the reserved byte, so the pixels start at
+       bitmap[1]. */
+    struct ssd1306_bitmap bm = {
+        .width = SSD1306_GDDRAM_WIDTH,
+        .height = pages << 3u,
+        .length = lenght,
+        .data = bitmap,
+    };
+    ssd1306_update_gddram_pages(driver, &bm, 0, pages - 1u);
+}
+
+void ssd1306_write_gddram(struct ssd1306_driver *driver, const uint8_t *data,
+                          uint16_t length)
+{
+    _ssd1306_write_data(driver, data, length, NULL);
+}
+
+void ssd1306_update_gddram_window(struct ssd1306_driver *driver,
+                                  struct ssd1306_bitmap *bm,
+                                  uint8_t start_column, uint8_t end_column,
+                                  uint8_t start_page, uint8_t end_page)
+{
+    uint8_t columns = end_column - start_column + 1u;
+    const uint8_t *data = ssd1306_bitmap_pixels(bm) + start_column +
+                          (start_page - bm->band_page) * bm->width;
+
+    if (driver->addressing_mode == PAGE_ADDRESSING_MODE) {
+        for (uint8_t p = start_page; p <= end_page; p++) {
+            uint8_t cmd[] = {
+                SSD1306_PA_START_PAGE(p),
+                SSD1306_PA_LOWER_START_COLUMN(start_column),
+                SSD1306_PA_HIGHER_START_COLUMN(start_column >> 4u)};
+            _ssd1306_write_commands(driver, cmd, sizeof(cmd));
+            _ssd1306_write_data(driver, data, columns, bm->data);
+            data += bm->width;
+        }
+        return;
+    }
+
+    uint8_t cmd[] = {SSD1306_COMMAND_SET_COLUMN_ADDRESS,
+                     start_column,
+                     end_column,
+                     SSD1306_COMMAND_SET_PAGE_ADDRESS,
+                     start_page,
+                     end_page};
+    _ssd1306_write_commands(driver, cmd, sizeof(cmd));
+
+    if (driver->addressing_mode == VERTICAL_ADDRESSING_MODE) {
+        _ssd1306_write_columns(driver, bm, data, columns,
+                               end_page - start_page + 1u);
+        return;
+    }
+
+    if (columns == bm->width) {
+        _ssd1306_write_data(driver, data,
+                            (end_page - start_page + 1u) * bm->width,
+                            bm->data);
+        return;
+    }
+
+    for (uint8_t p = start_page; p <= end_page; p++) {
+        _ssd1306_write_data(driver, data, columns, bm->data);
+        data += bm->width;
+    }
+}
+
+void ssd1306_update_gddram_pages(struct ssd1306_driver *driver,
+                                 struct ssd1306_bitmap *bm, uint8_t start_page,
+                                 uint8_t end_page)
+{
+    ssd1306_update_gddram_window(driver, bm, 0, bm->width - 1u, start_page,
+                                 end_page);
+}
+
+void ssd1306_update_dirty_gddram(struct ssd1306_driver *driver,
+                                 struct ssd1306_bitmap *bm)
+{
+    uint8_t pages = bm->height >> 3u;
+    uint8_t start = 0;
+    uint8_t end = 0;
+    uint8_t first_page = 0;
+    uint8_t last_page = 0;
+
+    for (uint8_t p = 0; p < pages; p++) {
+        if (bm->dirty_end[p] == 0)
+            continue;
+
+        uint8_t s = bm->dirty_start[p];
+        uint8_t e = bm->dirty_end[p];
+
+        if (end) {
+            uint8_t ms = s < start ? s : start;
+            uint8_t me = e > end ? e : end;
+            uint16_t separate =
+                _ssd1306_window_cost(driver, bm, end - start,
+                                     last_page - first_page + 1u) +
+                _ssd1306_window_cost(driver, bm, e - s, 1u);
+            uint16_t merged =
+                _ssd1306_window_cost(driver, bm, me - ms, p - first_page + 1u);
+
+            if (merged <= separate) {
+                start = ms;
+                end = me;
+                last_page = p;
+                continue;
+            }
+
+            ssd1306_update_gddram_window(driver, bm, start, end - 1u,
+                                         first_page, last_page);
+        }
+
+        start = s;
+        end = e;
+        first_page = p;
+        last_page = p;
+    }
+
+    if (end)
+        ssd1306_update_gddram_window(driver, bm, start, end - 1u, first_page,
+                                     last_page);
+
+    ssd1306_bitmap_reset_dirty(bm);
+}
+
+/**
+ * @brief Returns the index of the first byte that differs between two arrays,
+ *        comparing one word at a time.
+ * @param a Pointer to the first array.
+ * @param b Pointer to the second array.
+ * @param i Start index.
+ * @param n Arrays length.
+ * @return Index of the first different byte, or n if there is none.
+ */
+static uint16_t _ssd1306_next_diff(const uint8_t *a, const uint8_t *b,
+                                   uint16_t i, uint16_t n)
+{
+    uint32_t wa;
+    uint32_t wb;
+
+    while (i + sizeof(uint32_t) <= n) {
+        memcpy(&wa, a + i, sizeof(uint32_t));
+        memcpy(&wb, b + i, sizeof(uint32_t));
+        if (wa != wb)
+            break;
+        i += sizeof(uint32_t);
+    }
+    while (i < n && a[i] == b[i]) {
+        i++;
+    }
+    return i;
+}
+
+/**
+ * @brief Walks the runs of bytes that differ from the shadow copy and computes
+ *        the bytes on the bus needed to send them. Each run is preceded by the
+ *        cheapest address commands for the addressing mode given the GDDRAM
+ *        pointer left by the previous run. In vertical mode, each run is sent
+ *        through a window one page tall, so that its bytes are consecutive.
+ * @param driver Pointer to a ssd1306 struct.
+ * @param bm Pointer to a ssd1306_bitmap struct.
+ * @param shadow Pointer to a ssd1306_shadow struct.
+ * @param send If not 0, sends the runs and updates the shadow copy.
+ * @return Number of bytes on the bus.
+ */
+static uint16_t _ssd1306_diff(struct ssd1306_driver *driver,
+                              struct ssd1306_bitmap *bm,
+                              struct ssd1306_shadow *shadow, uint8_t send)
+{
+    enum ssd1306_addressing_mode mode = driver->addressing_mode;
+    uint8_t pages = bm->height >> 3u;
+    uint8_t col = 0;
+    uint8_t page = 0;
+    uint8_t window_col = 0;
+    uint8_t window_page = 0;
+    uint8_t known = 0;
+    uint16_t cost = 0;
+
+    for (uint8_t p = 0; p < pages; p++) {
+        uint8_t *data = ssd1306_bitmap_pixels(bm) + p * bm->width;
+        uint8_t *copy = shadow->data + p * bm->width;
+        uint16_t i = _ssd1306_next_diff(data, copy, 0, bm->width);
+
+        while (i < bm->width) {
+            uint16_t start = i;
+            uint16_t end = i + 1u;
+
+            for (;;) {
+                i = _ssd1306_next_diff(data, copy, end, bm->width);
+                if (i == bm->width ||
+                    (uint16_t)(i - end) > SSD1306_DIFF_MAX_GAP)
+                    break;
+                end = i + 1u;
+            }
+
+            uint8_t cmd[6];
+            uint8_t len = 0;
+
+            if (mode == PAGE_ADDRESSING_MODE) {
+                if (!known || page != p)
+                    cmd[len++] = SSD1306_PA_START_PAGE(p);
+                if (!known || col != start) {
+                    cmd[len++] = SSD1306_PA_LOWER_START_COLUMN(start);
+                    cmd[len++] = SSD1306_PA_HIGHER_START_COLUMN(start >> 4u);
+                }
+            } else {
+                if (!known || col != start) {
+                    cmd[len++] = SSD1306_COMMAND_SET_COLUMN_ADDRESS;
+                    cmd[len++] = start;
+                    cmd[len++] = bm->width - 1u;
+                    window_col = start;
+                }
+                if (!known || page != p) {
+                    cmd[len++] = SSD1306_COMMAND_SET_PAGE_ADDRESS;
+                    cmd[len++] = p;
+                    cmd[len++] = mode == VERTICAL_ADDRESSING_MODE ? p
+                                                                  : pages - 1u;
+                    window_page = p;
+                }
+            }
+            if (len) {
+                cost += SSD1306_TRANSFER_COST + len;
+                if (send)
+                    _ssd1306_write_commands(driver, cmd, len);
+            }
+
+            cost += _ssd1306_data_cost(driver, end - start);
+            if (send) {
+                _ssd1306_write_data(driver, data + start, end - start,
+                                    bm->data);
+                memcpy(copy + start, data + start, end - start);
+            }
+
+            known = 1;
+            col = end;
+            page = p;
+            if (end == bm->width && mode == HORIZONTAL_ADDRESSING_MODE) {
+                col = window_col;
+                page = (p + 1u < pages) ? p + 1u : window_page;
+            } else if (end == bm->width && mode == VERTICAL_ADDRESSING_MODE) {
+                col = window_col;
+            }
+        }
+    }
+
+    return cost;
+}
+
+uint16_t ssd1306_update_gddram_diff(struct ssd1306_driver *driver,
+                                    struct ssd1306_bitmap *bm,
+                                    struct ssd1306_shadow *shadow)
+{
+    uint8_t pages = bm->height >> 3u;
+    uint16_t full = _ssd1306_window_cost(driver, bm, bm->width, pages);
+    uint16_t cost = full;
+    uint8_t match = shadow->length == ssd1306_bitmap_size(bm);
+
+    if (shadow->valid && match)
+        cost = _ssd1306_diff(driver, bm, shadow, 0);
+
+    if (cost < full) {
+        _ssd1306_diff(driver, bm, shadow, 1);
+    } else {
+        cost = full;
+        ssd1306_update_gddram_window(driver, bm, 0, bm->width - 1u, 0,
+                                     pages - 1u);
+        if (match)
+            memcpy(shadow->data, ssd1306_bitmap_pixels(bm), shadow->length);
+        shadow->valid = match;
+    }
+
+    ssd1306_bitmap_reset_dirty(bm);
+    shadow->bytes_sent = cost;
+    shadow->bytes_saved = full - cost;
+    return shadow->bytes_saved;
+}
+
+void ssd1306_transfer_complete(struct ssd1306_driver *driver)
+{
+    struct ssd1306_async *q = driver->async;
+
+    q->tail++;
+    if (q->head != q->tail)
+        _ssd1306_start(driver);
+    else
+        q->busy = 0;
+}
+
+uint8_t ssd1306_async_pending(struct ssd1306_driver *driver)
+{
+    if (!driver->async)
+        return 0;
+    return driver->async->head - driver->async->tail;
+}
+
+void ssd1306_async_wait(struct ssd1306_driver *driver)
+{
+    while (ssd1306_async_pending(driver)) {
+        _ssd1306_yield(driver);
+    }
+}
+
+uint8_t ssd1306_async_buffer_busy(struct ssd1306_driver *driver,
+                                  const uint8_t *buffer, uint16_t length)
+{
+    struct ssd1306_async *q = driver->async;
+
+    if (!q)
+        return 0;
+
+    for (uint8_t i = q->tail; i != q->head; i++) {
+        struct ssd1306_transfer *t = &q->queue[i % SSD1306_ASYNC_QUEUE_LENGTH];
+        if (t->src < buffer + length && buffer < t->src + t->length)
+            return 1;
+    }
+    return 0;
+}
+
+void ssd1306_async_wait_buffer(struct ssd1306_driver *driver,
+                               const uint8_t *buffer, uint16_t length)
+{
+    while (ssd1306_async_buffer_busy(driver, buffer, length)) {
+        _ssd1306_yield(driver);
+    }
+}
+
+void ssd1306_begin_batch(struct ssd1306_driver *driver, uint8_t *buffer,
+                         uint16_t size)
+{
+    _ssd1306_flush_batch(driver);
+    driver->batch = buffer;
+    driver->batch_size = size;
+    driver->batch_length = 0;
+}
+
+void ssd1306_end_batch(struct ssd1306_driver *driver)
+{
+    _ssd1306_flush_batch(driver);
+    driver->batch = 0;
+}
+
+struct ssd1306_stats
+ssd1306_stats_snapshot(const struct ssd1306_driver *driver)
+{
+    return driver->stats;
+}
+
+void ssd1306_stats_reset(struct ssd1306_driver *driver)
+{
+    struct ssd1306_stats zero = {0};
+
+    driver->stats = zero;
+}
+
+struct ssd1306_stats ssd1306_stats_delta(struct ssd1306_stats before,
+                                         struct ssd1306_stats after)
+{
+    struct ssd1306_stats delta = {
+        .transactions = after.transactions - before.transactions,
+        .command_bytes = after.command_bytes - before.command_bytes,
+        .data_bytes = after.data_bytes - before.data_bytes,
+        .time = after.time - before.time};
+    return delta;
+}
+
+uint32_t ssd1306_stats_i2c_us(const struct ssd1306_stats *stats,
+                              uint32_t clock_hz)
+{
+    /* Start, address + ACK, control byte + ACK and stop. */
+    uint64_t bits = 2u + 9u + 9u;
+
+    bits = bits * stats->transactions +
+           9u * ((uint64_t)stats->command_bytes + stats->data_bytes);
+    return (uint32_t)(bits * 1000000u / clock_hz);
+}
+
+uint32_t ssd1306_stats_spi_us(const struct ssd1306_stats *stats,
+                              uint32_t clock_hz)
+{
+    uint64_t bits = 8u * ((uint64_t)stats->command_bytes + stats->data_bytes);
+
+    return (uint32_t)(bits * 1000000u / clock_hz);
 }
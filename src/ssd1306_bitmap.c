@@ -0,0 +1,224 @@
+/**
+ * @file ssd1306_bitmap.c
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief This file provides bulk operations on the bitmap data. They work a
+ *        word at a time once the destination is aligned.
+ */
+
+#include "ssd1306/ssd1306_bitmap.h"
+#include <string.h>
+
+/**
+ * @brief Size of a word in bytes.
+ */
+#define SSD1306_WORD_SIZE sizeof(SSD1306_WORD_TYPE)
+
+/**
+ * @brief Number of words of an 8 byte pattern.
+ */
+#define SSD1306_PATTERN_WORDS (8u / SSD1306_WORD_SIZE)
+
+/**
+ * @brief Returns the number of bytes to process before dst is aligned to a
+ *        word.
+ * @param dst Destination pointer.
+ * @param length Number of bytes to process.
+ */
+static inline uint16_t _ssd1306_head(const uint8_t *dst, uint16_t length)
+{
+    uint16_t head = (SSD1306_WORD_SIZE - (uintptr_t)dst % SSD1306_WORD_SIZE) %
+                    SSD1306_WORD_SIZE;
+
+    return head < length ? head : length;
+}
+
+/**
+ * @brief Marks the pages held in the bitmap data as dirty.
+ * @param bm Pointer to a ssd1306_bitmap struct.
+ */
+static inline void _ssd1306_mark_held(struct ssd1306_bitmap *bm)
+{
+    for (uint8_t p = 0; p < ssd1306_bitmap_pages(bm); p++) {
+        ssd1306_bitmap_mark_page(bm, bm->band_page + p, 0, bm->width);
+    }
+}
+
+/**
+ * @brief Sets dst[i] to pattern[i % 8].
+ * @param dst Destination pointer.
+ * @param length Number of bytes.
+ * @param pattern 8 byte pattern.
+ */
+static void _ssd1306_fill(uint8_t *dst, uint16_t length,
+                          const uint8_t *pattern)
+{
+    uint16_t i = _ssd1306_head(dst, length);
+    SSD1306_WORD_TYPE words[SSD1306_PATTERN_WORDS];
+    uint8_t rotated[8];
+
+    for (uint16_t k = 0; k < i; k++) {
+        dst[k] = pattern[k & 7u];
+    }
+
+    for (uint8_t k = 0; k < 8u; k++) {
+        rotated[k] = pattern[(i + k) & 7u];
+    }
+    memcpy(words, rotated, sizeof(words));
+
+    for (uint16_t k = 0; (uint16_t)(length - i) >= SSD1306_WORD_SIZE;
+         i += SSD1306_WORD_SIZE, k++) {
+        memcpy(dst + i, &words[k % SSD1306_PATTERN_WORDS], SSD1306_WORD_SIZE);
+    }
+
+    for (; i < length; i++) {
+        dst[i] = pattern[i & 7u];
+    }
+}
+
+/**
+ * @brief Applies a logical operation to two words.
+ * @param a Destination word.
+ * @param b Source word.
+ * @param op Logical operation.
+ */
+static inline SSD1306_WORD_TYPE _ssd1306_rop(SSD1306_WORD_TYPE a,
+                                             SSD1306_WORD_TYPE b,
+                                             enum ssd1306_raster_op op)
+{
+    switch (op) {
+    case SSD1306_ROP_OR:
+        return a | b;
+    case SSD1306_ROP_AND:
+        return a & b;
+    case SSD1306_ROP_XOR:
+        return a ^ b;
+    default:
+        return b;
+    }
+}
+
+/**
+ * @brief Applies a logical operation between two byte arrays. The operation
+ *        is a constant at every call site, so the switch is resolved when the
+ *        function is inlined.
+ * @param dst Destination pointer.
+ * @param src Source pointer.
+ * @param length Number of bytes.
+ * @param op Logical operation.
+ */
+static inline void _ssd1306_merge(uint8_t *dst, const uint8_t *src,
+                                  uint16_t length, enum ssd1306_raster_op op)
+{
+    uint16_t i = _ssd1306_head(dst, length);
+
+    for (uint16_t k = 0; k < i; k++) {
+        dst[k] = _ssd1306_rop(dst[k], src[k], op);
+    }
+
+    for (; (uint16_t)(length - i) >= SSD1306_WORD_SIZE;
+         i += SSD1306_WORD_SIZE) {
+        SSD1306_WORD_TYPE a;
+        SSD1306_WORD_TYPE b;
+
+        memcpy(&a, dst + i, SSD1306_WORD_SIZE);
+        memcpy(&b, src + i, SSD1306_WORD_SIZE);
+        a = _ssd1306_rop(a, b, op);
+        memcpy(dst + i, &a, SSD1306_WORD_SIZE);
+    }
+
+    for (; i < length; i++) {
+        dst[i] = _ssd1306_rop(dst[i], src[i], op);
+    }
+}
+
+void ssd1306_bitmap_clear(struct ssd1306_bitmap *bm)
+{
+    static const uint8_t zero[8] = {0};
+
+    _ssd1306_fill(ssd1306_bitmap_pixels(bm), ssd1306_bitmap_size(bm), zero);
+    _ssd1306_mark_held(bm);
+}
+
+void ssd1306_bitmap_fill(struct ssd1306_bitmap *bm, const uint8_t *pattern)
+{
+    uint8_t *data = ssd1306_bitmap_pixels(bm);
+    uint8_t pages = ssd1306_bitmap_pages(bm);
+
+    if ((bm->width & 7u) == 0) {
+        _ssd1306_fill(data, ssd1306_bitmap_size(bm), pattern);
+    } else {
+        for (uint8_t p = 0; p < pages; p++) {
+            _ssd1306_fill(data + p * bm->width, bm->width, pattern);
+        }
+    }
+    _ssd1306_mark_held(bm);
+}
+
+void ssd1306_bitmap_invert(struct ssd1306_bitmap *bm)
+{
+    uint8_t *data = ssd1306_bitmap_pixels(bm);
+    uint16_t length = ssd1306_bitmap_size(bm);
+    uint16_t i = _ssd1306_head(data, length);
+    SSD1306_WORD_TYPE ones = ~(SSD1306_WORD_TYPE)0;
+
+    for (uint16_t k = 0; k < i; k++) {
+        data[k] ^= 0xFF;
+    }
+
+    for (; (uint16_t)(length - i) >= SSD1306_WORD_SIZE;
+         i += SSD1306_WORD_SIZE) {
+        SSD1306_WORD_TYPE word;
+
+        memcpy(&word, data + i, SSD1306_WORD_SIZE);
+        word ^= ones;
+        memcpy(data + i, &word, SSD1306_WORD_SIZE);
+    }
+
+    for (; i < length; i++) {
+        data[i] ^= 0xFF;
+    }
+    _ssd1306_mark_held(bm);
+}
+
+uint8_t ssd1306_bitmap_copy(struct ssd1306_bitmap *dst,
+                            const struct ssd1306_bitmap *src)
+{
+    if (ssd1306_bitmap_size(dst) != ssd1306_bitmap_size(src))
+        return 1;
+
+    memcpy(ssd1306_bitmap_pixels(dst), ssd1306_bitmap_pixels(src),
+           ssd1306_bitmap_size(dst));
+    _ssd1306_mark_held(dst);
+    return 0;
+}
+
+uint8_t ssd1306_bitmap_merge(struct ssd1306_bitmap *dst,
+                             const struct ssd1306_bitmap *src,
+                             enum ssd1306_raster_op op)
+{
+    uint8_t *d = ssd1306_bitmap_pixels(dst);
+    const uint8_t *s = ssd1306_bitmap_pixels(src);
+    uint16_t length = ssd1306_bitmap_size(dst);
+
+    if (length != ssd1306_bitmap_size(src))
+        return 1;
+
+    switch (op) {
+    case SSD1306_ROP_COPY:
+        _ssd1306_merge(d, s, length, SSD1306_ROP_COPY);
+        break;
+    case SSD1306_ROP_OR:
+        _ssd1306_merge(d, s, length, SSD1306_ROP_OR);
+        break;
+    case SSD1306_ROP_AND:
+        _ssd1306_merge(d, s, length, SSD1306_ROP_AND);
+        break;
+    case SSD1306_ROP_XOR:
+        _ssd1306_merge(d, s, length, SSD1306_ROP_XOR);
+        break;
+    default:
+        return 1;
+    }
+    _ssd1306_mark_held(dst);
+    return 0;
+}
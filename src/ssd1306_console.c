@@ -0,0 +1,111 @@
+/**
+ * @file ssd1306_console.c
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief This file provides a scrolling text console. When the console is
+ *        full, the display is scrolled with the start line register, so only
+ *        the new line is sent to the GDDRAM.
+ */
+
+#include "ssd1306/ssd1306_console.h"
+#include "ssd1306/ssd1306_graphics.h"
+
+/**
+ * @brief Sends the pages [first, last] of the bitmap to the GDDRAM. The
+ *        pages are contiguous on the display, but may wrap around the end of
+ *        the GDDRAM.
+ * @param con Pointer to a ssd1306_console struct.
+ * @param first First page.
+ * @param last Last page.
+ */
+static void _ssd1306_console_send(struct ssd1306_console *con, uint8_t first,
+                                  uint8_t last)
+{
+    struct ssd1306_bitmap *bm = con->text->bitmap;
+    uint8_t start = ssd1306_bitmap_ring(bm, first);
+    uint8_t end = start;
+
+    for (uint8_t p = first; p <= last; p++) {
+        uint8_t page = ssd1306_bitmap_ring(bm, p);
+
+        if (page != end) {
+            ssd1306_update_gddram_window(con->driver, bm, 0, bm->width - 1u,
+                                         start, end - 1u);
+            start = page;
+        }
+        end = page + 1u;
+        bm->dirty_end[page] = 0;
+    }
+    ssd1306_update_gddram_window(con->driver, bm, 0, bm->width - 1u, start,
+                                 end - 1u);
+}
+
+/**
+ * @brief Returns the number of pages seen on the display.
+ * @param con Pointer to a ssd1306_console struct.
+ */
+static inline uint8_t _ssd1306_console_pages(const struct ssd1306_console *con)
+{
+    return (con->rows ? con->rows : con->text->bitmap->height) >> 3u;
+}
+
+uint8_t ssd1306_console_init(struct ssd1306_console *con)
+{
+    struct ssd1306_bitmap *bm = con->text->bitmap;
+    uint8_t pages = bm->height >> 3u;
+    uint8_t visible = _ssd1306_console_pages(con);
+
+    if (bm->band_pages || pages != SSD1306_MAX_PAGES || (con->rows & 7u) ||
+        visible > pages || con->text->font->page_alignment > visible)
+        return 1;
+
+    bm->ring_page = 0;
+    con->line = 0;
+    ssd1306_bitmap_clear(bm);
+    _ssd1306_console_send(con, 0, pages - 1u);
+    ssd1306_set_start_line(con->driver, 0);
+    return 0;
+}
+
+void ssd1306_console_print(struct ssd1306_console *con, const char *str)
+{
+    struct ssd1306_bitmap *bm = con->text->bitmap;
+    uint8_t pages = bm->height >> 3u;
+    uint8_t visible = _ssd1306_console_pages(con);
+    uint8_t align = con->text->font->page_alignment;
+    uint8_t lines = visible / align;
+    uint8_t scroll = con->line == lines;
+    uint8_t hidden = 0;
+    uint8_t first;
+    uint8_t last;
+
+    if (!scroll) {
+        first = con->line * align;
+        last = first + align - 1u;
+        con->line++;
+    } else if (lines * align == visible && visible + align <= pages) {
+        /* The line below the display is hidden, so the new line is drawn
+         * there and scrolled in afterwards. */
+        hidden = 1;
+        first = visible;
+        last = visible + align - 1u;
+    } else {
+        /* All the GDDRAM is seen, so the oldest line is scrolled out before
+         * being overwritten, instead of flashing at the top of the display
+         * until the start line moves. */
+        bm->ring_page = ssd1306_bitmap_ring(bm, align);
+        ssd1306_set_start_line(con->driver, bm->ring_page << 3u);
+        first = (lines - 1u) * align;
+        last = visible - 1u;
+    }
+
+    ssd1306_async_wait_buffer(con->driver, bm->data, bm->length);
+    ssd1306_clear_rect(bm, 0, first << 3u, bm->width,
+                       (last - first + 1u) << 3u);
+    ssd1306_draw_text_at(con->text, 0, first << 3u, str, SSD1306_ROP_COPY);
+    _ssd1306_console_send(con, first, last);
+
+    if (hidden) {
+        bm->ring_page = ssd1306_bitmap_ring(bm, align);
+        ssd1306_set_start_line(con->driver, bm->ring_page << 3u);
+    }
+}
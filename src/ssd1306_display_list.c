@@ -0,0 +1,216 @@
+/**
+ * @file ssd1306_display_list.c
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief This file provides functions for recording graphic primitives and
+ *        text in a display list and rendering it one band of pages at a time.
+ */
+
+#include "ssd1306/ssd1306_display_list.h"
+#include "ssd1306/ssd1306_graphics.h"
+#include "ssd1306/ssd1306_text.h"
+
+/**
+ * @brief Returns a pointer to the next free entry of a display list.
+ * @param dl Pointer to a ssd1306_display_list struct.
+ * @param type Entry type.
+ * @return Pointer to the entry, or NULL if the display list is full.
+ */
+static struct ssd1306_dl_entry *_ssd1306_dl_add(struct ssd1306_display_list *dl,
+                                                enum ssd1306_dl_type type)
+{
+    if (dl->count >= dl->capacity)
+        return 0;
+
+    struct ssd1306_dl_entry *e = &dl->entries[dl->count++];
+    e->type = type;
+    return e;
+}
+
+/**
+ * @brief Records a polygon or a polyline.
+ * @param dl Pointer to a ssd1306_display_list struct.
+ * @param type SSD1306_DL_POLYGON or SSD1306_DL_POLYLINE.
+ * @param x Array containing points x-axis positions.
+ * @param y Array containing points y-axis positions.
+ * @param n Number of points in the array.
+ * @return 0 on success, 1 if the display list is full or there are no
+ *         points.
+ */
+static uint8_t _ssd1306_dl_poly(struct ssd1306_display_list *dl,
+                                enum ssd1306_dl_type type, int8_t *x,
+                                int8_t *y, uint16_t n)
+{
+    struct ssd1306_dl_entry *e;
+
+    if (!n)
+        return 1;
+
+    e = _ssd1306_dl_add(dl, type);
+    if (!e)
+        return 1;
+
+    e->params.poly.x = x;
+    e->params.poly.y = y;
+    e->params.poly.n = n;
+    e->top = y[0];
+    e->bottom = y[0];
+    for (uint16_t i = 1; i < n; i++) {
+        if (y[i] < e->top)
+            e->top = y[i];
+        if (y[i] > e->bottom)
+            e->bottom = y[i];
+    }
+    return 0;
+}
+
+/**
+ * @brief Draws a display list entry.
+ * @param bm Pointer to a ssd1306_bitmap struct.
+ * @param e Pointer to the entry.
+ */
+static void _ssd1306_dl_draw(struct ssd1306_bitmap *bm,
+                             struct ssd1306_dl_entry *e)
+{
+    switch (e->type) {
+    case SSD1306_DL_LINE:
+        ssd1306_draw_line(bm, e->params.line.x1, e->params.line.y1,
+                          e->params.line.x2, e->params.line.y2);
+        break;
+    case SSD1306_DL_CIRCLE:
+        ssd1306_draw_circle(bm, e->params.circle.cx, e->params.circle.cy,
+                            e->params.circle.r);
+        break;
+    case SSD1306_DL_POLYGON:
+        ssd1306_draw_polygon(bm, e->params.poly.x, e->params.poly.y,
+                             e->params.poly.n);
+        break;
+    case SSD1306_DL_POLYLINE:
+        ssd1306_draw_polyline(bm, e->params.poly.x, e->params.poly.y,
+                              e->params.poly.n);
+        break;
+    case SSD1306_DL_TEXT: {
+        struct ssd1306_text t = {.bitmap = bm, .font = e->params.text.font};
+        ssd1306_set_cursor_position(&t, e->params.text.col,
+                                    e->params.text.row);
+        ssd1306_draw_text(&t, e->params.text.str);
+        break;
+    }
+    }
+}
+
+uint8_t ssd1306_dl_line(struct ssd1306_display_list *dl, int8_t x1, int8_t y1,
+                        int8_t x2, int8_t y2)
+{
+    struct ssd1306_dl_entry *e = _ssd1306_dl_add(dl, SSD1306_DL_LINE);
+
+    if (!e)
+        return 1;
+
+    e->params.line.x1 = x1;
+    e->params.line.y1 = y1;
+    e->params.line.x2 = x2;
+    e->params.line.y2 = y2;
+    e->top = y1 < y2 ? y1 : y2;
+    e->bottom = y1 < y2 ? y2 : y1;
+    return 0;
+}
+
+uint8_t ssd1306_dl_circle(struct ssd1306_display_list *dl, int8_t cx,
+                          int8_t cy, int8_t r)
+{
+    struct ssd1306_dl_entry *e = _ssd1306_dl_add(dl, SSD1306_DL_CIRCLE);
+
+    if (!e)
+        return 1;
+
+    e->params.circle.cx = cx;
+    e->params.circle.cy = cy;
+    e->params.circle.r = r;
+    e->top = cy - r;
+    e->bottom = cy + r;
+    return 0;
+}
+
+uint8_t ssd1306_dl_polygon(struct ssd1306_display_list *dl, int8_t *x,
+                           int8_t *y, uint16_t n)
+{
+    return _ssd1306_dl_poly(dl, SSD1306_DL_POLYGON, x, y, n);
+}
+
+uint8_t ssd1306_dl_polyline(struct ssd1306_display_list *dl, int8_t *x,
+                            int8_t *y, uint16_t n)
+{
+    return _ssd1306_dl_poly(dl, SSD1306_DL_POLYLINE, x, y, n);
+}
+
+uint8_t ssd1306_dl_text(struct ssd1306_display_list *dl,
+                        const struct ssd1306_font *font, uint8_t col,
+                        uint8_t row, const char *str)
+{
+    struct ssd1306_dl_entry *e = _ssd1306_dl_add(dl, SSD1306_DL_TEXT);
+
+    if (!e)
+        return 1;
+
+    struct ssd1306_text t = {.font = font};
+    e->params.text.font = font;
+    e->params.text.str = str;
+    e->params.text.col = col;
+    e->params.text.row = row;
+    e->params.text.width = ssd1306_text_width(&t, str);
+    e->top = row << 3u;
+    e->bottom = ((row + font->page_alignment) << 3u) - 1;
+    return 0;
+}
+
+void ssd1306_dl_render(struct ssd1306_driver *driver,
+                       struct ssd1306_display_list *dl,
+                       struct ssd1306_bitmap *band)
+{
+    uint8_t pages = band->height >> 3u;
+    uint8_t step = band->band_pages ? band->band_pages : 1u;
+
+    band->band_pages = step;
+
+    for (uint8_t p = 0; p < pages; p += step) {
+        uint8_t last = (p + step < pages) ? p + step - 1u : pages - 1u;
+        int16_t top = p << 3u;
+        int16_t bottom = ((last + 1u) << 3u) - 1;
+
+        /* In asynchronous mode the previous band may still be on the bus. */
+        ssd1306_async_wait_buffer(driver, band->data, band->length);
+        band->band_page = p;
+        ssd1306_bitmap_clear(band);
+
+        for (uint16_t i = 0; i < dl->count; i++) {
+            struct ssd1306_dl_entry *e = &dl->entries[i];
+            int16_t e_top = e->top < 0 ? 0 : e->top;
+            int16_t e_bottom = e->bottom;
+
+            /* The text row is clamped by ssd1306_set_cursor_position, and
+             * text that does not fit in a line wraps to the next lines. */
+            if (e->type == SSD1306_DL_TEXT) {
+                uint8_t max_row = pages - e->params.text.font->page_alignment;
+                if (e->params.text.row > max_row)
+                    e_top = max_row << 3u;
+                if (e->params.text.col + e->params.text.width +
+                        e->params.text.font->space_width >=
+                    band->width)
+                    e_bottom = band->height - 1;
+            }
+            if (e_top >= band->height)
+                e_top = band->height - 1;
+            if (e_bottom < 0)
+                e_bottom = 0;
+
+            if (e_bottom < top || e_top > bottom)
+                continue;
+            _ssd1306_dl_draw(band, e);
+        }
+
+        ssd1306_update_gddram_pages(driver, band, p, last);
+    }
+
+    band->band_page = 0;
+    ssd1306_bitmap_reset_dirty(band);
+}
@@ -6,6 +6,179 @@
  */
 
 #include "ssd1306/ssd1306_graphics.h"
+#include <string.h>
+
+const uint8_t ssd1306_pattern_dither25[8] = {0x55, 0x00, 0xAA, 0x00,
+                                             0x55, 0x00, 0xAA, 0x00};
+const uint8_t ssd1306_pattern_dither50[8] = {0x55, 0xAA, 0x55, 0xAA,
+                                             0x55, 0xAA, 0x55, 0xAA};
+const uint8_t ssd1306_pattern_dither75[8] = {0xAA, 0xFF, 0x55, 0xFF,
+                                             0xAA, 0xFF, 0x55, 0xFF};
+
+/**
+ * @brief ORs a mask into the bytes of a page from column x1 to column x2. The
+ *        page must be inside the bitmap data and x1 <= x2 < width.
+ * @param bm Pointer to a ssd1306_bitmap struct.
+ * @param page Page number.
+ * @param x1 Start column.
+ * @param x2 End column.
+ * @param mask Rows of the page to set.
+ * @param pattern 8x8 pattern, one byte per column, or NULL to fill solid.
+ */
+static void _ssd1306_page_span(struct ssd1306_bitmap *bm, uint8_t page,
+                               uint8_t x1, uint8_t x2, uint8_t mask,
+                               const uint8_t *pattern)
+{
+    uint8_t *data = ssd1306_bitmap_page(bm, page) + x1;
+    uint8_t n = x2 - x1 + 1u;
+
+    if (pattern) {
+        for (uint8_t x = x1; n; n--, x++) {
+            *data++ |= mask & pattern[x & 7u];
+        }
+    } else if (mask == 0xFF) {
+        memset(data, 0xFF, n);
+    } else {
+        for (; n; n--) {
+            *data++ |= mask;
+        }
+    }
+    ssd1306_bitmap_mark_page(bm, page, x1, x2 + 1u);
+}
+
+/**
+ * @brief Sets or clears the pixels from (x, y1) to (x, y2), one masked byte
+ *        per page. The rows must be inside the bitmap data and y1 <= y2.
+ * @param bm Pointer to a ssd1306_bitmap struct.
+ * @param x Position on the x-axis.
+ * @param y1 Start point position on the y-axis.
+ * @param y2 End point position on the y-axis.
+ * @param pattern Rows to set in every page of the column. Ignored when
+ *        clearing.
+ * @param set 1 to set the pixels, 0 to clear them.
+ */
+static inline void _ssd1306_vspan(struct ssd1306_bitmap *bm, uint8_t x,
+                                  uint8_t y1, uint8_t y2, uint8_t pattern,
+                                  uint8_t set)
+{
+    uint8_t p1 = y1 >> 3u;
+    uint8_t p2 = y2 >> 3u;
+    uint8_t top = 0xFF << (y1 & 7u);
+    uint8_t bottom = 0xFF >> (7u - (y2 & 7u));
+
+    if (!set) {
+        if (p1 == p2) {
+            ssd1306_bitmap_page(bm, p1)[x] &= ~(top & bottom);
+        } else {
+            ssd1306_bitmap_page(bm, p1)[x] &= ~top;
+            for (uint8_t p = p1 + 1u; p < p2; p++) {
+                ssd1306_bitmap_page(bm, p)[x] = 0x00;
+            }
+            ssd1306_bitmap_page(bm, p2)[x] &= ~bottom;
+        }
+    } else if (p1 == p2) {
+        ssd1306_bitmap_page(bm, p1)[x] |= top & bottom & pattern;
+    } else {
+        ssd1306_bitmap_page(bm, p1)[x] |= top & pattern;
+        for (uint8_t p = p1 + 1u; p < p2; p++) {
+            ssd1306_bitmap_page(bm, p)[x] |= pattern;
+        }
+        ssd1306_bitmap_page(bm, p2)[x] |= bottom & pattern;
+    }
+
+    for (uint8_t p = p1; p <= p2; p++) {
+        ssd1306_bitmap_mark_page(bm, p, x, x + 1u);
+    }
+}
+
+/**
+ * @brief Clips a horizontal span to the bitmap data and draws it.
+ * @param bm Pointer to a ssd1306_bitmap struct.
+ * @param x1 Start point position on the x-axis.
+ * @param x2 End point position on the x-axis (x1 <= x2).
+ * @param y Position on the y-axis.
+ * @param pattern 8x8 pattern, or NULL to draw solid.
+ */
+static void _ssd1306_clip_hspan(struct ssd1306_bitmap *bm, int16_t x1,
+                                int16_t x2, int16_t y, const uint8_t *pattern)
+{
+    if (y < ssd1306_bitmap_top(bm) || y > ssd1306_bitmap_bottom(bm))
+        return;
+    if (x1 < 0)
+        x1 = 0;
+    if (x2 >= bm->width)
+        x2 = bm->width - 1;
+    if (x1 <= x2)
+        _ssd1306_page_span(bm, y >> 3u, x1, x2, 1u << (y & 7u), pattern);
+}
+
+/**
+ * @brief Clips a vertical span to the bitmap data and draws or clears it.
+ * @param bm Pointer to a ssd1306_bitmap struct.
+ * @param x Position on the x-axis.
+ * @param y1 Start point position on the y-axis.
+ * @param y2 End point position on the y-axis (y1 <= y2).
+ * @param pattern 8x8 pattern, or NULL to draw solid. Ignored when clearing.
+ * @param set 1 to set the pixels, 0 to clear them.
+ */
+static void _ssd1306_clip_vspan(struct ssd1306_bitmap *bm, int16_t x,
+                                int16_t y1, int16_t y2, const uint8_t *pattern,
+                                uint8_t set)
+{
+    int16_t top = ssd1306_bitmap_top(bm);
+    int16_t bottom = ssd1306_bitmap_bottom(bm);
+
+    if (x < 0 || x >= bm->width)
+        return;
+    if (y1 < top)
+        y1 = top;
+    if (y2 > bottom)
+        y2 = bottom;
+    if (y1 <= y2)
+        _ssd1306_vspan(bm, x, y1, y2, pattern ? pattern[x & 7u] : 0xFF, set);
+}
+
+/**
+ * @brief Draws a run of a line: a vertical span for steep lines or a
+ *        horizontal span otherwise.
+ * @param bm Pointer to a ssd1306_bitmap struct.
+ * @param steep Non-zero if the line is steep.
+ * @param x1 Start point position on the x-axis.
+ * @param y1 Start point position on the y-axis.
+ * @param x2 End point position on the x-axis.
+ * @param y2 End point position on the y-axis.
+ */
+static void _ssd1306_line_run(struct ssd1306_bitmap *bm, uint8_t steep,
+                              int16_t x1, int16_t y1, int16_t x2, int16_t y2)
+{
+    if (steep)
+        _ssd1306_clip_vspan(bm, x1, y1 < y2 ? y1 : y2, y1 < y2 ? y2 : y1,
+                            NULL, 1);
+    else
+        _ssd1306_clip_hspan(bm, x1 < x2 ? x1 : x2, x1 < x2 ? x2 : x1, y1,
+                            NULL);
+}
+
+void ssd1306_draw_hline(struct ssd1306_bitmap *bm, int8_t x, int8_t y,
+                        uint8_t w)
+{
+    if (w)
+        _ssd1306_clip_hspan(bm, x, x + w - 1, y, NULL);
+}
+
+void ssd1306_draw_vline(struct ssd1306_bitmap *bm, int8_t x, int8_t y,
+                        uint8_t h)
+{
+    if (h)
+        _ssd1306_clip_vspan(bm, x, y, y + h - 1, NULL, 1);
+}
+
+void ssd1306_clear_vline(struct ssd1306_bitmap *bm, int8_t x, int8_t y,
+                         uint8_t h)
+{
+    if (h)
+        _ssd1306_clip_vspan(bm, x, y, y + h - 1, NULL, 0);
+}
 
 void ssd1306_draw_line(struct ssd1306_bitmap *bm, int8_t x1, int8_t y1,
                        int8_t x2, int8_t y2)
@@ -42,12 +215,23 @@ void ssd1306_draw_line(struct ssd1306_bitmap *bm, int8_t x1, int8_t y1,
         sy = -1;
     }
 
+    uint8_t steep = dy > dx;
     dy = -dy;
     int16_t e = dx + dy;
     int16_t de;
+    int16_t run_x = x1;
+    int16_t run_y = y1;
+    int16_t last_x = x1;
+    int16_t last_y = y1;
 
     for (;;) {
-        ssd1306_set_pixel(bm, x1, y1);
+        if (steep ? x1 != run_x : y1 != run_y) {
+            _ssd1306_line_run(bm, steep, run_x, run_y, last_x, last_y);
+            run_x = x1;
+            run_y = y1;
+        }
+        last_x = x1;
+        last_y = y1;
         de = 2 * e;
 
         if (de >= dy) {
@@ -64,6 +248,8 @@ void ssd1306_draw_line(struct ssd1306_bitmap *bm, int8_t x1, int8_t y1,
             y1 += sy;
         }
     }
+
+    _ssd1306_line_run(bm, steep, run_x, run_y, last_x, last_y);
 }
 
 void ssd1306_draw_circle(struct ssd1306_bitmap *bm, int8_t cx, int8_t cy,
@@ -105,3 +291,252 @@ void ssd1306_draw_polyline(struct ssd1306_bitmap *bm, int8_t *x, int8_t *y,
         ssd1306_draw_line(bm, x[i], y[i], x[i + 1], y[i + 1]);
     }
 }
+
+/**
+ * @brief Sets or clears the pixels of a rectangle, one page at a time.
+ * @param bm Pointer to a ssd1306_bitmap struct.
+ * @param x Top left corner position on the x-axis.
+ * @param y Top left corner position on the y-axis.
+ * @param w Width in pixels.
+ * @param h Height in pixels.
+ * @param pattern 8x8 pattern, or NULL to fill solid. Ignored when clearing.
+ * @param set 1 to set the pixels, 0 to clear them.
+ */
+static void _ssd1306_rect(struct ssd1306_bitmap *bm, int8_t x, int8_t y,
+                          uint8_t w, uint8_t h, const uint8_t *pattern,
+                          uint8_t set)
+{
+    int16_t x1 = x;
+    int16_t x2 = x + w - 1;
+    int16_t y1 = y;
+    int16_t y2 = y + h - 1;
+    int16_t top = ssd1306_bitmap_top(bm);
+    int16_t bottom = ssd1306_bitmap_bottom(bm);
+
+    if (x1 < 0)
+        x1 = 0;
+    if (x2 >= bm->width)
+        x2 = bm->width - 1;
+    if (y1 < top)
+        y1 = top;
+    if (y2 > bottom)
+        y2 = bottom;
+    if (!w || !h || x1 > x2 || y1 > y2)
+        return;
+
+    uint8_t p1 = y1 >> 3u;
+    uint8_t p2 = y2 >> 3u;
+
+    for (uint8_t page = p1; page <= p2; page++) {
+        uint8_t mask = 0xFF;
+
+        if (page == p1)
+            mask &= 0xFF << (y1 & 7u);
+        if (page == p2)
+            mask &= 0xFF >> (7u - (y2 & 7u));
+
+        if (set) {
+            _ssd1306_page_span(bm, page, x1, x2, mask, pattern);
+        } else {
+            uint8_t *data = ssd1306_bitmap_page(bm, page) + x1;
+
+            for (uint8_t n = x2 - x1 + 1u; n; n--) {
+                *data++ &= ~mask;
+            }
+            ssd1306_bitmap_mark_page(bm, page, x1, x2 + 1u);
+        }
+    }
+}
+
+void ssd1306_fill_rect(struct ssd1306_bitmap *bm, int8_t x, int8_t y,
+                       uint8_t w, uint8_t h, const uint8_t *pattern)
+{
+    _ssd1306_rect(bm, x, y, w, h, pattern, 1);
+}
+
+void ssd1306_clear_rect(struct ssd1306_bitmap *bm, int8_t x, int8_t y,
+                        uint8_t w, uint8_t h)
+{
+    _ssd1306_rect(bm, x, y, w, h, NULL, 0);
+}
+
+void ssd1306_fill_circle(struct ssd1306_bitmap *bm, int8_t cx, int8_t cy,
+                         int8_t r, const uint8_t *pattern)
+{
+    int16_t x = -r;
+    int16_t y = 0;
+    int16_t e = 2 - 2 * r;
+    int16_t t;
+
+    do {
+        _ssd1306_clip_vspan(bm, cx - x, cy - y, cy + y, pattern, 1);
+        _ssd1306_clip_vspan(bm, cx + x, cy - y, cy + y, pattern, 1);
+        _ssd1306_clip_vspan(bm, cx - y, cy + x, cy - x, pattern, 1);
+        _ssd1306_clip_vspan(bm, cx + y, cy + x, cy - x, pattern, 1);
+
+        t = e;
+
+        if (t <= y)
+            e += ++y * 2 + 1;
+
+        if (t > x || e > y)
+            e += ++x * 2 + 1;
+    } while (x < 0);
+}
+
+/**
+ * @brief Returns the number of edges of a polygon crossing the center of a
+ *        row.
+ * @param y Array containing points y-axis positions.
+ * @param n Number of points in the array.
+ * @param row Position on the y-axis.
+ */
+static uint16_t _ssd1306_polygon_crossings(const int8_t *y, uint16_t n,
+                                           int16_t row)
+{
+    uint16_t count = 0;
+
+    for (uint16_t i = 0, j = n - 1; i < n; j = i++) {
+        if ((y[i] <= row && row < y[j]) || (y[j] <= row && row < y[i]))
+            count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Computes the spans of a polygon in a row with the even-odd rule.
+ *        Spans that overlap or touch are merged, so the spans are disjoint
+ *        and sorted.
+ * @param x Array containing points x-axis positions.
+ * @param y Array containing points y-axis positions.
+ * @param n Number of points in the array.
+ * @param row Position on the y-axis.
+ * @param nodes Array receiving the first and last column of each span,
+ *        SSD1306_POLYGON_MAX_NODES elements.
+ * @return Number of columns stored in nodes, two per span.
+ */
+static uint8_t _ssd1306_polygon_row(const int8_t *x, const int8_t *y,
+                                    uint16_t n, int16_t row, int8_t *nodes)
+{
+    uint8_t count = 0;
+    uint8_t spans = 0;
+
+    for (uint16_t i = 0, j = n - 1; i < n; j = i++) {
+        int16_t yi = y[i];
+        int16_t yj = y[j];
+
+        if ((yi <= row && row < yj) || (yj <= row && row < yi)) {
+            if (count == SSD1306_POLYGON_MAX_NODES)
+                break;
+            int16_t dy = yj - yi;
+            int16_t dx = x[j] - x[i];
+            /* The crossing lies between x[i] and x[j], so it fits. */
+            nodes[count++] =
+                x[i] + (int32_t)(2 * (row - yi) + 1) * dx / (2 * dy);
+        }
+    }
+
+    for (uint8_t i = 1; i < count; i++) {
+        int8_t node = nodes[i];
+        uint8_t j = i;
+
+        for (; j > 0 && nodes[j - 1] > node; j--) {
+            nodes[j] = nodes[j - 1];
+        }
+        nodes[j] = node;
+    }
+
+    for (uint8_t i = 0; i + 1u < count; i += 2u) {
+        if (spans && nodes[i] <= nodes[spans - 1] + 1) {
+            if (nodes[i + 1] > nodes[spans - 1])
+                nodes[spans - 1] = nodes[i + 1];
+        } else {
+            nodes[spans++] = nodes[i];
+            nodes[spans++] = nodes[i + 1];
+        }
+    }
+    return spans;
+}
+
+uint8_t ssd1306_fill_polygon(struct ssd1306_bitmap *bm, int8_t *x, int8_t *y,
+                             uint16_t n, const uint8_t *pattern)
+{
+    int8_t nodes[8][SSD1306_POLYGON_MAX_NODES];
+    uint8_t count[8];
+    int16_t top = ssd1306_bitmap_bottom(bm) + 1;
+    int16_t bottom = -1;
+
+    if (n == 0)
+        return 0;
+
+    for (uint16_t i = 0; i < n; i++) {
+        if (y[i] < top)
+            top = y[i];
+        if (y[i] > bottom)
+            bottom = y[i];
+    }
+    if (top < ssd1306_bitmap_top(bm))
+        top = ssd1306_bitmap_top(bm);
+    if (bottom > ssd1306_bitmap_bottom(bm))
+        bottom = ssd1306_bitmap_bottom(bm);
+
+    /* A row can't be crossed by more edges than the polygon has. */
+    if (n > SSD1306_POLYGON_MAX_NODES) {
+        for (int16_t row = top; row <= bottom; row++) {
+            if (_ssd1306_polygon_crossings(y, n, row) >
+                SSD1306_POLYGON_MAX_NODES)
+                return 1;
+        }
+    }
+
+    for (int16_t first = top & ~7; first <= bottom; first += 8) {
+        uint8_t index[8] = {0};
+        uint8_t mask = 0;
+        int16_t start = 0;
+
+        for (uint8_t r = 0; r < 8u; r++) {
+            int16_t row = first + r;
+
+            count[r] = row >= top && row <= bottom
+                           ? _ssd1306_polygon_row(x, y, n, row, nodes[r])
+                           : 0;
+        }
+
+        /* Sweeps the span ends of the 8 rows from left to right. Between two
+         * ends, every column has the same rows set, so the page is written
+         * once, a whole byte at a time where all the rows are inside. */
+        for (;;) {
+            int16_t next = INT16_MAX;
+
+            for (uint8_t r = 0; r < 8u; r++) {
+                if (index[r] < count[r] &&
+                    nodes[r][index[r]] + (index[r] & 1) < next)
+                    next = nodes[r][index[r]] + (index[r] & 1);
+            }
+            if (next == INT16_MAX)
+                break;
+
+            if (mask) {
+                int16_t x1 = start < 0 ? 0 : start;
+                int16_t x2 = next > bm->width ? bm->width - 1 : next - 1;
+
+                if (x1 <= x2)
+                    _ssd1306_page_span(bm, first >> 3u, x1, x2, mask,
+                                       pattern);
+            }
+
+            for (uint8_t r = 0; r < 8u; r++) {
+                if (index[r] < count[r] &&
+                    nodes[r][index[r]] + (index[r] & 1) == next) {
+                    mask ^= 1u << r;
+                    index[r]++;
+                }
+            }
+            start = next;
+        }
+    }
+
+    if (!pattern)
+        ssd1306_draw_polygon(bm, x, y, n);
+    return 0;
+}
@@ -0,0 +1,241 @@
+/**
+ * @file ssd1306_marquee.c
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief This file provides a marquee that scrolls a line of text to the
+ *        left. On a SSD1306B, only the column entering the display is sent
+ *        on each step.
+ */
+
+#include "ssd1306/ssd1306_marquee.h"
+#include "ssd1306/ssd1306_graphics.h"
+#include <string.h>
+
+/**
+ * @brief Number of ssd1306_scrolling_rate values.
+ */
+#define SSD1306_SCROLLING_RATES 8u
+
+/**
+ * @brief Frames between steps of each ssd1306_scrolling_rate value.
+ */
+static const uint16_t ssd1306_scrolling_frames[SSD1306_SCROLLING_RATES] = {
+    5, 64, 128, 256, 3, 4, 25, 2};
+
+/**
+ * @brief Returns the number of columns of a character of the marquee text,
+ *        including the separation to the next one.
+ * @param m Pointer to a ssd1306_marquee struct.
+ * @param i Index of the first byte of the character. The end of the string
+ *        is the gap.
+ */
+static uint8_t _ssd1306_marquee_columns(const struct ssd1306_marquee *m,
+                                        uint16_t i)
+{
+    const struct ssd1306_font *font = m->text->font;
+    uint32_t c;
+    uint8_t n;
+    int32_t x;
+
+    if (!m->str[i])
+        return m->gap;
+    n = ssd1306_utf8_decode(m->str + i, &c);
+    if (c == ' ')
+        return font->space_width;
+    x = ssd1306_font_glyph(font, c);
+    if (x < 0)
+        return 0;
+
+    return ssd1306_glyph_width(font, x) +
+           (m->str[i + n] != ' ' ? font->horizontal_separation : 0);
+}
+
+/**
+ * @brief Returns the index of the character after a character of the
+ *        marquee text, wrapping around after the gap.
+ * @param m Pointer to a ssd1306_marquee struct.
+ * @param i Index of the first byte of the character.
+ */
+static uint16_t _ssd1306_marquee_advance(const struct ssd1306_marquee *m,
+                                         uint16_t i)
+{
+    uint32_t c;
+
+    if (!m->str[i])
+        return 0;
+    return i + ssd1306_utf8_decode(m->str + i, &c);
+}
+
+/**
+ * @brief Computes the next column of the marquee text, one byte per page.
+ * @param m Pointer to a ssd1306_marquee struct.
+ * @param column Array receiving the column.
+ */
+static void _ssd1306_marquee_next(struct ssd1306_marquee *m, uint8_t *column)
+{
+    const struct ssd1306_font *font = m->text->font;
+
+    while (m->column >= _ssd1306_marquee_columns(m, m->index)) {
+        m->column = 0;
+        m->index = _ssd1306_marquee_advance(m, m->index);
+    }
+
+    memset(column, 0, font->page_alignment);
+
+    uint32_t c;
+    int32_t x = -1;
+
+    if (m->str[m->index]) {
+        ssd1306_utf8_decode(m->str + m->index, &c);
+        if (c != ' ')
+            x = ssd1306_font_glyph(font, c);
+    }
+    if (x >= 0) {
+        uint8_t w = ssd1306_glyph_width(font, x);
+
+        if (m->column < w) {
+            struct ssd1306_glyph_reader glyph;
+
+            ssd1306_glyph_begin(&glyph, font, x);
+            ssd1306_glyph_skip(&glyph, m->column);
+            for (uint8_t p = 0; p < font->page_alignment; p++) {
+                column[p] = ssd1306_glyph_read(&glyph);
+                if (p + 1u < font->page_alignment)
+                    ssd1306_glyph_skip(&glyph, w - 1u);
+            }
+        }
+    }
+    m->column++;
+}
+
+/**
+ * @brief Returns the scrolling configuration of the marquee pages.
+ * @param m Pointer to a ssd1306_marquee struct.
+ */
+static struct ssd1306_scrolling_config
+_ssd1306_marquee_config(const struct ssd1306_marquee *m)
+{
+    struct ssd1306_bitmap *bm = m->text->bitmap;
+    uint8_t last = m->page + m->text->font->page_alignment - 1u;
+    struct ssd1306_scrolling_config config = {
+        .mode = LEFT_HORIZONTAL_SCROLL,
+        .start_page = ssd1306_bitmap_ring(bm, m->page),
+        .end_page = ssd1306_bitmap_ring(bm, last),
+    };
+
+    return config;
+}
+
+/**
+ * @brief Sends the marquee pages to the GDDRAM.
+ * @param m Pointer to a ssd1306_marquee struct.
+ */
+static void _ssd1306_marquee_send(struct ssd1306_marquee *m)
+{
+    struct ssd1306_bitmap *bm = m->text->bitmap;
+    struct ssd1306_scrolling_config config = _ssd1306_marquee_config(m);
+
+    ssd1306_update_gddram_window(m->driver, bm, 0, bm->width - 1u,
+                                 config.start_page, config.end_page);
+    for (uint8_t p = config.start_page; p <= config.end_page; p++) {
+        bm->dirty_end[p] = 0;
+    }
+}
+
+uint8_t ssd1306_marquee_start(struct ssd1306_marquee *m)
+{
+    struct ssd1306_bitmap *bm = m->text->bitmap;
+    uint8_t align = m->text->font->page_alignment;
+    struct ssd1306_scrolling_config config;
+
+    if (bm->band_pages || m->page + align > (bm->height >> 3u))
+        return 1;
+
+    config = _ssd1306_marquee_config(m);
+    if (config.end_page < config.start_page)
+        return 1;
+
+    m->length = 0;
+    for (uint16_t i = 0; m->str[i]; i = _ssd1306_marquee_advance(m, i)) {
+        m->length += _ssd1306_marquee_columns(m, i);
+    }
+    m->length += m->gap;
+    if (!m->length)
+        return 1;
+
+    m->index = 0;
+    m->column = 0;
+    m->hardware = 0;
+
+    /* The SSD1306 repeats the GDDRAM every display width, so the text is
+       repeated to fill it and keep the period at m->length columns. */
+    if (bm->width % m->length == 0) {
+        for (uint8_t r = 0; r < SSD1306_SCROLLING_RATES; r++) {
+            if (ssd1306_scrolling_frames[r] == m->frames) {
+                config.rate = r;
+                m->hardware = 1;
+            }
+        }
+    }
+    ssd1306_async_wait_buffer(m->driver, bm->data, bm->length);
+    ssd1306_clear_rect(bm, 0, m->page << 3u, bm->width, align << 3u);
+    if (m->hardware) {
+        for (uint16_t x = 0; x < bm->width; x += m->length) {
+            ssd1306_draw_text_at(m->text, x, m->page << 3u, m->str,
+                                 SSD1306_ROP_COPY);
+        }
+    }
+    _ssd1306_marquee_send(m);
+
+    if (m->hardware)
+        ssd1306_activate_scroll(m->driver, config);
+    return 0;
+}
+
+void ssd1306_marquee_step(struct ssd1306_marquee *m)
+{
+    struct ssd1306_bitmap *bm = m->text->bitmap;
+    uint8_t last = bm->width - 1u;
+    uint8_t column[SSD1306_MAX_PAGES];
+    uint8_t batch[16];
+    struct ssd1306_scrolling_config config;
+    uint8_t own;
+
+    if (m->hardware)
+        return;
+
+    _ssd1306_marquee_next(m, column);
+    ssd1306_async_wait_buffer(m->driver, bm->data, bm->length);
+    for (uint8_t p = 0; p < m->text->font->page_alignment; p++) {
+        uint8_t *data = ssd1306_bitmap_page(bm, m->page + p);
+
+        memmove(data, data + 1, last);
+        data[last] = column[p];
+    }
+
+    /* Without ssd1306_scroll_one_column, the shifted pages are sent. */
+    if (!m->ssd1306b) {
+        _ssd1306_marquee_send(m);
+        return;
+    }
+
+    /* The commands are appended to the caller's batch, if any. */
+    own = !m->driver->batch;
+    config = _ssd1306_marquee_config(m);
+    if (own)
+        ssd1306_begin_batch(m->driver, batch, sizeof(batch));
+    ssd1306_scroll_one_column(m->driver, config);
+    ssd1306_update_gddram_window(m->driver, bm, last, last, config.start_page,
+                                 config.end_page);
+    if (own)
+        ssd1306_end_batch(m->driver);
+}
+
+void ssd1306_marquee_stop(struct ssd1306_marquee *m)
+{
+    if (!m->hardware)
+        return;
+
+    ssd1306_deactivate_scroll(m->driver);
+    _ssd1306_marquee_send(m);
+    m->hardware = 0;
+}
@@ -0,0 +1,238 @@
+/**
+ * @file ssd1306_number.c
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief This file provides numeric fields that draw integers, fixed-point
+ *        and floating-point values without formatting them into a string.
+ *        Only the characters that changed since the last value are drawn
+ *        again.
+ */
+
+#include "ssd1306/ssd1306_number.h"
+#include "ssd1306/ssd1306_graphics.h"
+#include <stddef.h>
+
+/**
+ * @brief Powers of ten up to 10 ^ SSD1306_NUMBER_MAX_PRECISION.
+ */
+static const uint32_t ssd1306_pow10[SSD1306_NUMBER_MAX_PRECISION + 1u] = {
+    1u,      10u,      100u,      1000u,      10000u,
+    100000u, 1000000u, 10000000u, 100000000u, 1000000000u};
+
+/**
+ * @brief Returns the width of the glyph of a character, or 0 if the font
+ *        has no glyph for it.
+ * @param font Pointer to a ssd1306_font struct.
+ * @param c Character.
+ */
+static uint8_t _ssd1306_number_glyph_width(const struct ssd1306_font *font,
+                                           char c)
+{
+    int32_t x = ssd1306_font_glyph(font, c);
+
+    return x < 0 ? 0 : ssd1306_glyph_width(font, x);
+}
+
+/**
+ * @brief Returns the number of cells before the decimal point.
+ * @param n Pointer to a ssd1306_number struct.
+ */
+static inline uint8_t _ssd1306_number_cells(const struct ssd1306_number *n)
+{
+    if (!n->precision)
+        return n->width;
+    return n->width > n->precision + 1u ? n->width - n->precision - 1u : 0;
+}
+
+/**
+ * @brief Draws a character of the field if it differs from the drawn one.
+ *        The glyph is centered in its cell.
+ * @param n Pointer to a ssd1306_number struct.
+ * @param i Character index in the field.
+ * @param c Character.
+ */
+static void _ssd1306_number_cell(struct ssd1306_number *n, uint8_t i, char c)
+{
+    const struct ssd1306_font *font = n->text->font;
+    uint8_t cells = _ssd1306_number_cells(n);
+    uint8_t x = n->x + i * n->cell_width;
+    uint8_t w = n->cell_width;
+    int32_t glyph;
+
+    if (n->valid && n->drawn[i] == c)
+        return;
+
+    if (n->precision && i == cells)
+        w = n->point_width;
+    else if (n->precision && i > cells)
+        x = x - n->cell_width + n->point_width;
+
+    ssd1306_clear_rect(n->text->bitmap, x, n->y, w,
+                       font->page_alignment << 3u);
+    glyph = ssd1306_font_glyph(font, c);
+    if (c != ' ' && glyph >= 0) {
+        uint8_t pad = w - font->horizontal_separation -
+                      ssd1306_glyph_width(font, glyph);
+
+        ssd1306_draw_glyph(n->text, x + pad / 2u, n->y, glyph,
+                           SSD1306_ROP_OR);
+    }
+    n->drawn[i] = c;
+}
+
+/**
+ * @brief Draws dashes in every digit cell of the field.
+ * @param n Pointer to a ssd1306_number struct.
+ * @return 1, so that the callers can return it.
+ */
+static uint8_t _ssd1306_number_overflow(struct ssd1306_number *n)
+{
+    uint8_t cells = _ssd1306_number_cells(n);
+
+    for (uint8_t i = 0; i < n->width; i++) {
+        _ssd1306_number_cell(n, i, n->precision && i == cells ? '.' : '-');
+    }
+    n->valid = 1;
+    return 1;
+}
+
+/**
+ * @brief Draws a value from its sign, integer part and fractional digits,
+ *        from the last character to the first one.
+ * @param n Pointer to a ssd1306_number struct.
+ * @param negative 1 if the value is negative.
+ * @param integer Integer part of the value.
+ * @param fraction Digits after the decimal point, below 10 ^ precision.
+ * @return 1 if the value doesn't fit in the field, 0 otherwise.
+ */
+static uint8_t _ssd1306_number_draw(struct ssd1306_number *n,
+                                    uint8_t negative, uint32_t integer,
+                                    uint32_t fraction)
+{
+    uint8_t cells = _ssd1306_number_cells(n);
+    uint8_t digits;
+
+    if (!integer && !fraction)
+        negative = 0;
+    digits = cells - negative;
+    if (n->precision > SSD1306_NUMBER_MAX_PRECISION || cells <= negative ||
+        (digits <= SSD1306_NUMBER_MAX_PRECISION &&
+         integer >= ssd1306_pow10[digits]))
+        return _ssd1306_number_overflow(n);
+
+    for (uint8_t i = n->width - 1u; i > cells; i--) {
+        _ssd1306_number_cell(n, i, '0' + fraction % 10u);
+        fraction /= 10u;
+    }
+    if (n->precision)
+        _ssd1306_number_cell(n, cells, '.');
+
+    for (uint8_t i = cells; i-- > 0;) {
+        char c;
+
+        if (i == cells - 1u || integer) {
+            c = '0' + integer % 10u;
+            integer /= 10u;
+        } else if (n->zero_pad) {
+            c = negative && !i ? '-' : '0';
+        } else if (negative) {
+            c = '-';
+            negative = 0;
+        } else {
+            c = ' ';
+        }
+        _ssd1306_number_cell(n, i, c);
+    }
+
+    n->valid = 1;
+    return 0;
+}
+
+uint8_t ssd1306_number_init(struct ssd1306_number *n)
+{
+    const struct ssd1306_font *font = n->text->font;
+    uint8_t width = _ssd1306_number_glyph_width(font, '-');
+    uint8_t point = _ssd1306_number_glyph_width(font, '.');
+
+    for (char c = '0'; c <= '9'; c++) {
+        uint8_t w = _ssd1306_number_glyph_width(font, c);
+
+        if (w > width)
+            width = w;
+    }
+
+    n->cell_width = width + font->horizontal_separation;
+    n->point_width = (point ? point : font->space_width) +
+                     font->horizontal_separation;
+    n->valid = 0;
+
+    return n->precision > SSD1306_NUMBER_MAX_PRECISION ||
+           (n->precision && n->width <= n->precision);
+}
+
+uint8_t ssd1306_draw_int(struct ssd1306_number *n, int32_t value)
+{
+    uint32_t magnitude = value < 0 ? 0u - (uint32_t)value : (uint32_t)value;
+
+    return _ssd1306_number_draw(n, value < 0, magnitude, 0);
+}
+
+uint8_t ssd1306_draw_decimal(struct ssd1306_number *n, int32_t value)
+{
+    uint32_t magnitude = value < 0 ? 0u - (uint32_t)value : (uint32_t)value;
+
+    if (n->precision > SSD1306_NUMBER_MAX_PRECISION)
+        return _ssd1306_number_overflow(n);
+
+    uint32_t scale = ssd1306_pow10[n->precision];
+
+    return _ssd1306_number_draw(n, value < 0, magnitude / scale,
+                                magnitude % scale);
+}
+
+uint8_t ssd1306_draw_fixed(struct ssd1306_number *n, int32_t value,
+                           uint8_t frac_bits)
+{
+    uint32_t magnitude = value < 0 ? 0u - (uint32_t)value : (uint32_t)value;
+
+    if (n->precision > SSD1306_NUMBER_MAX_PRECISION || frac_bits > 31u)
+        return _ssd1306_number_overflow(n);
+
+    uint32_t scale = ssd1306_pow10[n->precision];
+    uint32_t integer = magnitude >> frac_bits;
+    uint32_t fraction = 0;
+
+    if (frac_bits) {
+        uint64_t bits = magnitude & ((1ul << frac_bits) - 1u);
+
+        /* Rounds half up, carrying into the integer part. */
+        fraction = (bits * scale + (1ul << (frac_bits - 1u))) >> frac_bits;
+        if (fraction == scale) {
+            fraction = 0;
+            integer++;
+        }
+    }
+
+    return _ssd1306_number_draw(n, value < 0, integer, fraction);
+}
+
+uint8_t ssd1306_draw_float(struct ssd1306_number *n, float value)
+{
+    float magnitude = value < 0.0f ? -value : value;
+
+    /* Also rejects NaN, which fails every comparison. */
+    if (!(magnitude < 4294967296.0f) ||
+        n->precision > SSD1306_NUMBER_MAX_PRECISION)
+        return _ssd1306_number_overflow(n);
+
+    uint32_t scale = ssd1306_pow10[n->precision];
+    uint32_t integer = (uint32_t)magnitude;
+    uint32_t fraction =
+        (uint32_t)((magnitude - (float)integer) * (float)scale + 0.5f);
+
+    if (fraction >= scale) {
+        fraction -= scale;
+        integer++;
+    }
+
+    return _ssd1306_number_draw(n, value < 0.0f, integer, fraction);
+}
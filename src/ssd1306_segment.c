@@ -0,0 +1,199 @@
+/**
+ * @file ssd1306_segment.c
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief This file provides a seven-segment readout drawn from segment
+ *        geometry, at any size and without font data. Only the segments that
+ *        changed since the last update are drawn or cleared.
+ */
+
+#include "ssd1306/ssd1306_segment.h"
+#include "ssd1306/ssd1306_graphics.h"
+#include <stddef.h>
+
+/**
+ * @brief Segments of the digits 0 to 9.
+ */
+static const uint8_t ssd1306_segment_digits[10] = {
+    0x3F, 0x06, 0x5B, 0x4F, 0x66, 0x6D, 0x7D, 0x07, 0x7F, 0x6F};
+
+/**
+ * @brief Segments of the letters A to F, drawn as A, b, C, d, E and F.
+ */
+static const uint8_t ssd1306_segment_letters[6] = {0x77, 0x7C, 0x39,
+                                                   0x5E, 0x79, 0x71};
+
+/**
+ * @brief Draws or clears a column of a segment.
+ * @param bm Pointer to a ssd1306_bitmap struct.
+ * @param x Position on the x-axis.
+ * @param y1 Start point position on the y-axis.
+ * @param y2 End point position on the y-axis.
+ * @param set 1 to draw the column, 0 to clear it.
+ */
+static inline void _ssd1306_segment_span(struct ssd1306_bitmap *bm, int16_t x,
+                                         int16_t y1, int16_t y2, uint8_t set)
+{
+    if (y1 > y2)
+        return;
+    if (set)
+        ssd1306_draw_vline(bm, x, y1, y2 - y1 + 1);
+    else
+        ssd1306_clear_vline(bm, x, y1, y2 - y1 + 1);
+}
+
+/**
+ * @brief Draws or clears a horizontal segment, one column at a time. Columns
+ *        get shorter towards the tips.
+ * @param bm Pointer to a ssd1306_bitmap struct.
+ * @param x1 Left tip position on the x-axis.
+ * @param x2 Right tip position on the x-axis.
+ * @param y Top position of the segment.
+ * @param t Segment thickness.
+ * @param set 1 to draw the segment, 0 to clear it.
+ */
+static void _ssd1306_segment_hbar(struct ssd1306_bitmap *bm, int16_t x1,
+                                  int16_t x2, int16_t y, uint8_t t,
+                                  uint8_t set)
+{
+    int16_t half = (t - 1) / 2;
+
+    for (int16_t x = x1; x <= x2; x++) {
+        int16_t tip = x - x1 < x2 - x ? x - x1 : x2 - x;
+        int16_t inset = tip < half ? half - tip : 0;
+
+        _ssd1306_segment_span(bm, x, y + inset, y + t - 1 - inset, set);
+    }
+}
+
+/**
+ * @brief Draws or clears a vertical segment, one column at a time. Columns
+ *        get shorter away from the center of the segment.
+ * @param bm Pointer to a ssd1306_bitmap struct.
+ * @param x Left position of the segment.
+ * @param y1 Top tip position on the y-axis.
+ * @param y2 Bottom tip position on the y-axis.
+ * @param t Segment thickness.
+ * @param set 1 to draw the segment, 0 to clear it.
+ */
+static void _ssd1306_segment_vbar(struct ssd1306_bitmap *bm, int16_t x,
+                                  int16_t y1, int16_t y2, uint8_t t,
+                                  uint8_t set)
+{
+    int16_t half = (t - 1) / 2;
+
+    for (int16_t j = 0; j < t; j++) {
+        int16_t inset = half - j;
+
+        if (j - (t - 1 - half) > inset)
+            inset = j - (t - 1 - half);
+        if (inset < 0)
+            inset = 0;
+        _ssd1306_segment_span(bm, x + j, y1 + inset, y2 - inset, set);
+    }
+}
+
+/**
+ * @brief Draws or clears segments of a digit.
+ * @param d Pointer to a ssd1306_segment_display struct.
+ * @param pos Digit position, from the left.
+ * @param segments Segments to draw or clear.
+ * @param set 1 to draw the segments, 0 to clear them.
+ */
+static void _ssd1306_segment_draw(struct ssd1306_segment_display *d,
+                                  uint8_t pos, uint8_t segments, uint8_t set)
+{
+    struct ssd1306_bitmap *bm = d->bitmap;
+    uint8_t w = d->digit_width;
+    uint8_t t = d->thickness;
+    /* Distance from the outer edge of a segment to the tips of the segments
+     * that meet it, which leaves a pixel between their bevels. */
+    int16_t tip = t / 2 + 1;
+    int16_t left = d->x + pos * (w + d->spacing);
+    int16_t right = left + w - t;
+    int16_t top = d->y;
+    int16_t middle = d->y + (d->digit_height - t) / 2;
+    int16_t bottom = d->y + d->digit_height - t;
+    int16_t x1 = left + tip;
+    int16_t x2 = left + w - 1 - tip;
+    int16_t upper1 = top + tip;
+    int16_t upper2 = middle + t - 1 - tip;
+    int16_t lower1 = middle + tip;
+    int16_t lower2 = bottom + t - 1 - tip;
+
+    if (segments & SSD1306_SEGMENT_A)
+        _ssd1306_segment_hbar(bm, x1, x2, top, t, set);
+    if (segments & SSD1306_SEGMENT_B)
+        _ssd1306_segment_vbar(bm, right, upper1, upper2, t, set);
+    if (segments & SSD1306_SEGMENT_C)
+        _ssd1306_segment_vbar(bm, right, lower1, lower2, t, set);
+    if (segments & SSD1306_SEGMENT_D)
+        _ssd1306_segment_hbar(bm, x1, x2, bottom, t, set);
+    if (segments & SSD1306_SEGMENT_E)
+        _ssd1306_segment_vbar(bm, left, lower1, lower2, t, set);
+    if (segments & SSD1306_SEGMENT_F)
+        _ssd1306_segment_vbar(bm, left, upper1, upper2, t, set);
+    if (segments & SSD1306_SEGMENT_G)
+        _ssd1306_segment_hbar(bm, x1, x2, middle, t, set);
+    if (segments & SSD1306_SEGMENT_DP) {
+        /* Narrowed to leave a free column before the next digit. */
+        uint8_t dw = d->spacing > t ? t : d->spacing ? d->spacing - 1 : 0;
+        int16_t x = left + w + (d->spacing - dw) / 2;
+
+        for (uint8_t j = 0; j < dw; j++) {
+            _ssd1306_segment_span(bm, x + j, bottom, bottom + t - 1, set);
+        }
+    }
+}
+
+uint8_t ssd1306_segment_encode(char c)
+{
+    if (c >= '0' && c <= '9')
+        return ssd1306_segment_digits[c - '0'];
+    if (c >= 'A' && c <= 'F')
+        return ssd1306_segment_letters[c - 'A'];
+    if (c >= 'a' && c <= 'f')
+        return ssd1306_segment_letters[c - 'a'];
+    if (c == '-')
+        return SSD1306_SEGMENT_G;
+    if (c == '_')
+        return SSD1306_SEGMENT_D;
+    return 0;
+}
+
+void ssd1306_segment_set(struct ssd1306_segment_display *d, uint8_t pos,
+                         uint8_t segments)
+{
+    if (pos >= d->digits)
+        return;
+
+    if (!d->valid) {
+        int16_t width = d->digits * (d->digit_width + d->spacing);
+
+        ssd1306_clear_rect(d->bitmap, d->x, d->y, width > 255 ? 255 : width,
+                           d->digit_height);
+        for (uint8_t i = 0; i < d->digits; i++) {
+            d->drawn[i] = 0;
+        }
+        d->valid = 1;
+    }
+
+    _ssd1306_segment_draw(d, pos, d->drawn[pos] & ~segments, 0);
+    _ssd1306_segment_draw(d, pos, segments & ~d->drawn[pos], 1);
+    d->drawn[pos] = segments;
+}
+
+void ssd1306_segment_print(struct ssd1306_segment_display *d,
+                           const char *str)
+{
+    for (uint8_t pos = 0; pos < d->digits; pos++) {
+        uint8_t segments = 0;
+
+        if (*str && *str != '.')
+            segments = ssd1306_segment_encode(*str++);
+        if (*str == '.') {
+            segments |= SSD1306_SEGMENT_DP;
+            str++;
+        }
+        ssd1306_segment_set(d, pos, segments);
+    }
+}
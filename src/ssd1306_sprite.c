@@ -0,0 +1,165 @@
+/**
+ * @file ssd1306_sprite.c
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief This file provides functions for drawing page-format images at any
+ *        position of a ssd1306_bitmap struct.
+ */
+
+#include "ssd1306/ssd1306_sprite.h"
+#include <stddef.h>
+#include <string.h>
+
+/**
+ * @brief Struct holding the source of one destination page.
+ */
+struct ssd1306_sprite_row {
+    const uint8_t *hi;  /**< Sprite page shifted down into the page. */
+    const uint8_t *lo;  /**< Sprite page shifted up into the page. */
+    const uint8_t *mhi; /**< Mask page matching hi. */
+    const uint8_t *mlo; /**< Mask page matching lo. */
+    uint8_t shift;      /**< Vertical offset of the sprite within a page. */
+};
+
+/**
+ * @brief Returns the byte of a column read from two sprite pages.
+ * @param hi Sprite page shifted down, or NULL.
+ * @param lo Sprite page shifted up, or NULL.
+ * @param k Column index.
+ * @param shift Vertical offset of the sprite within a page.
+ */
+static inline uint8_t _ssd1306_sprite_column(const uint8_t *hi,
+                                             const uint8_t *lo, uint8_t k,
+                                             uint8_t shift)
+{
+    uint8_t value = hi ? hi[k] << shift : 0;
+
+    if (lo)
+        value |= lo[k] >> (8u - shift);
+    return value;
+}
+
+/**
+ * @brief Applies a logical operation to the columns of one destination page.
+ *        The operation is a constant at every call site, so the switch is
+ *        resolved when the function is inlined.
+ * @param dst Pointer to the first destination byte.
+ * @param n Number of columns.
+ * @param row Pointer to the source of the page.
+ * @param cover Rows of the page covered by the sprite.
+ * @param op Logical operation.
+ */
+static inline void _ssd1306_sprite_page(uint8_t *dst, uint8_t n,
+                                        const struct ssd1306_sprite_row *row,
+                                        uint8_t cover,
+                                        enum ssd1306_raster_op op)
+{
+    for (uint8_t k = 0; k < n; k++) {
+        uint8_t s =
+            _ssd1306_sprite_column(row->hi, row->lo, k, row->shift) & cover;
+
+        switch (op) {
+        case SSD1306_ROP_COPY:
+            dst[k] = (dst[k] & ~cover) | s;
+            break;
+        case SSD1306_ROP_OR:
+            dst[k] |= s;
+            break;
+        case SSD1306_ROP_AND:
+            dst[k] &= s | ~cover;
+            break;
+        case SSD1306_ROP_XOR:
+            dst[k] ^= s;
+            break;
+        case SSD1306_ROP_MASK: {
+            uint8_t m = _ssd1306_sprite_column(row->mhi, row->mlo, k,
+                                               row->shift) &
+                        cover;
+            dst[k] = (dst[k] & ~m) | (s & m);
+            break;
+        }
+        }
+    }
+}
+
+void ssd1306_draw_sprite(struct ssd1306_bitmap *bm,
+                         const struct ssd1306_sprite *sprite, int16_t x,
+                         int16_t y, enum ssd1306_raster_op op)
+{
+    int16_t x1 = x < 0 ? 0 : x;
+    int16_t x2 = x + sprite->width - 1;
+    int16_t y1 = y;
+    int16_t y2 = y + sprite->height - 1;
+    int16_t top = ssd1306_bitmap_top(bm);
+    int16_t bottom = ssd1306_bitmap_bottom(bm);
+
+    if (x2 >= bm->width)
+        x2 = bm->width - 1;
+    if (y1 < top)
+        y1 = top;
+    if (y2 > bottom)
+        y2 = bottom;
+    if (!sprite->width || !sprite->height || x1 > x2 || y1 > y2)
+        return;
+
+    if (op == SSD1306_ROP_MASK && !sprite->mask)
+        op = SSD1306_ROP_OR;
+
+    /* Page of the first sprite row, rounded towards minus infinity. */
+    int16_t origin = (y < 0 ? y - 7 : y) / 8;
+    uint8_t pages = (sprite->height + 7u) >> 3u;
+    uint8_t n = x2 - x1 + 1;
+    struct ssd1306_sprite_row row;
+
+    row.shift = y - origin * 8;
+
+    for (uint8_t page = y1 >> 3u; page <= (y2 >> 3u); page++) {
+        uint8_t k = page - origin;
+        uint16_t offset = (x1 - x);
+        uint8_t cover = 0xFF;
+
+        if (page == (y1 >> 3u))
+            cover &= 0xFF << (y1 & 7u);
+        if (page == (y2 >> 3u))
+            cover &= 0xFF >> (7u - (y2 & 7u));
+
+        row.hi = row.mhi = NULL;
+        row.lo = row.mlo = NULL;
+        if (k < pages) {
+            row.hi = sprite->data + k * sprite->width + offset;
+            if (sprite->mask)
+                row.mhi = sprite->mask + k * sprite->width + offset;
+        }
+        if (k > 0 && row.shift) {
+            row.lo = sprite->data + (k - 1) * sprite->width + offset;
+            if (sprite->mask)
+                row.mlo = sprite->mask + (k - 1) * sprite->width + offset;
+        }
+
+        uint8_t *dst = ssd1306_bitmap_page(bm, page) + x1;
+
+        if (op == SSD1306_ROP_COPY && cover == 0xFF && !row.lo) {
+            memcpy(dst, row.hi, n);
+            ssd1306_bitmap_mark_page(bm, page, x1, x2 + 1u);
+            continue;
+        }
+
+        switch (op) {
+        case SSD1306_ROP_COPY:
+            _ssd1306_sprite_page(dst, n, &row, cover, SSD1306_ROP_COPY);
+            break;
+        case SSD1306_ROP_OR:
+            _ssd1306_sprite_page(dst, n, &row, cover, SSD1306_ROP_OR);
+            break;
+        case SSD1306_ROP_AND:
+            _ssd1306_sprite_page(dst, n, &row, cover, SSD1306_ROP_AND);
+            break;
+        case SSD1306_ROP_XOR:
+            _ssd1306_sprite_page(dst, n, &row, cover, SSD1306_ROP_XOR);
+            break;
+        case SSD1306_ROP_MASK:
+            _ssd1306_sprite_page(dst, n, &row, cover, SSD1306_ROP_MASK);
+            break;
+        }
+        ssd1306_bitmap_mark_page(bm, page, x1, x2 + 1u);
+    }
+}
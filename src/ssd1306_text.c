@@ -6,18 +6,8 @@
  */
 
 #include "ssd1306/ssd1306_text.h"
-
-/**
- * @brief Converts the cursor position to a bitmap index.
- * @param t Pointer to a ssd1306_text_renderer struct.
- * @param col Cursor column position.
- * @param row Cursor row position.
- */
-static inline uint16_t ssd1306_cursor_to_index(struct ssd1306_text *t,
-                                               uint8_t col, uint8_t row)
-{
-    return (1 + col + row * t->bitmap->width);
-}
+#include "ssd1306/ssd1306_sprite.h"
+#include <stddef.h>
 
 /**
  * @brief Moves the cursor to the next line.
@@ -45,25 +35,21 @@ void ssd1306_set_cursor_position(struct ssd1306_text *t, uint8_t col,
     t->cursor_row = row;
 }
 
-void ssd1306_draw_text(struct ssd1306_text *t, char *str)
+void ssd1306_draw_text(struct ssd1306_text *t, const char *str)
 {
     uint16_t i = 0;
 
     while (str[i]) {
-        if (str[i] == ' ') {
+        uint32_t c;
+        uint8_t n = ssd1306_utf8_decode(str + i, &c);
+        int32_t x = ssd1306_font_glyph(t->font, c);
+
+        if (c == ' ') {
             ssd1306_set_cursor_position(t, t->cursor_col + t->font->space_width,
                                         t->cursor_row);
-        } else if (str[i] >= t->font->first_char &&
-                   str[i] <= t->font->last_char) {
-            uint8_t x = str[i] - t->font->first_char;
-
-            uint8_t w = t->font->type == SSD1306_VARIABLE_WIDTH_FONT
-                            ? t->font->char_width[x]
-                            : t->font->space_width;
-
-            uint16_t font_index = t->font->type == SSD1306_VARIABLE_WIDTH_FONT
-                                      ? t->font->char_offset[x]
-                                      : x * w * t->font->page_alignment;
+        } else if (x >= 0) {
+            uint8_t w = ssd1306_glyph_width(t->font, x);
+            struct ssd1306_glyph_reader glyph;
 
             if (t->cursor_col + w >= t->bitmap->width) {
                 if (ssd1306_cursor_next_line(t)) {
@@ -71,16 +57,23 @@ void ssd1306_draw_text(struct ssd1306_text *t, char *str)
                 }
             }
 
+            uint8_t pages = ssd1306_bitmap_pages(t->bitmap);
+
+            ssd1306_glyph_begin(&glyph, t->font, x);
             for (uint8_t p = 0; p < t->font->page_alignment; p++) {
-                uint16_t cursor_index = ssd1306_cursor_to_index(
-                    t, t->cursor_col, t->cursor_row + p);
-                for (uint8_t k = 0; k < w; k++) {
-                    t->bitmap->data[cursor_index + k] =
-                        t->font->data[font_index];
-                    font_index++;
+                uint8_t row = t->cursor_row + p - t->bitmap->band_page;
+                if (row >= pages) {
+                    ssd1306_glyph_skip(&glyph, w);
+                    continue;
                 }
+                uint8_t *data =
+                    ssd1306_bitmap_page(t->bitmap, t->cursor_row + p) +
+                    t->cursor_col;
+                ssd1306_glyph_read_n(&glyph, data, w);
+                ssd1306_bitmap_mark_page(t->bitmap, t->cursor_row + p,
+                                         t->cursor_col, t->cursor_col + w);
             }
-            if (str[i + 1] == ' ') {
+            if (str[i + n] == ' ') {
                 ssd1306_set_cursor_position(t, t->cursor_col + w,
                                             t->cursor_row);
             } else {
@@ -90,33 +83,402 @@ void ssd1306_draw_text(struct ssd1306_text *t, char *str)
             }
         }
 
-        i++;
+        i += n;
+    }
+}
+
+/**
+ * @brief Combines a glyph byte with a bitmap byte.
+ * @param dst Pointer to the bitmap byte.
+ * @param src Glyph byte, shifted to the rows of the bitmap byte.
+ * @param cover Rows of the bitmap byte covered by the glyph.
+ * @param op Logical operation. SSD1306_ROP_MASK is handled as
+ *        SSD1306_ROP_OR, as glyphs have no mask.
+ */
+static inline void _ssd1306_glyph_rop(uint8_t *dst, uint8_t src, uint8_t cover,
+                                      enum ssd1306_raster_op op)
+{
+    switch (op) {
+    case SSD1306_ROP_COPY:
+        *dst = (*dst & ~cover) | src;
+        break;
+    case SSD1306_ROP_AND:
+        *dst &= src | ~cover;
+        break;
+    case SSD1306_ROP_XOR:
+        *dst ^= src;
+        break;
+    default:
+        *dst |= src;
+        break;
     }
 }
 
-uint16_t ssd1306_text_width(struct ssd1306_text *t, char *str)
+/**
+ * @brief Draws a RLE glyph at the pixel (x, y), decoding it straight into
+ *        the bitmap. Each glyph byte is split between the two bitmap pages
+ *        it overlaps.
+ * @param t Pointer to a ssd1306_text struct.
+ * @param c Glyph index, see ssd1306_font_glyph.
+ * @param x Position on the x-axis.
+ * @param y Position on the y-axis.
+ * @param op Logical operation used to combine the glyph with the bitmap.
+ */
+static void _ssd1306_draw_rle_glyph(struct ssd1306_text *t, uint16_t c,
+                                    int16_t x, int16_t y,
+                                    enum ssd1306_raster_op op)
+{
+    struct ssd1306_bitmap *bm = t->bitmap;
+    uint8_t w = ssd1306_glyph_width(t->font, c);
+    int16_t top = ssd1306_bitmap_top(bm) >> 3u;
+    int16_t bottom = ssd1306_bitmap_bottom(bm) >> 3u;
+    /* Page of the first glyph row, rounded towards minus infinity. */
+    int16_t origin = (y < 0 ? y - 7 : y) / 8;
+    uint8_t shift = y - origin * 8;
+    int16_t x1 = x < 0 ? 0 : x;
+    int16_t x2 = x + w;
+    struct ssd1306_glyph_reader glyph;
+
+    if (x2 > bm->width)
+        x2 = bm->width;
+    if (x1 >= x2)
+        return;
+
+    ssd1306_glyph_begin(&glyph, t->font, c);
+    for (uint8_t p = 0; p < t->font->page_alignment; p++) {
+        int16_t page = origin + p;
+        uint8_t *hi = NULL;
+        uint8_t *lo = NULL;
+
+        if (page >= top && page <= bottom) {
+            hi = ssd1306_bitmap_page(bm, page) + x1;
+            ssd1306_bitmap_mark_page(bm, page, x1, x2);
+        }
+        if (shift && page + 1 >= top && page + 1 <= bottom) {
+            lo = ssd1306_bitmap_page(bm, page + 1) + x1;
+            ssd1306_bitmap_mark_page(bm, page + 1, x1, x2);
+        }
+        if (!hi && !lo) {
+            ssd1306_glyph_skip(&glyph, w);
+            continue;
+        }
+
+        for (int16_t k = x; k < x + w; k++) {
+            uint8_t value = ssd1306_glyph_read(&glyph);
+
+            if (k < x1 || k >= x2)
+                continue;
+            if (hi)
+                _ssd1306_glyph_rop(hi + k - x1, value << shift,
+                                   0xFF << shift, op);
+            if (lo)
+                _ssd1306_glyph_rop(lo + k - x1, value >> (8u - shift),
+                                   0xFF >> (8u - shift), op);
+        }
+    }
+}
+
+uint8_t ssd1306_draw_glyph(struct ssd1306_text *t, int16_t x, int16_t y,
+                           uint16_t c, enum ssd1306_raster_op op)
+{
+    struct ssd1306_sprite glyph = {
+        .width = ssd1306_glyph_width(t->font, c),
+        .height = t->font->page_alignment << 3u,
+    };
+
+    if (t->font->encoding == SSD1306_RLE_FONT) {
+        _ssd1306_draw_rle_glyph(t, c, x, y, op);
+    } else {
+        glyph.data = t->font->data + ssd1306_glyph_offset(t->font, c);
+        ssd1306_draw_sprite(t->bitmap, &glyph, x, y, op);
+    }
+
+    return glyph.width;
+}
+
+/**
+ * @brief Draws up to n bytes of a string at the pixel (x, y).
+ * @param t Pointer to a ssd1306_text struct.
+ * @param x Position on the x-axis.
+ * @param y Position on the y-axis.
+ * @param str Text to draw.
+ * @param n Maximum number of bytes to draw.
+ * @param op Logical operation used to combine the glyphs with the bitmap.
+ * @return Position on the x-axis after the last glyph.
+ */
+static int16_t _ssd1306_draw_glyphs(struct ssd1306_text *t, int16_t x,
+                                    int16_t y, const char *str, uint16_t n,
+                                    enum ssd1306_raster_op op)
+{
+    for (uint16_t i = 0, k; i < n && str[i] && x < t->bitmap->width; i += k) {
+        uint32_t code;
+        int32_t c;
+
+        k = ssd1306_utf8_decode(str + i, &code);
+        c = ssd1306_font_glyph(t->font, code);
+        if (code == ' ') {
+            x += t->font->space_width;
+        } else if (c >= 0) {
+            x += ssd1306_draw_glyph(t, x, y, c, op);
+            if (str[i + k] != ' ')
+                x += t->font->horizontal_separation;
+        }
+    }
+
+    return x;
+}
+
+int16_t ssd1306_draw_text_at(struct ssd1306_text *t, int16_t x, int16_t y,
+                             const char *str, enum ssd1306_raster_op op)
+{
+    return _ssd1306_draw_glyphs(t, x, y, str, UINT16_MAX, op);
+}
+
+/**
+ * @brief Appends a line to a layout.
+ * @param layout Pointer to a ssd1306_layout struct.
+ * @param start Index of the first character of the line.
+ * @param end Index of the character after the line.
+ * @param width Line width in pixels.
+ */
+static void _ssd1306_layout_push(struct ssd1306_layout *layout,
+                                 uint16_t start, uint16_t end, uint16_t width)
+{
+    struct ssd1306_layout_line *line = &layout->lines[layout->line_count++];
+
+    line->start = start;
+    line->length = end - start;
+    line->width = width;
+}
+
+/**
+ * @brief Returns the width of an ellipsis, or 0 if the font has no '.'.
+ * @param font Pointer to a ssd1306_font struct.
+ */
+static uint16_t _ssd1306_ellipsis_width(const struct ssd1306_font *font)
+{
+    int32_t c = ssd1306_font_glyph(font, '.');
+
+    if (c < 0)
+        return 0;
+
+    return 3u * ssd1306_glyph_width(font, c) +
+           2u * font->horizontal_separation;
+}
+
+/**
+ * @brief Shortens the last line of a layout until an ellipsis fits after its
+ *        last glyph.
+ * @param t Pointer to a ssd1306_text struct.
+ * @param layout Pointer to a ssd1306_layout struct.
+ */
+static void _ssd1306_layout_ellipsis(struct ssd1306_text *t,
+                                     struct ssd1306_layout *layout)
+{
+    const struct ssd1306_font *font = t->font;
+    struct ssd1306_layout_line *line = &layout->lines[layout->line_count - 1];
+    const char *str = layout->str + line->start;
+    uint16_t length = line->length;
+    uint16_t dots = _ssd1306_ellipsis_width(font);
+    uint16_t pen = 0;
+
+    line->length = 0;
+    line->width = dots;
+
+    for (uint16_t i = 0, n; i < length; i += n) {
+        uint32_t code;
+        int32_t c;
+
+        n = ssd1306_utf8_decode(str + i, &code);
+        c = ssd1306_font_glyph(font, code);
+        if (code == ' ') {
+            pen += font->space_width;
+        } else if (c >= 0) {
+            uint16_t end = pen + ssd1306_glyph_width(font, c);
+            uint16_t width = end + font->horizontal_separation + dots;
+
+            if (width > layout->box.width)
+                break;
+            line->length = i + n;
+            line->width = width;
+            pen = end;
+            if (str[i + n] != ' ')
+                pen += font->horizontal_separation;
+        }
+    }
+
+    layout->ellipsis = dots != 0;
+}
+
+uint8_t ssd1306_layout_text(struct ssd1306_text *t,
+                            struct ssd1306_layout *layout, const char *str,
+                            const struct ssd1306_rect *box,
+                            enum ssd1306_text_align align)
+{
+    const struct ssd1306_font *font = t->font;
+    uint8_t line_height = font->page_alignment << 3u;
+    uint8_t max_lines = box->height / line_height;
+    uint8_t truncated = 0;
+    uint16_t start = 0;   /* First character of the current line. */
+    uint16_t pen = 0;     /* Advance from the start of the line. */
+    uint16_t ink = 0;     /* Line width up to the last character. */
+    uint16_t brk = 0;     /* Last space of the line, if greater than start. */
+    uint16_t brk_end = 0; /* First space of the run of spaces at brk. */
+    uint16_t brk_ink = 0; /* Line width before brk_end. */
+    uint16_t brk_pen = 0; /* Advance after brk. */
+    uint8_t n = 1;        /* Bytes of the current character. */
+
+    if (max_lines > SSD1306_LAYOUT_MAX_LINES)
+        max_lines = SSD1306_LAYOUT_MAX_LINES;
+
+    layout->str = str;
+    layout->box = *box;
+    layout->line_height = line_height;
+    layout->line_count = 0;
+    layout->ellipsis = 0;
+
+    for (uint16_t i = 0; max_lines; i += n) {
+        uint32_t c;
+
+        n = ssd1306_utf8_decode(str + i, &c);
+
+        if (c == 0x00 || c == '\n') {
+            _ssd1306_layout_push(layout, start, i, ink);
+            if (c == 0x00)
+                break;
+            if (layout->line_count == max_lines) {
+                truncated = str[i + 1] != 0x00;
+                break;
+            }
+            start = i + 1;
+            pen = ink = brk = 0;
+            continue;
+        }
+
+        if (c == ' ') {
+            if (i == start) {
+                start++;
+                continue;
+            }
+            if (str[i - 1] != ' ') {
+                brk_end = i;
+                brk_ink = ink;
+            }
+            brk = i;
+            pen += font->space_width;
+            brk_pen = pen;
+            continue;
+        }
+
+        int32_t x = ssd1306_font_glyph(font, c);
+
+        if (x < 0)
+            continue;
+
+        uint8_t w = ssd1306_glyph_width(font, x);
+
+        if (pen + w > box->width && i > start && brk > start) {
+            _ssd1306_layout_push(layout, start, brk_end, brk_ink);
+            if (layout->line_count == max_lines) {
+                truncated = 1;
+                break;
+            }
+            start = brk + 1;
+            pen -= brk_pen;
+            ink = i > start ? ink - brk_pen : 0;
+            brk = 0;
+        }
+
+        if (pen + w > box->width && i > start) {
+            _ssd1306_layout_push(layout, start, i, ink);
+            if (layout->line_count == max_lines) {
+                truncated = 1;
+                break;
+            }
+            start = i;
+            pen = ink = brk = 0;
+        }
+
+        ink = pen + w;
+        pen = ink;
+        if (str[i + n] != ' ')
+            pen += font->horizontal_separation;
+    }
+
+    if (truncated)
+        _ssd1306_layout_ellipsis(t, layout);
+
+    int16_t left = box->width;
+    int16_t right = 0;
+
+    for (uint8_t k = 0; k < layout->line_count; k++) {
+        struct ssd1306_layout_line *line = &layout->lines[k];
+
+        if (align == SSD1306_ALIGN_CENTER)
+            line->x = ((int16_t)box->width - line->width) / 2;
+        else if (align == SSD1306_ALIGN_RIGHT)
+            line->x = (int16_t)box->width - line->width;
+        else
+            line->x = 0;
+
+        if (line->x < left)
+            left = line->x;
+        if (line->x + line->width > right)
+            right = line->x + line->width;
+    }
+
+    layout->bounds.x = box->x + (layout->line_count ? left : 0);
+    layout->bounds.y = box->y;
+    layout->bounds.width = layout->line_count ? right - left : 0;
+    layout->bounds.height = layout->line_count * line_height;
+
+    return truncated;
+}
+
+void ssd1306_draw_layout(struct ssd1306_text *t,
+                         const struct ssd1306_layout *layout,
+                         enum ssd1306_raster_op op)
+{
+    int16_t y = layout->box.y;
+
+    for (uint8_t k = 0; k < layout->line_count; k++) {
+        const struct ssd1306_layout_line *line = &layout->lines[k];
+        int16_t x = layout->box.x + line->x;
+
+        _ssd1306_draw_glyphs(t, x, y, layout->str + line->start, line->length,
+                             op);
+
+        if (layout->ellipsis && k + 1u == layout->line_count) {
+            x = layout->box.x + line->x + line->width -
+                _ssd1306_ellipsis_width(t->font);
+            _ssd1306_draw_glyphs(t, x, y, "...", 3u, op);
+        }
+        y += layout->line_height;
+    }
+}
+
+uint16_t ssd1306_text_width(struct ssd1306_text *t, const char *str)
 {
     uint16_t i = 0;
     uint16_t width = 0;
 
     while (str[i]) {
-        if (str[i] == ' ') {
-            width += t->font->space_width;
-        } else if (str[i] >= t->font->first_char &&
-                   str[i] <= t->font->last_char) {
-            uint8_t x = str[i] - t->font->first_char;
+        uint32_t c;
+        uint8_t n = ssd1306_utf8_decode(str + i, &c);
+        int32_t x = ssd1306_font_glyph(t->font, c);
 
-            uint8_t w = t->font->type == SSD1306_VARIABLE_WIDTH_FONT
-                            ? t->font->char_width[x]
-                            : t->font->space_width;
+        if (c == ' ') {
+            width += t->font->space_width;
+        } else if (x >= 0) {
+            uint8_t w = ssd1306_glyph_width(t->font, x);
 
-            if (str[i + 1] == ' ' || str[i + 1] == 0x00)
+            if (str[i + n] == ' ' || str[i + n] == 0x00)
                 width += w;
             else
                 width += w + t->font->horizontal_separation;
         }
 
-        i++;
+        i += n;
     }
 
     return width;
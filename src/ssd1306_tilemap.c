@@ -0,0 +1,130 @@
+/**
+ * @file ssd1306_tilemap.c
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief This file provides a character-cell layer on top of the text
+ *        rendering functions. Only the cells that changed since the last
+ *        render are drawn again.
+ */
+
+#include "ssd1306/ssd1306_tilemap.h"
+#include "ssd1306/ssd1306_graphics.h"
+#include <stddef.h>
+
+/**
+ * @brief Adds a window to the list, growing the last window if it is full.
+ * @param windows Array of windows.
+ * @param count Number of windows in the array.
+ * @param max_windows Size of the array.
+ * @param area Modified area.
+ * @return Number of windows in the array.
+ */
+static uint8_t _ssd1306_tilemap_window(struct ssd1306_rect *windows,
+                                       uint8_t count, uint8_t max_windows,
+                                       const struct ssd1306_rect *area)
+{
+    if (!windows || !max_windows)
+        return 0;
+
+    if (count < max_windows) {
+        windows[count] = *area;
+        return count + 1u;
+    }
+
+    struct ssd1306_rect *last = &windows[count - 1u];
+    int16_t right = last->x + last->width;
+    int16_t bottom = last->y + last->height;
+
+    if (area->x < last->x)
+        last->x = area->x;
+    if (area->y < last->y)
+        last->y = area->y;
+    if (area->x + area->width > right)
+        right = area->x + area->width;
+    if (area->y + area->height > bottom)
+        bottom = area->y + area->height;
+    last->width = right - last->x;
+    last->height = bottom - last->y;
+    return count;
+}
+
+void ssd1306_tilemap_init(struct ssd1306_tilemap *map)
+{
+    const struct ssd1306_font *font = map->text->font;
+    uint8_t width = font->space_width;
+
+    if (font->type == SSD1306_VARIABLE_WIDTH_FONT) {
+        for (uint16_t c = 0; c < ssd1306_font_glyphs(font); c++) {
+            if (font->char_width[c] > width)
+                width = font->char_width[c];
+        }
+    }
+
+    map->cell_width = width + font->horizontal_separation;
+    map->cell_height = font->page_alignment << 3u;
+
+    for (uint16_t i = 0; i < map->cols * map->rows; i++) {
+        map->cells[i] = SSD1306_TILEMAP_BLANK;
+    }
+    map->valid = 0;
+}
+
+void ssd1306_tilemap_print(struct ssd1306_tilemap *map, uint8_t col,
+                           uint8_t row, const char *str)
+{
+    if (row >= map->rows)
+        return;
+
+    uint16_t *cells = map->cells + row * map->cols;
+
+    for (uint8_t n; *str && col < map->cols; str += n, col++) {
+        uint32_t c;
+        int32_t glyph;
+
+        n = ssd1306_utf8_decode(str, &c);
+        glyph = c == ' ' ? -1 : ssd1306_font_glyph(map->text->font, c);
+        cells[col] = glyph < 0 ? SSD1306_TILEMAP_BLANK : (uint16_t)glyph;
+    }
+}
+
+uint8_t ssd1306_tilemap_render(struct ssd1306_tilemap *map,
+                               struct ssd1306_rect *windows,
+                               uint8_t max_windows)
+{
+    struct ssd1306_rect area = {.height = map->cell_height};
+    uint8_t count = 0;
+
+    for (uint8_t row = 0; row < map->rows; row++) {
+        uint16_t *cells = map->cells + row * map->cols;
+        uint16_t *drawn = map->drawn + row * map->cols;
+        int16_t y = map->y + row * map->cell_height;
+        uint8_t run = 0;
+
+        area.y = y;
+
+        for (uint8_t col = 0; col <= map->cols; col++) {
+            if (col < map->cols && (!map->valid || cells[col] != drawn[col])) {
+                int16_t x = map->x + col * map->cell_width;
+
+                ssd1306_clear_rect(map->text->bitmap, x, y, map->cell_width,
+                                   map->cell_height);
+                if (cells[col] != SSD1306_TILEMAP_BLANK)
+                    ssd1306_draw_glyph(map->text, x, y, cells[col],
+                                       SSD1306_ROP_OR);
+                drawn[col] = cells[col];
+                run++;
+                continue;
+            }
+
+            if (run) {
+                area.x = map->x + (col - run) * map->cell_width;
+                area.width = run * map->cell_width;
+                count = _ssd1306_tilemap_window(windows, count, max_windows,
+                                                &area);
+                run = 0;
+            }
+        }
+    }
+
+    map->valid = 1;
+    return count;
+}
@@ -0,0 +1,60 @@
+/**
+ * @file test.c
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief Host-side test harness.
+ */
+
+#include "test.h"
+#include "ssd1306_mock.h"
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @brief Number of failed checks of the running test case.
+ */
+static uint32_t test_failed_checks;
+
+/**
+ * @brief Number of failed test cases.
+ */
+static uint32_t test_failed_cases;
+
+void test_check(int ok, const char *expr, const char *file, int line)
+{
+    if (ok)
+        return;
+    test_failed_checks++;
+    printf("  %s:%d: check failed: %s\n", file, line, expr);
+}
+
+void test_check_transfer(uint16_t n, uint8_t dc, const uint8_t *bytes,
+                         uint16_t length, const char *file, int line)
+{
+    uint16_t recorded_length;
+    const uint8_t *recorded;
+
+    if (n >= ssd1306_mock.transfers) {
+        test_check(0, "transfer recorded", file, line);
+        return;
+    }
+
+    recorded = ssd1306_mock_transfer(n, &recorded_length);
+    test_check(ssd1306_mock.dc[n] == dc, "D/C level", file, line);
+    test_check(recorded_length == length &&
+                   !memcmp(recorded, bytes, length),
+               "transfer bytes", file, line);
+}
+
+void test_run(const char *name, test_fn fn)
+{
+    test_failed_checks = 0;
+    fn();
+    if (test_failed_checks)
+        test_failed_cases++;
+    printf("%s %s\n", test_failed_checks ? "FAIL" : "ok  ", name);
+}
+
+uint32_t test_failures(void)
+{
+    return test_failed_cases;
+}
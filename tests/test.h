@@ -0,0 +1,144 @@
+/**
+ * @file test.h
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief Host-side test harness. Failed checks are printed with their
+ *        location and the test program exits with a non-zero status.
+ */
+
+#ifndef __SSD1306_TEST_H
+#define __SSD1306_TEST_H
+
+#include <stdint.h>
+
+/**
+ * @brief Test case.
+ */
+typedef void (*test_fn)(void);
+
+/**
+ * @brief Checks a condition.
+ * @param COND Condition expected to be true.
+ */
+#define TEST_ASSERT(COND) test_check((COND), #COND, __FILE__, __LINE__)
+
+/**
+ * @brief Checks a transfer recorded by the mock transport.
+ * @param N Transfer number.
+ * @param DC Expected SPI D/C level.
+ * @param ... Expected bytes, including the I2C control byte.
+ */
+#define TEST_TRANSFER(N, DC, ...)                                              \
+    test_check_transfer((N), (DC), (const uint8_t[]){__VA_ARGS__},             \
+                        sizeof((const uint8_t[]){__VA_ARGS__}), __FILE__,      \
+                        __LINE__)
+
+/**
+ * @brief Records the result of a check, printing it if it failed.
+ * @param ok Result of the check.
+ * @param expr Checked expression.
+ * @param file Source file of the check.
+ * @param line Source line of the check.
+ */
+void test_check(int ok, const char *expr, const char *file, int line);
+
+/**
+ * @brief Checks that a recorded transfer holds the expected bytes and was
+ *        sent with the expected D/C level.
+ * @param n Transfer number.
+ * @param dc Expected SPI D/C level.
+ * @param bytes Expected bytes.
+ * @param length Number of expected bytes.
+ * @param file Source file of the check.
+ * @param line Source line of the check.
+ */
+void test_check_transfer(uint16_t n, uint8_t dc, const uint8_t *bytes,
+                         uint16_t length, const char *file, int line);
+
+/**
+ * @brief Runs a test case and prints its result.
+ * @param name Test name.
+ * @param fn Test case.
+ */
+void test_run(const char *name, test_fn fn);
+
+/**
+ * @brief Returns the number of failed test cases.
+ */
+uint32_t test_failures(void);
+
+/**
+ * @brief Transport tests.
+ */
+void test_transport(void);
+
+/**
+ * @brief Asynchronous queue tests.
+ */
+void test_async(void);
+
+/**
+ * @brief Emulator tests.
+ */
+void test_emulator(void);
+
+/**
+ * @brief Font encoding tests.
+ */
+void test_font(void);
+
+/**
+ * @brief Seven-segment readout tests.
+ */
+void test_segment(void);
+
+/**
+ * @brief Marquee tests.
+ */
+void test_marquee(void);
+
+/**
+ * @brief Display list tests.
+ */
+void test_display_list(void);
+
+/**
+ * @brief Span kernel and line tests.
+ */
+void test_graphics(void);
+
+/**
+ * @brief Bulk bitmap operation tests.
+ */
+void test_bitmap(void);
+
+/**
+ * @brief Sprite tests.
+ */
+void test_sprite(void);
+
+/**
+ * @brief Text rendering tests.
+ */
+void test_text(void);
+
+/**
+ * @brief Tilemap tests.
+ */
+void test_tilemap(void);
+
+/**
+ * @brief Console tests.
+ */
+void test_console(void);
+
+/**
+ * @brief Numeric field tests.
+ */
+void test_number(void);
+
+/**
+ * @brief Transport counter tests, run by ssd1306-stats-tests.
+ */
+void test_stats(void);
+
+#endif /* !__SSD1306_TEST_H */
@@ -0,0 +1,169 @@
+/**
+ * @file test_async.c
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief Checks the asynchronous transfer queue with the mock transport,
+ *        which completes the transfer on the wire on demand.
+ */
+
+#include "ssd1306/ssd1306.h"
+#include "ssd1306_mock.h"
+#include "test.h"
+#include <string.h>
+
+static struct ssd1306_driver test_driver;
+
+static struct ssd1306_async test_queue;
+
+/**
+ * @brief Attaches the mock I2C transport in asynchronous mode. Transfers are
+ *        only completed by ssd1306_mock_complete.
+ */
+static void test_setup(void)
+{
+    memset(&test_driver, 0, sizeof(test_driver));
+    ssd1306_mock_attach(&test_driver, &ssd1306_i2c_transport, &test_queue);
+    ssd1306_mock.auto_complete = 0;
+}
+
+static void test_commands_are_copied(void)
+{
+    uint8_t data[2] = {0x01, 0x02};
+
+    test_setup();
+    ssd1306_set_contrast(&test_driver, 0x20);
+    ssd1306_write_gddram(&test_driver, data, sizeof(data));
+
+    TEST_ASSERT(ssd1306_async_pending(&test_driver) == 2u);
+    TEST_ASSERT(ssd1306_mock.pending_count == 2u);
+    TEST_ASSERT(ssd1306_mock.transfers == 0);
+
+    /* The command was copied into the queue and the data is sent in place,
+     * so only the data change is seen on the bus. */
+    data[0] = 0x03;
+    TEST_ASSERT(ssd1306_mock_complete());
+    TEST_ASSERT(ssd1306_async_pending(&test_driver) == 1u);
+    TEST_ASSERT(ssd1306_mock_complete());
+    TEST_ASSERT(!ssd1306_mock_complete());
+    TEST_TRANSFER(0, 0, 0x00, 0x81, 0x20);
+    TEST_TRANSFER(1, 0, 0x40, 0x03, 0x02);
+}
+
+static void test_buffer_busy(void)
+{
+    uint8_t data[64] = {0};
+
+    test_setup();
+    ssd1306_write_gddram(&test_driver, data + 16, 16);
+
+    TEST_ASSERT(ssd1306_async_buffer_busy(&test_driver, data, sizeof(data)));
+    TEST_ASSERT(ssd1306_async_buffer_busy(&test_driver, data + 31, 1));
+    TEST_ASSERT(!ssd1306_async_buffer_busy(&test_driver, data, 16));
+    TEST_ASSERT(!ssd1306_async_buffer_busy(&test_driver, data + 32, 32));
+
+    ssd1306_mock_complete();
+    TEST_ASSERT(!ssd1306_async_buffer_busy(&test_driver, data, sizeof(data)));
+}
+
+static void test_completion_starts_next(void)
+{
+    test_setup();
+    ssd1306_set_normal_display(&test_driver);
+    ssd1306_set_inverse_display(&test_driver);
+    ssd1306_set_normal_display(&test_driver);
+
+    TEST_ASSERT(test_queue.busy);
+    for (uint8_t n = 3; n > 0; n--) {
+        TEST_ASSERT(ssd1306_async_pending(&test_driver) == n);
+        TEST_ASSERT(ssd1306_mock.pending_count == 2u);
+        ssd1306_mock_complete();
+    }
+    TEST_ASSERT(!test_queue.busy);
+    TEST_TRANSFER(0, 0, 0x00, 0xA6);
+    TEST_TRANSFER(1, 0, 0x00, 0xA7);
+    TEST_TRANSFER(2, 0, 0x00, 0xA6);
+}
+
+static void test_full_queue_waits(void)
+{
+    test_setup();
+    for (uint8_t i = 0; i < SSD1306_ASYNC_QUEUE_LENGTH; i++) {
+        ssd1306_set_contrast(&test_driver, i);
+    }
+    TEST_ASSERT(ssd1306_async_pending(&test_driver) ==
+                SSD1306_ASYNC_QUEUE_LENGTH);
+    TEST_ASSERT(ssd1306_mock.transfers == 0);
+
+    /* The next transfer yields until the first one has been completed. */
+    ssd1306_mock.auto_complete = 1;
+    ssd1306_set_contrast(&test_driver, SSD1306_ASYNC_QUEUE_LENGTH);
+    TEST_ASSERT(ssd1306_mock.transfers == 1u);
+    TEST_ASSERT(ssd1306_async_pending(&test_driver) ==
+                SSD1306_ASYNC_QUEUE_LENGTH);
+
+    ssd1306_async_wait(&test_driver);
+    TEST_ASSERT(ssd1306_mock.transfers == SSD1306_ASYNC_QUEUE_LENGTH + 1u);
+    for (uint8_t i = 0; i <= SSD1306_ASYNC_QUEUE_LENGTH; i++) {
+        TEST_TRANSFER(i, 0, 0x00, 0x81, i);
+    }
+}
+
+static void test_window_is_queued(void)
+{
+    static uint8_t buffer[SSD1306_FRAMEBUFFER_SIZE(128, 64)];
+    struct ssd1306_bitmap bm = {
+        .width = 128,
+        .height = 64,
+        .length = sizeof(buffer),
+        .data = buffer,
+    };
+    uint16_t length;
+
+    test_setup();
+    test_driver.addressing_mode = HORIZONTAL_ADDRESSING_MODE;
+    memset(buffer, 0x55, sizeof(buffer));
+    ssd1306_update_gddram_pages(&test_driver, &bm, 0, 7);
+
+    /* The update returns with the bitmap still on the bus. */
+    TEST_ASSERT(ssd1306_async_pending(&test_driver) == 2u);
+    TEST_ASSERT(ssd1306_async_buffer_busy(&test_driver, buffer,
+                                          sizeof(buffer)));
+
+    ssd1306_mock_complete();
+    ssd1306_mock_complete();
+    TEST_ASSERT(!ssd1306_async_buffer_busy(&test_driver, buffer,
+                                           sizeof(buffer)));
+    TEST_TRANSFER(0, 0, 0x00, 0x21, 0, 127, 0x22, 0, 7);
+    TEST_ASSERT(ssd1306_mock_transfer(1, &length)[0] == 0x40);
+    TEST_ASSERT(length == sizeof(buffer) + 1u);
+}
+
+static void test_spi_dc_per_transfer(void)
+{
+    uint8_t data[2] = {0x01, 0x02};
+
+    memset(&test_driver, 0, sizeof(test_driver));
+    ssd1306_mock_attach(&test_driver, &ssd1306_spi_transport, &test_queue);
+    ssd1306_mock.auto_complete = 0;
+    ssd1306_write_gddram(&test_driver, data, sizeof(data));
+    ssd1306_set_start_line(&test_driver, 0);
+    ssd1306_write_gddram(&test_driver, data, 1);
+
+    /* The D/C level is set when each transfer is started. */
+    TEST_ASSERT(ssd1306_mock.dc_level == 1u);
+    while (ssd1306_mock_complete()) {
+    }
+    TEST_ASSERT(ssd1306_mock.transfers == 3u);
+    TEST_TRANSFER(0, 1, 0x01, 0x02);
+    TEST_TRANSFER(1, 0, 0x40);
+    TEST_TRANSFER(2, 1, 0x01);
+}
+
+void test_async(void)
+{
+    test_run("async_commands_are_copied", test_commands_are_copied);
+    test_run("async_buffer_busy", test_buffer_busy);
+    test_run("async_completion_starts_next", test_completion_starts_next);
+    test_run("async_full_queue_waits", test_full_queue_waits);
+    test_run("async_window_is_queued", test_window_is_queued);
+    test_run("async_spi_dc_per_transfer", test_spi_dc_per_transfer);
+}
@@ -0,0 +1,212 @@
+/**
+ * @file test_bitmap.c
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief Checks the word-wide bitmap operations against byte-wise results,
+ *        for data that is not aligned to a word, widths that are not a
+ *        multiple of 8 and the reserved-byte layout.
+ */
+
+#include "ssd1306/ssd1306_bitmap.h"
+#include "test.h"
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @brief Bytes around the bitmap data that must never be written.
+ */
+#define TEST_GUARD 16u
+
+/**
+ * @brief Value of the guard bytes.
+ */
+#define TEST_GUARD_VALUE 0x5Au
+
+static uint8_t test_dst[TEST_GUARD + 8u + 1024u + TEST_GUARD];
+
+static uint8_t test_src[TEST_GUARD + 8u + 1024u + TEST_GUARD];
+
+/** Offset of the bitmap data from a word boundary. */
+static uint8_t test_offset;
+
+/** Width of the bitmaps of the running test case. */
+static uint8_t test_width;
+
+/** 1 if the bitmaps of the running test case reserve their first byte. */
+static uint8_t test_reserved;
+
+/**
+ * @brief Sets up a bitmap whose data starts test_offset bytes after an
+ *        aligned address, and fills its buffer with a pattern.
+ * @param bm Pointer to the ssd1306_bitmap struct to set up.
+ * @param buffer Buffer, with guard bytes around the data.
+ * @param seed Pattern seed.
+ */
+static void test_setup(struct ssd1306_bitmap *bm, uint8_t *buffer,
+                       uint8_t seed)
+{
+    uint8_t *aligned = buffer + TEST_GUARD;
+
+    aligned += (8u - (uintptr_t)aligned % 8u) % 8u;
+    memset(buffer, TEST_GUARD_VALUE, sizeof(test_dst));
+    memset(bm, 0, sizeof(*bm));
+    bm->width = test_width;
+    bm->height = 64;
+    bm->data = aligned + test_offset;
+    bm->length = ssd1306_bitmap_size(bm) + test_reserved;
+    for (uint16_t i = 0; i < bm->length; i++) {
+        bm->data[i] = (uint8_t)(i * 29u + seed * 83u + (i >> 3u));
+    }
+}
+
+/**
+ * @brief Checks that nothing outside of the bitmap data was written.
+ * @param bm Pointer to a ssd1306_bitmap struct.
+ * @param buffer Buffer holding the bitmap data.
+ * @return 1 if every byte outside of the data is intact, 0 otherwise.
+ */
+static uint8_t test_guards(const struct ssd1306_bitmap *bm,
+                           const uint8_t *buffer)
+{
+    for (const uint8_t *b = buffer; b < buffer + sizeof(test_dst); b++) {
+        if ((b < bm->data || b >= bm->data + bm->length) &&
+            *b != TEST_GUARD_VALUE)
+            return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Checks that every page is dirty from column 0 to the width.
+ * @param bm Pointer to a ssd1306_bitmap struct.
+ * @return 1 if every page is dirty, 0 otherwise.
+ */
+static uint8_t test_all_dirty(const struct ssd1306_bitmap *bm)
+{
+    for (uint8_t p = 0; p < ssd1306_bitmap_pages(bm); p++) {
+        if (bm->dirty_start[p] != 0 || bm->dirty_end[p] != bm->width)
+            return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Runs every operation on bitmaps of test_width columns, at the
+ *        current offset and layout.
+ */
+static void test_ops_layout(void)
+{
+    static const uint8_t pattern[8] = {0x01, 0x23, 0x45, 0x67,
+                                       0x89, 0xAB, 0xCD, 0xEF};
+    static const enum ssd1306_raster_op ops[] = {
+        SSD1306_ROP_COPY, SSD1306_ROP_OR, SSD1306_ROP_AND, SSD1306_ROP_XOR};
+    static uint8_t before[1024];
+    struct ssd1306_bitmap dst;
+    struct ssd1306_bitmap src;
+    uint16_t size;
+    uint8_t reserved;
+
+    test_setup(&dst, test_dst, 1);
+    size = ssd1306_bitmap_size(&dst);
+
+    ssd1306_bitmap_clear(&dst);
+    for (uint16_t i = 0; i < size; i++) {
+        TEST_ASSERT(ssd1306_bitmap_pixels(&dst)[i] == 0x00);
+    }
+    TEST_ASSERT(test_all_dirty(&dst));
+
+    ssd1306_bitmap_reset_dirty(&dst);
+    ssd1306_bitmap_fill(&dst, pattern);
+    for (uint8_t p = 0; p < 8u; p++) {
+        for (uint8_t x = 0; x < test_width; x++) {
+            TEST_ASSERT(ssd1306_bitmap_page(&dst, p)[x] == pattern[x & 7u]);
+        }
+    }
+    TEST_ASSERT(test_all_dirty(&dst));
+
+    test_setup(&dst, test_dst, 2);
+    memcpy(before, ssd1306_bitmap_pixels(&dst), size);
+    ssd1306_bitmap_invert(&dst);
+    for (uint16_t i = 0; i < size; i++) {
+        uint8_t inverted = before[i] ^ 0xFFu;
+
+        TEST_ASSERT(ssd1306_bitmap_pixels(&dst)[i] == inverted);
+    }
+    TEST_ASSERT(test_all_dirty(&dst));
+
+    for (uint8_t k = 0; k < sizeof(ops) / sizeof(ops[0]); k++) {
+        test_setup(&dst, test_dst, 3);
+        test_setup(&src, test_src, 4);
+        memcpy(before, ssd1306_bitmap_pixels(&dst), size);
+        TEST_ASSERT(!ssd1306_bitmap_merge(&dst, &src, ops[k]));
+        for (uint16_t i = 0; i < size; i++) {
+            uint8_t s = ssd1306_bitmap_pixels(&src)[i];
+            uint8_t d = before[i];
+            uint8_t expected = ops[k] == SSD1306_ROP_COPY  ? s
+                               : ops[k] == SSD1306_ROP_OR  ? (uint8_t)(d | s)
+                               : ops[k] == SSD1306_ROP_AND ? (uint8_t)(d & s)
+                                                           : (uint8_t)(d ^ s);
+
+            TEST_ASSERT(ssd1306_bitmap_pixels(&dst)[i] == expected);
+        }
+        TEST_ASSERT(test_all_dirty(&dst));
+        TEST_ASSERT(test_guards(&dst, test_dst));
+    }
+    TEST_ASSERT(ssd1306_bitmap_merge(&dst, &src, SSD1306_ROP_MASK));
+
+    test_setup(&dst, test_dst, 5);
+    test_setup(&src, test_src, 6);
+    reserved = dst.data[0];
+    TEST_ASSERT(!ssd1306_bitmap_copy(&dst, &src));
+    TEST_ASSERT(!memcmp(ssd1306_bitmap_pixels(&dst),
+                        ssd1306_bitmap_pixels(&src), size));
+    TEST_ASSERT(test_guards(&dst, test_dst));
+    if (test_reserved)
+        TEST_ASSERT(dst.data[0] == reserved);
+
+    /* Bitmaps of a different size are rejected. */
+    src.height = 32;
+    TEST_ASSERT(ssd1306_bitmap_copy(&dst, &src));
+    TEST_ASSERT(ssd1306_bitmap_merge(&dst, &src, SSD1306_ROP_OR));
+}
+
+static void test_ops(void)
+{
+    for (test_reserved = 0; test_reserved < 2u; test_reserved++) {
+        for (test_offset = 0; test_offset < 8u; test_offset++) {
+            test_ops_layout();
+        }
+    }
+}
+
+static void test_band_clear(void)
+{
+    uint8_t data[2 * 128];
+    struct ssd1306_bitmap band = {
+        .width = 128,
+        .height = 64,
+        .length = sizeof(data),
+        .data = data,
+        .band_page = 3,
+        .band_pages = 2,
+    };
+
+    memset(data, 0xFF, sizeof(data));
+    ssd1306_bitmap_clear(&band);
+    for (uint8_t p = 0; p < SSD1306_MAX_PAGES; p++) {
+        TEST_ASSERT(band.dirty_end[p] == (p == 3u || p == 4u ? 128u : 0u));
+    }
+    TEST_ASSERT(data[0] == 0x00 && data[sizeof(data) - 1u] == 0x00);
+}
+
+void test_bitmap(void)
+{
+    static const uint8_t widths[] = {128, 13, 8, 1};
+    char name[64];
+
+    for (uint8_t w = 0; w < sizeof(widths); w++) {
+        test_width = widths[w];
+        snprintf(name, sizeof(name), "bitmap_ops_width_%u", test_width);
+        test_run(name, test_ops);
+    }
+    test_run("bitmap_band_clear", test_band_clear);
+}
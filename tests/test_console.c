@@ -0,0 +1,221 @@
+/**
+ * @file test_console.c
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief Prints to a console in the emulator, on 128x32 and 128x64 panels,
+ *        and checks the rows seen on the panel, the start line and that new
+ *        lines are sent to hidden rows when the panel has them.
+ */
+
+#include "ssd1306/font/ssd1306_font_5x7.h"
+#include "ssd1306/font/ssd1306_font_7x11.h"
+#include "ssd1306/ssd1306_console.h"
+#include "ssd1306_emulator.h"
+#include "test.h"
+#include <stdio.h>
+#include <string.h>
+
+static uint8_t test_buffer[SSD1306_FRAMEBUFFER_SIZE(128, 64)];
+
+static uint8_t test_ref_buffer[SSD1306_FRAMEBUFFER_SIZE(128, 64)];
+
+static struct ssd1306_bitmap test_bm = {
+    .width = 128,
+    .height = 64,
+    .length = sizeof(test_buffer),
+    .data = test_buffer,
+};
+
+static struct ssd1306_bitmap test_ref_bm = {
+    .width = 128,
+    .height = 64,
+    .length = sizeof(test_ref_buffer),
+    .data = test_ref_buffer,
+};
+
+static struct ssd1306_driver test_driver;
+
+static struct ssd1306_emulator test_emu;
+
+/** Lines printed by the running test case. */
+static char test_lines[20][16];
+
+/** Rows of the panel of the running test case. */
+static uint8_t test_rows;
+
+/** GDDRAM before the last transfer. */
+static uint8_t test_before[SSD1306_MAX_PAGES][SSD1306_EMULATOR_WIDTH];
+
+/** 1 while the GDDRAM writes are checked against the rows seen. */
+static uint8_t test_watch;
+
+/** 1 if a GDDRAM page was written while it was seen on the panel. */
+static uint8_t test_seen;
+
+/** I2C scatter-gather write function of the emulator. */
+static void (*test_emu_writev)(uint8_t, const struct ssd1306_iovec *, uint8_t);
+
+/**
+ * @brief Checks the panel against the last lines printed, drawn from the
+ *        top of a blank bitmap.
+ * @param t Pointer to the ssd1306_text struct of the console.
+ * @param printed Number of lines printed.
+ */
+static void test_panel(struct ssd1306_text *t, uint8_t printed)
+{
+    struct ssd1306_text ref = {.bitmap = &test_ref_bm, .font = t->font};
+    uint8_t line_height = t->font->page_alignment << 3u;
+    uint8_t lines = test_rows / line_height;
+    uint8_t first = printed > lines ? printed - lines : 0;
+    uint8_t ok = 1;
+
+    memset(test_ref_buffer, 0, sizeof(test_ref_buffer));
+    for (uint8_t k = first; k < printed; k++) {
+        ssd1306_draw_text_at(&ref, 0, (k - first) * line_height,
+                             test_lines[k], SSD1306_ROP_COPY);
+    }
+
+    for (uint8_t y = 0; y < test_rows; y++) {
+        for (uint8_t x = 0; x < 128u; x++) {
+            uint8_t expected =
+                (test_ref_buffer[(y >> 3u) * 128u + x] >> (y & 7u)) & 1u;
+
+            if (ssd1306_emulator_pixel(&test_emu, x, y) != expected)
+                ok = 0;
+        }
+    }
+    TEST_ASSERT(ok);
+    TEST_ASSERT(test_emu.start_line == test_bm.ring_page << 3u);
+}
+
+/**
+ * @brief Returns 1 if a GDDRAM page is seen on the panel at the current
+ *        start line.
+ * @param page GDDRAM page.
+ */
+static uint8_t test_visible(uint8_t page)
+{
+    uint8_t row = (page * 8u - test_emu.start_line) & 0x3Fu;
+
+    return row < test_rows;
+}
+
+/**
+ * @brief Passes a transfer to the emulator, and flags the GDDRAM pages it
+ *        changed if they are seen on the panel.
+ */
+static void test_writev(uint8_t address, const struct ssd1306_iovec *iov,
+                        uint8_t count)
+{
+    test_emu_writev(address, iov, count);
+    if (!test_watch)
+        return;
+    for (uint8_t p = 0; p < SSD1306_MAX_PAGES; p++) {
+        if (memcmp(test_before[p], test_emu.gddram[p],
+                   SSD1306_EMULATOR_WIDTH) &&
+            test_visible(p))
+            test_seen = 1;
+    }
+    memcpy(test_before, test_emu.gddram, sizeof(test_before));
+}
+
+/**
+ * @brief Prints lines until the console has scrolled twice around the
+ *        GDDRAM, checking the panel after each one.
+ * @param font Pointer to a ssd1306_font struct.
+ */
+static void test_print(const struct ssd1306_font *font)
+{
+    struct ssd1306_text t = {.bitmap = &test_bm, .font = font};
+    struct ssd1306_console con = {.driver = &test_driver,
+                                  .text = &t,
+                                  .rows = test_rows == 64u ? 0 : test_rows};
+    uint8_t align = font->page_alignment;
+    uint8_t line_height = align << 3u;
+    uint8_t lines = test_rows / line_height;
+    uint8_t hidden = test_rows + line_height <= 64 &&
+                     test_rows % line_height == 0;
+
+    memset(&test_driver, 0, sizeof(test_driver));
+    ssd1306_emulator_attach(&test_driver, &test_emu, &ssd1306_i2c_transport);
+    test_emu_writev = test_driver.i2c_writev;
+    test_driver.i2c_writev = test_writev;
+    ssd1306_set_addressing_mode(&test_driver, HORIZONTAL_ADDRESSING_MODE);
+    test_emu.display_on = 1;
+    test_emu.mux_ratio = test_rows - 1u;
+    memset(test_emu.gddram, 0xA5, sizeof(test_emu.gddram));
+    test_bm.ring_page = 3;
+
+    TEST_ASSERT(!ssd1306_console_init(&con));
+    TEST_ASSERT(test_bm.ring_page == 0u && test_emu.start_line == 0u);
+    test_panel(&t, 0);
+
+    for (uint8_t k = 0; k < sizeof(test_lines) / sizeof(test_lines[0]);
+         k++) {
+        uint32_t data_bytes = test_emu.data_bytes;
+
+        /* Once full, a panel with hidden rows gets the new line there
+         * before it is scrolled in. */
+        memcpy(test_before, test_emu.gddram, sizeof(test_before));
+        test_watch = k >= lines && hidden;
+        test_seen = 0;
+        snprintf(test_lines[k], sizeof(test_lines[k]), "Line %u", k);
+        ssd1306_console_print(&con, test_lines[k]);
+        test_watch = 0;
+        TEST_ASSERT(!test_seen);
+        test_panel(&t, k + 1u);
+
+        /* Only the pages of the new line are sent. */
+        TEST_ASSERT(test_emu.data_bytes - data_bytes == align * 128u);
+        TEST_ASSERT(con.line == (k < lines ? k + 1u : lines));
+    }
+}
+
+static void test_print_5x7(void)
+{
+    test_print(&font_5x7);
+}
+
+static void test_print_7x11(void)
+{
+    test_print(&font_7x11);
+}
+
+static void test_init(void)
+{
+    struct ssd1306_text t = {.bitmap = &test_bm, .font = &font_7x11};
+    struct ssd1306_console con = {.driver = &test_driver, .text = &t};
+    struct ssd1306_bitmap band = test_bm;
+
+    memset(&test_driver, 0, sizeof(test_driver));
+    ssd1306_emulator_attach(&test_driver, &test_emu, &ssd1306_i2c_transport);
+
+    con.rows = 12;
+    TEST_ASSERT(ssd1306_console_init(&con));
+    con.rows = 72;
+    TEST_ASSERT(ssd1306_console_init(&con));
+    /* The font is taller than the panel. */
+    con.rows = 8;
+    TEST_ASSERT(ssd1306_console_init(&con));
+
+    con.rows = 32;
+    band.band_pages = 4;
+    band.length = 4 * 128;
+    t.bitmap = &band;
+    TEST_ASSERT(ssd1306_console_init(&con));
+    TEST_ASSERT(test_emu.data_bytes == 0u);
+}
+
+void test_console(void)
+{
+    static const uint8_t rows[] = {32, 64};
+    char name[64];
+
+    for (uint8_t i = 0; i < sizeof(rows); i++) {
+        test_rows = rows[i];
+        snprintf(name, sizeof(name), "console_128x%u_5x7", test_rows);
+        test_run(name, test_print_5x7);
+        snprintf(name, sizeof(name), "console_128x%u_7x11", test_rows);
+        test_run(name, test_print_7x11);
+    }
+    test_run("console_init", test_init);
+}
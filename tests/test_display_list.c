@@ -0,0 +1,132 @@
+/**
+ * @file test_display_list.c
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief Renders a display list band by band into the emulator and checks
+ *        the GDDRAM against the same draw calls on a full frame bitmap.
+ */
+
+#include "ssd1306/font/ssd1306_font_5x7.h"
+#include "ssd1306/ssd1306_display_list.h"
+#include "ssd1306/ssd1306_graphics.h"
+#include "ssd1306/ssd1306_text.h"
+#include "ssd1306_emulator.h"
+#include "test.h"
+#include <stdio.h>
+#include <string.h>
+
+static uint8_t test_frame_buffer[SSD1306_FRAMEBUFFER_SIZE(128, 64)];
+
+static struct ssd1306_bitmap test_frame = {
+    .width = 128,
+    .height = 64,
+    .length = sizeof(test_frame_buffer),
+    .data = test_frame_buffer,
+};
+
+static uint8_t test_band_buffer[SSD1306_FRAMEBUFFER_SIZE(128, 64)];
+
+static struct ssd1306_driver test_driver;
+
+static struct ssd1306_emulator test_emu;
+
+static int8_t test_poly_x[] = {70, 120, 100, 80};
+static int8_t test_poly_y[] = {10, 20, 60, 50};
+
+static int8_t test_polyline_x[] = {0, 20, 40, 60};
+static int8_t test_polyline_y[] = {63, 40, 63, 30};
+
+static const char test_short[] = "Band";
+static const char test_long[] = "This text is too long for a line";
+
+/** Pages of the band of the running test case. */
+static uint8_t test_band_pages;
+
+/**
+ * @brief Draws the display list entries directly on the full frame.
+ */
+static void test_draw_frame(void)
+{
+    struct ssd1306_text t = {.bitmap = &test_frame, .font = &font_5x7};
+
+    memset(test_frame_buffer, 0, sizeof(test_frame_buffer));
+    ssd1306_draw_line(&test_frame, 3, 2, 120, 61);
+    ssd1306_draw_circle(&test_frame, 30, 4, 12);
+    ssd1306_draw_polygon(&test_frame, test_poly_x, test_poly_y, 4);
+    ssd1306_draw_polyline(&test_frame, test_polyline_x, test_polyline_y, 4);
+    ssd1306_set_cursor_position(&t, 40, 2);
+    ssd1306_draw_text(&t, test_short);
+    ssd1306_set_cursor_position(&t, 60, 5);
+    ssd1306_draw_text(&t, test_long);
+    ssd1306_set_cursor_position(&t, 0, 9);
+    ssd1306_draw_text(&t, test_short);
+}
+
+static void test_render(void)
+{
+    struct ssd1306_dl_entry entries[8];
+    struct ssd1306_display_list dl = {.entries = entries,
+                                      .capacity = 7};
+    struct ssd1306_bitmap band = {
+        .width = 128,
+        .height = 64,
+        .length = (uint16_t)(128u * test_band_pages),
+        .data = test_band_buffer,
+        .band_pages = test_band_pages,
+    };
+
+    memset(&test_driver, 0, sizeof(test_driver));
+    ssd1306_emulator_attach(&test_driver, &test_emu, &ssd1306_i2c_transport);
+    ssd1306_set_addressing_mode(&test_driver, HORIZONTAL_ADDRESSING_MODE);
+    memset(test_emu.gddram, 0xA5, sizeof(test_emu.gddram));
+
+    TEST_ASSERT(!ssd1306_dl_line(&dl, 3, 2, 120, 61));
+    TEST_ASSERT(!ssd1306_dl_circle(&dl, 30, 4, 12));
+    TEST_ASSERT(!ssd1306_dl_polygon(&dl, test_poly_x, test_poly_y, 4));
+    TEST_ASSERT(
+        !ssd1306_dl_polyline(&dl, test_polyline_x, test_polyline_y, 4));
+    TEST_ASSERT(!ssd1306_dl_text(&dl, &font_5x7, 40, 2, test_short));
+    TEST_ASSERT(!ssd1306_dl_text(&dl, &font_5x7, 60, 5, test_long));
+    TEST_ASSERT(!ssd1306_dl_text(&dl, &font_5x7, 0, 9, test_short));
+    TEST_ASSERT(ssd1306_dl_line(&dl, 0, 0, 1, 1));
+    TEST_ASSERT(dl.count == 7u);
+
+    ssd1306_dl_render(&test_driver, &dl, &band);
+    test_draw_frame();
+
+    TEST_ASSERT(test_emu.data_bytes == sizeof(test_frame_buffer));
+    for (uint8_t p = 0; p < SSD1306_MAX_PAGES; p++) {
+        TEST_ASSERT(!memcmp(test_emu.gddram[p],
+                            ssd1306_bitmap_page(&test_frame, p),
+                            SSD1306_EMULATOR_WIDTH));
+    }
+    TEST_ASSERT(band.band_page == 0u && !ssd1306_bitmap_is_dirty(&band));
+}
+
+static void test_empty_poly(void)
+{
+    struct ssd1306_dl_entry entries[2];
+    struct ssd1306_display_list dl = {.entries = entries,
+                                      .capacity = 2};
+
+    /* Polygons without points are rejected without reading them. */
+    TEST_ASSERT(ssd1306_dl_polygon(&dl, NULL, NULL, 0));
+    TEST_ASSERT(ssd1306_dl_polyline(&dl, NULL, NULL, 0));
+    TEST_ASSERT(dl.count == 0u);
+
+    TEST_ASSERT(!ssd1306_dl_polygon(&dl, test_poly_x, test_poly_y, 1));
+    TEST_ASSERT(dl.count == 1u);
+    TEST_ASSERT(entries[0].top == 10 && entries[0].bottom == 10);
+}
+
+void test_display_list(void)
+{
+    static const uint8_t bands[] = {1, 3, 8};
+    char name[64];
+
+    for (uint8_t i = 0; i < sizeof(bands); i++) {
+        test_band_pages = bands[i];
+        snprintf(name, sizeof(name), "display_list_band_%u", bands[i]);
+        test_run(name, test_render);
+    }
+    test_run("display_list_empty_poly", test_empty_poly);
+}
@@ -0,0 +1,207 @@
+/**
+ * @file test_emulator.c
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief Drives the GDDRAM update functions into the emulator and checks
+ *        that its GDDRAM matches the bitmap, for both transports, the three
+ *        addressing modes, split transfers and asynchronous mode.
+ */
+
+#include "ssd1306/ssd1306.h"
+#include "ssd1306/ssd1306_graphics.h"
+#include "ssd1306_emulator.h"
+#include "test.h"
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @brief Ways of sending the transfers.
+ */
+enum test_variant {
+    TEST_BLOCKING,     /**< Blocking transfers. */
+    TEST_MAX_TRANSFER, /**< Display data split in 7-byte transfers. */
+    TEST_ASYNC,        /**< Asynchronous transfers. */
+    TEST_VARIANTS,
+};
+
+static uint8_t test_buffer[SSD1306_FRAMEBUFFER_SIZE(128, 64)];
+
+static struct ssd1306_bitmap test_bm = {
+    .width = 128,
+    .height = 64,
+    .length = sizeof(test_buffer),
+    .data = test_buffer,
+};
+
+static uint8_t test_frame[SSD1306_BUFFER_SIZE(128, 64)];
+
+static uint8_t test_shadow_buffer[128 * 64 / 8];
+
+static struct ssd1306_shadow test_shadow = {
+    .data = test_shadow_buffer,
+    .length = sizeof(test_shadow_buffer),
+};
+
+static struct ssd1306_driver test_driver;
+
+static struct ssd1306_async test_queue;
+
+static struct ssd1306_emulator test_emu;
+
+/** Transport of the running test case. */
+static const struct ssd1306_transport *test_bus;
+
+/** Addressing mode of the running test case. */
+static enum ssd1306_addressing_mode test_mode;
+
+/** Variant of the running test case. */
+static enum test_variant test_variant;
+
+/**
+ * @brief Fills the bitmap with a pattern that differs for each seed.
+ * @param seed Pattern seed.
+ */
+static void test_fill(uint8_t seed)
+{
+    for (uint16_t i = 0; i < sizeof(test_buffer); i++) {
+        test_buffer[i] = (uint8_t)(i * 37u + seed * 101u + (i >> 7u));
+    }
+}
+
+/**
+ * @brief Waits for the queued transfers and checks the emulator GDDRAM
+ *        against the bitmap.
+ */
+static void test_compare(void)
+{
+    ssd1306_async_wait(&test_driver);
+    TEST_ASSERT(ssd1306_async_pending(&test_driver) == 0);
+    for (uint8_t p = 0; p < SSD1306_MAX_PAGES; p++) {
+        const uint8_t *page = ssd1306_bitmap_page(&test_bm, p);
+
+        TEST_ASSERT(!memcmp(test_emu.gddram[p], page, SSD1306_EMULATOR_WIDTH));
+    }
+}
+
+/**
+ * @brief Updates the whole GDDRAM with ssd1306_update_gddram and with a
+ *        window, then a window, the dirty areas and the bytes that differ
+ *        from the shadow, checking the emulator after each one.
+ */
+static void test_updates(void)
+{
+    memset(&test_driver, 0, sizeof(test_driver));
+    ssd1306_emulator_attach(&test_driver, &test_emu, test_bus);
+    if (test_variant == TEST_ASYNC) {
+        memset(&test_queue, 0, sizeof(test_queue));
+        test_driver.async = &test_queue;
+    }
+    if (test_variant == TEST_MAX_TRANSFER)
+        test_driver.max_transfer = 7;
+    ssd1306_set_addressing_mode(&test_driver, test_mode);
+
+    /* The legacy frame has its pixels after the reserved byte. */
+    test_fill(3);
+    memcpy(test_frame + 1, test_buffer, sizeof(test_buffer));
+    test_fill(1);
+    ssd1306_update_gddram(&test_driver, test_frame, sizeof(test_frame));
+    ssd1306_async_wait(&test_driver);
+    for (uint8_t p = 0; p < SSD1306_MAX_PAGES; p++) {
+        TEST_ASSERT(!memcmp(test_emu.gddram[p], test_frame + 1 + p * 128u,
+                            SSD1306_EMULATOR_WIDTH));
+    }
+
+    ssd1306_update_gddram_window(&test_driver, &test_bm, 0, 127, 0, 7);
+    test_compare();
+
+    /* Only the window changes. */
+    test_fill(2);
+    for (uint8_t p = 0; p < SSD1306_MAX_PAGES; p++) {
+        uint8_t *page = ssd1306_bitmap_page(&test_bm, p);
+
+        if (p < 2 || p > 5) {
+            memcpy(page, test_emu.gddram[p], SSD1306_EMULATOR_WIDTH);
+        } else {
+            memcpy(page, test_emu.gddram[p], 10);
+            memcpy(page + 41, test_emu.gddram[p] + 41,
+                   SSD1306_EMULATOR_WIDTH - 41u);
+        }
+    }
+    ssd1306_update_gddram_window(&test_driver, &test_bm, 10, 40, 2, 5);
+    test_compare();
+
+    ssd1306_bitmap_reset_dirty(&test_bm);
+    ssd1306_fill_rect(&test_bm, 3, 5, 20, 30, NULL);
+    ssd1306_clear_rect(&test_bm, 90, 40, 37, 9);
+    ssd1306_update_dirty_gddram(&test_driver, &test_bm);
+    test_compare();
+
+    test_shadow.valid = 0;
+    ssd1306_update_gddram_diff(&test_driver, &test_bm, &test_shadow);
+    test_compare();
+    test_buffer[5] ^= 0xFF;
+    test_buffer[300] ^= 0x0F;
+    test_buffer[301] ^= 0xF0;
+    test_buffer[sizeof(test_buffer) - 1u] ^= 0x80;
+    TEST_ASSERT(ssd1306_update_gddram_diff(&test_driver, &test_bm,
+                                           &test_shadow) > 0);
+    test_compare();
+}
+
+/**
+ * @brief Checks that two drivers update their own emulator.
+ */
+static void test_two_emulators(void)
+{
+    struct ssd1306_driver driver = {0};
+    struct ssd1306_emulator emu;
+    uint8_t data[2] = {0xA5, 0x5A};
+
+    memset(&test_driver, 0, sizeof(test_driver));
+    ssd1306_emulator_attach(&test_driver, &test_emu, &ssd1306_i2c_transport);
+    ssd1306_emulator_attach(&driver, &emu, &ssd1306_spi_transport);
+    ssd1306_write_gddram(&driver, data, sizeof(data));
+    ssd1306_write_gddram(&test_driver, data + 1, 1);
+
+    TEST_ASSERT(emu.gddram[0][0] == 0xA5 && emu.gddram[0][1] == 0x5A);
+    TEST_ASSERT(test_emu.gddram[0][0] == 0x5A && test_emu.gddram[0][1] == 0);
+    TEST_ASSERT(emu.transfers == 1u && test_emu.transfers == 1u);
+}
+
+/**
+ * @brief Checks that a transfer larger than the GDDRAM is decoded whole.
+ */
+static void test_long_transfer(void)
+{
+    static uint8_t data[2000];
+
+    memset(&test_driver, 0, sizeof(test_driver));
+    ssd1306_emulator_attach(&test_driver, &test_emu, &ssd1306_i2c_transport);
+    memset(data, 0x11, sizeof(data));
+    ssd1306_write_gddram(&test_driver, data, sizeof(data));
+
+    TEST_ASSERT(test_emu.data_bytes == sizeof(data));
+}
+
+void test_emulator(void)
+{
+    static const char *const buses[] = {"i2c", "spi"};
+    static const char *const modes[] = {"horizontal", "vertical", "page"};
+    static const char *const variants[] = {"blocking", "max_transfer",
+                                           "async"};
+    char name[64];
+
+    for (uint8_t b = 0; b < 2u; b++) {
+        test_bus = b ? &ssd1306_spi_transport : &ssd1306_i2c_transport;
+        for (uint8_t m = 0; m < 3u; m++) {
+            test_mode = (enum ssd1306_addressing_mode)m;
+            for (uint8_t v = 0; v < TEST_VARIANTS; v++) {
+                test_variant = (enum test_variant)v;
+                snprintf(name, sizeof(name), "emulator_%s_%s_%s", buses[b],
+                         modes[m], variants[v]);
+                test_run(name, test_updates);
+            }
+        }
+    }
+    test_run("emulator_two_emulators", test_two_emulators);
+    test_run("emulator_long_transfer", test_long_transfer);
+}
@@ -0,0 +1,85 @@
+/**
+ * @file test_font.c
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief Checks that the RLE encoding of the bundled fonts draws the same
+ *        glyphs as the raw fonts.
+ */
+
+#include "ssd1306/font/ssd1306_font_5x7.h"
+#include "ssd1306/font/ssd1306_font_7seg_17x30.h"
+#include "ssd1306/font/ssd1306_font_7x11.h"
+#include "ssd1306/ssd1306_text.h"
+#include "ssd1306_font_rle.h"
+#include "test.h"
+#include <string.h>
+
+static uint8_t test_raw_buffer[SSD1306_FRAMEBUFFER_SIZE(128, 64)];
+
+static uint8_t test_rle_buffer[SSD1306_FRAMEBUFFER_SIZE(128, 64)];
+
+static struct ssd1306_bitmap test_raw_bm = {
+    .width = 128,
+    .height = 64,
+    .length = sizeof(test_raw_buffer),
+    .data = test_raw_buffer,
+};
+
+static struct ssd1306_bitmap test_rle_bm = {
+    .width = 128,
+    .height = 64,
+    .length = sizeof(test_rle_buffer),
+    .data = test_rle_buffer,
+};
+
+/**
+ * @brief Encodes a raw font and draws each glyph with both encodings, at a
+ *        page-aligned row and at an unaligned one.
+ * @param raw Pointer to a raw ssd1306_font struct.
+ */
+static void test_rle_font(const struct ssd1306_font *raw)
+{
+    static uint8_t data[2048];
+    static uint16_t offsets[256];
+    uint16_t length = ssd1306_font_rle_encode(raw, data, sizeof(data), offsets);
+    struct ssd1306_font rle = *raw;
+    struct ssd1306_text raw_text = {.bitmap = &test_raw_bm, .font = raw};
+    struct ssd1306_text rle_text = {.bitmap = &test_rle_bm, .font = &rle};
+
+    TEST_ASSERT(length > 0);
+    rle.data = data;
+    rle.char_offset = offsets;
+    rle.encoding = SSD1306_RLE_FONT;
+
+    for (uint16_t x = 0; x < ssd1306_font_glyphs(raw); x++) {
+        for (int16_t y = 0; y < 8; y += 3) {
+            memset(test_raw_buffer, 0, sizeof(test_raw_buffer));
+            memset(test_rle_buffer, 0, sizeof(test_rle_buffer));
+            ssd1306_draw_glyph(&raw_text, 1, y, x, SSD1306_ROP_OR);
+            ssd1306_draw_glyph(&rle_text, 1, y, x, SSD1306_ROP_OR);
+            TEST_ASSERT(!memcmp(test_raw_buffer, test_rle_buffer,
+                                sizeof(test_raw_buffer)));
+        }
+    }
+}
+
+static void test_rle_5x7(void)
+{
+    test_rle_font(&font_5x7);
+}
+
+static void test_rle_7x11(void)
+{
+    test_rle_font(&font_7x11);
+}
+
+static void test_rle_7segment(void)
+{
+    test_rle_font(&font_7segment);
+}
+
+void test_font(void)
+{
+    test_run("font_rle_5x7", test_rle_5x7);
+    test_run("font_rle_7x11", test_rle_7x11);
+    test_run("font_rle_7segment", test_rle_7segment);
+}
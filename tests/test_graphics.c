@@ -0,0 +1,357 @@
+/**
+ * @file test_graphics.c
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief Checks the span kernels and the lines drawn with them against a
+ *        per-pixel reference, at unaligned positions and partly outside of
+ *        the bitmap.
+ */
+
+#include "ssd1306/ssd1306_graphics.h"
+#include "test.h"
+#include <string.h>
+
+static uint8_t test_buffer[SSD1306_FRAMEBUFFER_SIZE(128, 64)];
+
+static struct ssd1306_bitmap test_bm = {
+    .width = 128,
+    .height = 64,
+    .length = sizeof(test_buffer),
+    .data = test_buffer,
+};
+
+/** Reference image, one byte per pixel. */
+static uint8_t test_ref[64][128];
+
+/**
+ * @brief Clears the bitmap, its dirty areas and the reference image.
+ * @param fill Value written to every byte of the bitmap and every pixel of
+ *        the reference image (0x00 or 0xFF).
+ */
+static void test_reset(uint8_t fill)
+{
+    memset(test_buffer, fill, sizeof(test_buffer));
+    memset(test_ref, fill & 1u, sizeof(test_ref));
+    ssd1306_bitmap_reset_dirty(&test_bm);
+}
+
+/**
+ * @brief Sets or clears a pixel of the reference image, if it is inside.
+ * @param x Position on the x-axis.
+ * @param y Position on the y-axis.
+ * @param value 1 to set the pixel, 0 to clear it.
+ */
+static void test_plot(int16_t x, int16_t y, uint8_t value)
+{
+    if (x >= 0 && x < 128 && y >= 0 && y < 64)
+        test_ref[y][x] = value;
+}
+
+/**
+ * @brief Checks every pixel of the bitmap against the reference image.
+ * @return 1 if they match, 0 otherwise.
+ */
+static uint8_t test_match(void)
+{
+    for (uint8_t y = 0; y < 64u; y++) {
+        const uint8_t *page = ssd1306_bitmap_page(&test_bm, y >> 3u);
+
+        for (uint8_t x = 0; x < 128u; x++) {
+            if (((page[x] >> (y & 7u)) & 1u) != test_ref[y][x])
+                return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Draws a line in the reference image, one pixel at a time.
+ * @param x1 Start point position on the x-axis.
+ * @param y1 Start point position on the y-axis.
+ * @param x2 End point position on the x-axis.
+ * @param y2 End point position on the y-axis.
+ */
+static void test_ref_line(int16_t x1, int16_t y1, int16_t x2, int16_t y2)
+{
+    int16_t dx = x2 > x1 ? x2 - x1 : x1 - x2;
+    int16_t dy = y2 > y1 ? y1 - y2 : y2 - y1;
+    int16_t sx = x1 < x2 ? 1 : -1;
+    int16_t sy = y1 < y2 ? 1 : -1;
+    int16_t e = dx + dy;
+
+    for (;;) {
+        int16_t de = 2 * e;
+
+        test_plot(x1, y1, 1);
+        if (de >= dy) {
+            if (x1 == x2)
+                break;
+            e += dy;
+            x1 += sx;
+        }
+        if (de <= dx) {
+            if (y1 == y2)
+                break;
+            e += dx;
+            y1 += sy;
+        }
+    }
+}
+
+static void test_hline(void)
+{
+    static const int8_t xs[] = {-9, -1, 0, 3, 7, 8, 61, 120, 127};
+    static const uint8_t ws[] = {1, 2, 5, 8, 9, 17, 64, 200};
+
+    for (uint8_t i = 0; i < sizeof(xs); i++) {
+        for (uint8_t j = 0; j < sizeof(ws); j++) {
+            for (int8_t y = -1; y < 65; y += 5) {
+                test_reset(0x00);
+                ssd1306_draw_hline(&test_bm, xs[i], y, ws[j]);
+                for (int16_t k = 0; k < ws[j]; k++) {
+                    test_plot(xs[i] + k, y, 1);
+                }
+                TEST_ASSERT(test_match());
+            }
+        }
+    }
+}
+
+static void test_vline(void)
+{
+    static const uint8_t hs[] = {1, 2, 3, 7, 8, 9, 15, 16, 33, 64, 100};
+
+    for (int8_t y = -10; y < 64; y++) {
+        for (uint8_t j = 0; j < sizeof(hs); j++) {
+            test_reset(0x00);
+            ssd1306_draw_vline(&test_bm, 5, y, hs[j]);
+            ssd1306_draw_vline(&test_bm, -1, y, hs[j]);
+            for (int16_t k = 0; k < hs[j]; k++) {
+                test_plot(5, y + k, 1);
+            }
+            TEST_ASSERT(test_match());
+            if (y + hs[j] > 0)
+                TEST_ASSERT(test_bm.dirty_end[y < 0 ? 0 : y >> 3u] == 6u);
+
+            test_reset(0xFF);
+            ssd1306_clear_vline(&test_bm, 127, y, hs[j]);
+            for (int16_t k = 0; k < hs[j]; k++) {
+                test_plot(127, y + k, 0);
+            }
+            TEST_ASSERT(test_match());
+        }
+    }
+}
+
+static void test_line(void)
+{
+    static const int8_t ps[][2] = {{0, 0},   {3, 5},   {10, 62}, {127, 1},
+                                   {64, 31}, {65, 33}, {100, 7}, {9, 9},
+                                   {126, 63}};
+    const uint8_t n = sizeof(ps) / sizeof(ps[0]);
+
+    for (uint8_t i = 0; i < n; i++) {
+        for (uint8_t j = 0; j < n; j++) {
+            test_reset(0x00);
+            ssd1306_draw_line(&test_bm, ps[i][0], ps[i][1], ps[j][0],
+                              ps[j][1]);
+            test_ref_line(ps[i][0], ps[i][1], ps[j][0], ps[j][1]);
+            TEST_ASSERT(test_match());
+        }
+    }
+}
+
+static void test_band(void)
+{
+    uint8_t band_data[3 * 128];
+    struct ssd1306_bitmap band = {
+        .width = 128,
+        .height = 64,
+        .length = sizeof(band_data),
+        .data = band_data,
+        .band_page = 2,
+        .band_pages = 3,
+    };
+
+    /* Only the rows 16 to 39 are held, the rest is clipped. */
+    memset(band_data, 0, sizeof(band_data));
+    ssd1306_draw_vline(&band, 10, 0, 64);
+    ssd1306_draw_hline(&band, 0, 15, 128);
+    ssd1306_draw_hline(&band, 20, 39, 8);
+    ssd1306_draw_hline(&band, 0, 40, 128);
+    for (uint8_t p = 0; p < 3u; p++) {
+        TEST_ASSERT(band_data[p * 128u + 10u] == 0xFF);
+    }
+    TEST_ASSERT(band_data[2u * 128u + 20u] == 0x80);
+    TEST_ASSERT(band_data[2u * 128u + 27u] == 0x80);
+    TEST_ASSERT(band_data[2u * 128u + 28u] == 0x00);
+    TEST_ASSERT(band_data[0] == 0x00 && band_data[127] == 0x00);
+    TEST_ASSERT(band.dirty_end[1] == 0 && band.dirty_end[5] == 0);
+}
+
+/**
+ * @brief Fills a polygon in the reference image with the even-odd rule, one
+ *        row at a time, from the crossings of the edges with the center of
+ *        each row.
+ * @param x Array containing points x-axis positions.
+ * @param y Array containing points y-axis positions.
+ * @param n Number of points in the array.
+ */
+static void test_ref_polygon(const int8_t *x, const int8_t *y, uint16_t n)
+{
+    for (int16_t row = 0; row < 64; row++) {
+        int16_t nodes[32];
+        uint8_t count = 0;
+
+        for (uint16_t i = 0, j = n - 1; i < n; j = i++) {
+            if ((y[i] <= row && row < y[j]) || (y[j] <= row && row < y[i]))
+                nodes[count++] = x[i] + (int32_t)(2 * (row - y[i]) + 1) *
+                                            (x[j] - x[i]) / (2 * (y[j] - y[i]));
+        }
+        for (uint8_t i = 0; i < count; i++) {
+            for (uint8_t j = i + 1u; j < count; j++) {
+                if (nodes[j] < nodes[i]) {
+                    int16_t t = nodes[i];
+                    nodes[i] = nodes[j];
+                    nodes[j] = t;
+                }
+            }
+        }
+        for (uint8_t i = 0; i + 1u < count; i += 2u) {
+            for (int16_t k = nodes[i]; k <= nodes[i + 1]; k++) {
+                test_plot(k, row, 1);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Copies the bitmap into the reference image.
+ */
+static void test_capture(void)
+{
+    for (uint8_t y = 0; y < 64u; y++) {
+        for (uint8_t x = 0; x < 128u; x++) {
+            test_ref[y][x] = (ssd1306_bitmap_page(&test_bm, y >> 3u)[x] >>
+                              (y & 7u)) & 1u;
+        }
+    }
+}
+
+static void test_fill_circle(void)
+{
+    static const int8_t cs[][3] = {{64, 32, 20}, {10, 5, 9}, {125, 60, 7},
+                                   {40, 33, 0},  {70, 20, 1}, {-3, 30, 12}};
+
+    for (uint8_t i = 0; i < sizeof(cs) / sizeof(cs[0]); i++) {
+        uint8_t solid[sizeof(test_buffer)];
+
+        /* The fill covers the outline and each column is a single span. */
+        test_reset(0x00);
+        ssd1306_draw_circle(&test_bm, cs[i][0], cs[i][1], cs[i][2]);
+        test_capture();
+        ssd1306_fill_circle(&test_bm, cs[i][0], cs[i][1], cs[i][2], NULL);
+        for (uint8_t y = 0; y < 64u; y++) {
+            for (uint8_t x = 0; x < 128u; x++) {
+                if (test_ref[y][x])
+                    TEST_ASSERT(ssd1306_bitmap_page(&test_bm, y >> 3u)[x] &
+                                (1u << (y & 7u)));
+            }
+        }
+        test_capture();
+        for (uint8_t x = 0; x < 128u; x++) {
+            uint8_t edges = 0;
+
+            for (uint8_t y = 1; y < 64u; y++) {
+                edges += test_ref[y][x] != test_ref[y - 1u][x];
+            }
+            TEST_ASSERT(edges <= 2u);
+        }
+
+        /* A pattern fill sets the pixels of the solid fill in the pattern. */
+        memcpy(solid, test_buffer, sizeof(solid));
+        test_reset(0x00);
+        ssd1306_fill_circle(&test_bm, cs[i][0], cs[i][1], cs[i][2],
+                            ssd1306_pattern_dither25);
+        for (uint16_t k = 0; k < sizeof(solid); k++) {
+            TEST_ASSERT(test_buffer[k] ==
+                        (solid[k] & ssd1306_pattern_dither25[k & 7u]));
+        }
+    }
+}
+
+static void test_fill_polygon(void)
+{
+    static const uint8_t all[8] = {0xFF, 0xFF, 0xFF, 0xFF,
+                                   0xFF, 0xFF, 0xFF, 0xFF};
+    /* A concave arrow, a star crossing itself, a sliver partly outside of
+       the bitmap and a triangle inside a square. */
+    static int8_t ax[] = {10, 60, 60, 90, 60, 60, 10, 30};
+    static int8_t ay[] = {20, 20, 5, 33, 62, 45, 45, 33};
+    static int8_t sx[] = {64, 79, 40, 88, 49};
+    static int8_t sy[] = {3, 60, 22, 22, 60};
+    static int8_t lx[] = {-20, 127, 110};
+    static int8_t ly[] = {-5, 14, 70};
+    static int8_t qx[] = {5, 50, 50, 5, 5, 28, 45, 5};
+    static int8_t qy[] = {5, 5, 50, 50, 5, 12, 40, 5};
+    static int8_t *const xs[] = {ax, sx, lx, qx};
+    static int8_t *const ys[] = {ay, sy, ly, qy};
+    static const uint16_t ns[] = {8, 5, 3, 8};
+
+    for (uint8_t i = 0; i < 4u; i++) {
+        test_reset(0x00);
+        TEST_ASSERT(!ssd1306_fill_polygon(&test_bm, xs[i], ys[i], ns[i], all));
+        test_ref_polygon(xs[i], ys[i], ns[i]);
+        TEST_ASSERT(test_match());
+
+        /* Solid polygons also get their outline. */
+        ssd1306_draw_polygon(&test_bm, xs[i], ys[i], ns[i]);
+        test_capture();
+        memset(test_buffer, 0, sizeof(test_buffer));
+        TEST_ASSERT(!ssd1306_fill_polygon(&test_bm, xs[i], ys[i], ns[i], NULL));
+        TEST_ASSERT(test_match());
+    }
+}
+
+static void test_fill_polygon_nodes(void)
+{
+    int8_t x[2u * SSD1306_POLYGON_MAX_NODES];
+    int8_t y[2u * SSD1306_POLYGON_MAX_NODES];
+    uint16_t n = 0;
+
+    /* A comb whose teeth cross row 30 SSD1306_POLYGON_MAX_NODES + 2 times. */
+    for (uint8_t t = 0; t < SSD1306_POLYGON_MAX_NODES / 2u + 1u; t++) {
+        x[n] = 4 + 6 * t;
+        y[n++] = 40;
+        x[n] = 7 + 6 * t;
+        y[n++] = 20;
+    }
+    x[n] = x[n - 1];
+    y[n++] = 50;
+    x[n] = 4;
+    y[n++] = 50;
+
+    test_reset(0x00);
+    TEST_ASSERT(ssd1306_fill_polygon(&test_bm, x, y, n, NULL));
+    TEST_ASSERT(test_match());
+    TEST_ASSERT(!ssd1306_bitmap_is_dirty(&test_bm));
+
+    /* Without the top of the last tooth it fits. */
+    n -= 3u;
+    x[n] = x[n - 1];
+    y[n++] = 50;
+    x[n] = 4;
+    y[n++] = 50;
+    TEST_ASSERT(!ssd1306_fill_polygon(&test_bm, x, y, n, NULL));
+    TEST_ASSERT(!test_match());
+}
+
+void test_graphics(void)
+{
+    test_run("graphics_hline", test_hline);
+    test_run("graphics_vline", test_vline);
+    test_run("graphics_line", test_line);
+    test_run("graphics_band", test_band);
+    test_run("graphics_fill_circle", test_fill_circle);
+    test_run("graphics_fill_polygon", test_fill_polygon);
+    test_run("graphics_fill_polygon_nodes", test_fill_polygon_nodes);
+}
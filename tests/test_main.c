@@ -0,0 +1,26 @@
+/**
+ * @file test_main.c
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief Runs every host-side test.
+ */
+
+#include "test.h"
+
+int main(void)
+{
+    test_transport();
+    test_async();
+    test_emulator();
+    test_font();
+    test_segment();
+    test_marquee();
+    test_display_list();
+    test_graphics();
+    test_bitmap();
+    test_sprite();
+    test_text();
+    test_tilemap();
+    test_console();
+    test_number();
+    return test_failures() ? 1 : 0;
+}
@@ -0,0 +1,158 @@
+/**
+ * @file test_marquee.c
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief Drives a marquee into the emulator and checks that the text
+ *        repeats every m->length columns, whether the SSD1306 scrolls it or
+ *        it is stepped one column at a time, with or without the SSD1306B
+ *        one-column scroll.
+ */
+
+#include "ssd1306/font/ssd1306_font_5x7.h"
+#include "ssd1306/ssd1306_marquee.h"
+#include "ssd1306_emulator.h"
+#include "test.h"
+#include <string.h>
+
+static uint8_t test_buffer[SSD1306_FRAMEBUFFER_SIZE(128, 64)];
+
+static struct ssd1306_bitmap test_bm = {
+    .width = 128,
+    .height = 64,
+    .length = sizeof(test_buffer),
+    .data = test_buffer,
+};
+
+static struct ssd1306_text test_marquee_text = {.bitmap = &test_bm,
+                                                .font = &font_5x7};
+
+static struct ssd1306_driver test_driver;
+
+static struct ssd1306_emulator test_emu;
+
+/**
+ * @brief Starts a marquee of "AB", 14 columns, and a 2-column gap on page 2
+ *        of the emulator.
+ * @param m Pointer to the ssd1306_marquee struct to start.
+ * @param frames Frames between steps.
+ * @param ssd1306b 1 if the controller is a SSD1306B.
+ */
+static void test_start(struct ssd1306_marquee *m, uint16_t frames,
+                       uint8_t ssd1306b)
+{
+    memset(&test_driver, 0, sizeof(test_driver));
+    memset(test_buffer, 0, sizeof(test_buffer));
+    ssd1306_emulator_attach(&test_driver, &test_emu, &ssd1306_i2c_transport);
+    memset(m, 0, sizeof(*m));
+    m->driver = &test_driver;
+    m->text = &test_marquee_text;
+    m->str = "AB";
+    m->page = 2;
+    m->gap = 2;
+    m->frames = frames;
+    m->ssd1306b = ssd1306b;
+    TEST_ASSERT(!ssd1306_marquee_start(m));
+    TEST_ASSERT(m->length == 16u);
+}
+
+/**
+ * @brief Moves the marquee one step, by itself or through the SSD1306.
+ * @param m Pointer to a ssd1306_marquee struct.
+ */
+static void test_step(struct ssd1306_marquee *m)
+{
+    if (m->hardware)
+        ssd1306_emulator_tick(&test_emu, m->frames);
+    else
+        ssd1306_marquee_step(m);
+}
+
+/**
+ * @brief Checks that the marquee page of the emulator repeats after
+ *        m->length steps and not before.
+ * @param m Pointer to a ssd1306_marquee struct.
+ */
+static void test_period(struct ssd1306_marquee *m)
+{
+    uint8_t first[SSD1306_EMULATOR_WIDTH];
+
+    memcpy(first, test_emu.gddram[2], sizeof(first));
+    TEST_ASSERT(memchr(first, 0x7E, sizeof(first)) != NULL);
+    for (uint16_t k = 1; k < m->length; k++) {
+        test_step(m);
+        TEST_ASSERT(memcmp(first, test_emu.gddram[2], sizeof(first)));
+    }
+    test_step(m);
+    TEST_ASSERT(!memcmp(first, test_emu.gddram[2], sizeof(first)));
+}
+
+static void test_hardware(void)
+{
+    struct ssd1306_marquee m;
+
+    test_start(&m, 2, 1);
+    TEST_ASSERT(m.hardware);
+    TEST_ASSERT(test_emu.scroll_active);
+    test_period(&m);
+}
+
+/**
+ * @brief Checks a marquee stepped one column at a time.
+ * @param ssd1306b 1 if the controller is a SSD1306B.
+ */
+static void test_software(uint8_t ssd1306b)
+{
+    struct ssd1306_marquee m;
+    uint32_t data_bytes;
+
+    test_start(&m, 7, ssd1306b);
+    TEST_ASSERT(!m.hardware);
+
+    /* The text enters from the right until it fills the display. */
+    for (uint16_t k = 0; k < test_bm.width; k++) {
+        ssd1306_marquee_step(&m);
+    }
+    test_period(&m);
+
+    /* A SSD1306B gets the new column, other controllers the whole page. */
+    data_bytes = test_emu.data_bytes;
+    ssd1306_marquee_step(&m);
+    TEST_ASSERT(test_emu.data_bytes - data_bytes ==
+                (ssd1306b ? 1u : test_bm.width));
+}
+
+static void test_software_ssd1306b(void)
+{
+    test_software(1);
+}
+
+static void test_software_ssd1306(void)
+{
+    test_software(0);
+}
+
+static void test_hardware_length(void)
+{
+    struct ssd1306_marquee m;
+
+    /* 20 columns don't divide the display, so the marquee is stepped. */
+    memset(&test_driver, 0, sizeof(test_driver));
+    ssd1306_emulator_attach(&test_driver, &test_emu, &ssd1306_i2c_transport);
+    memset(&m, 0, sizeof(m));
+    m.driver = &test_driver;
+    m.text = &test_marquee_text;
+    m.str = "AB";
+    m.gap = 6;
+    m.frames = 2;
+    m.ssd1306b = 1;
+    TEST_ASSERT(!ssd1306_marquee_start(&m));
+    TEST_ASSERT(m.length == 20u && !m.hardware);
+    TEST_ASSERT(!test_emu.scroll_active);
+}
+
+void test_marquee(void)
+{
+    test_run("marquee_hardware", test_hardware);
+    test_run("marquee_software_ssd1306b", test_software_ssd1306b);
+    test_run("marquee_software_ssd1306", test_software_ssd1306);
+    test_run("marquee_hardware_length", test_hardware_length);
+}
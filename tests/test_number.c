@@ -0,0 +1,263 @@
+/**
+ * @file test_number.c
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief Checks the characters and pixels of numeric fields drawing
+ *        integers, fixed-point and floating-point values, the dashes drawn
+ *        when a value doesn't fit, and that only changed cells are drawn.
+ */
+
+#include "ssd1306/font/ssd1306_font_5x7.h"
+#include "ssd1306/ssd1306_number.h"
+#include "test.h"
+#include <math.h>
+#include <string.h>
+
+static uint8_t test_buffer[SSD1306_FRAMEBUFFER_SIZE(128, 64)];
+
+static uint8_t test_ref_buffer[SSD1306_FRAMEBUFFER_SIZE(128, 64)];
+
+static struct ssd1306_bitmap test_bm = {
+    .width = 128,
+    .height = 64,
+    .length = sizeof(test_buffer),
+    .data = test_buffer,
+};
+
+static struct ssd1306_bitmap test_ref_bm = {
+    .width = 128,
+    .height = 64,
+    .length = sizeof(test_ref_buffer),
+    .data = test_ref_buffer,
+};
+
+static struct ssd1306_text test_number_text = {.bitmap = &test_bm,
+                                               .font = &font_5x7};
+
+static struct ssd1306_text test_ref_text = {.bitmap = &test_ref_bm,
+                                            .font = &font_5x7};
+
+static char test_drawn[16];
+
+/**
+ * @brief Sets up a field at an unaligned position of a blank bitmap.
+ * @param n Pointer to the ssd1306_number struct to set up.
+ * @param width Number of characters.
+ * @param precision Digits after the decimal point.
+ */
+static void test_setup(struct ssd1306_number *n, uint8_t width,
+                       uint8_t precision)
+{
+    memset(test_buffer, 0, sizeof(test_buffer));
+    memset(n, 0, sizeof(*n));
+    n->text = &test_number_text;
+    n->x = 5;
+    n->y = 13;
+    n->width = width;
+    n->precision = precision;
+    n->drawn = test_drawn;
+    TEST_ASSERT(!ssd1306_number_init(n));
+}
+
+/**
+ * @brief Checks the characters of a field, and its pixels against the
+ *        characters drawn one by one, centered in their cells.
+ * @param n Pointer to a ssd1306_number struct.
+ * @param str Expected characters, n->width of them.
+ * @return 1 if the field matches, 0 otherwise.
+ */
+static uint8_t test_field(const struct ssd1306_number *n, const char *str)
+{
+    const struct ssd1306_font *font = n->text->font;
+    uint8_t x = n->x;
+
+    if (strlen(str) != n->width || memcmp(n->drawn, str, n->width))
+        return 0;
+
+    memset(test_ref_buffer, 0, sizeof(test_ref_buffer));
+    for (uint8_t i = 0; i < n->width; i++) {
+        uint8_t point = str[i] == '.' && n->precision;
+        uint8_t w = point ? n->point_width : n->cell_width;
+        int32_t glyph = ssd1306_font_glyph(font, str[i]);
+
+        if (str[i] != ' ') {
+            uint8_t pad = w - font->horizontal_separation -
+                          ssd1306_glyph_width(font, glyph);
+
+            ssd1306_draw_glyph(&test_ref_text, x + pad / 2u, n->y, glyph,
+                               SSD1306_ROP_OR);
+        }
+        x += w;
+    }
+    TEST_ASSERT(x == n->x + ssd1306_number_width(n));
+
+    return !memcmp(test_buffer, test_ref_buffer, sizeof(test_buffer));
+}
+
+static void test_int(void)
+{
+    struct ssd1306_number n;
+
+    test_setup(&n, 6, 0);
+    TEST_ASSERT(!ssd1306_draw_int(&n, 42) && test_field(&n, "    42"));
+    TEST_ASSERT(!ssd1306_draw_int(&n, -42) && test_field(&n, "   -42"));
+    TEST_ASSERT(!ssd1306_draw_int(&n, 0) && test_field(&n, "     0"));
+    TEST_ASSERT(!ssd1306_draw_int(&n, 999999) && test_field(&n, "999999"));
+    TEST_ASSERT(!ssd1306_draw_int(&n, -99999) && test_field(&n, "-99999"));
+
+    /* Values that don't fit are drawn as dashes. */
+    TEST_ASSERT(ssd1306_draw_int(&n, 1000000) && test_field(&n, "------"));
+    TEST_ASSERT(ssd1306_draw_int(&n, -100000) && test_field(&n, "------"));
+    TEST_ASSERT(!ssd1306_draw_int(&n, 7) && test_field(&n, "     7"));
+
+    n.zero_pad = 1;
+    TEST_ASSERT(!ssd1306_draw_int(&n, 42) && test_field(&n, "000042"));
+    TEST_ASSERT(!ssd1306_draw_int(&n, -42) && test_field(&n, "-00042"));
+
+    test_setup(&n, 11, 0);
+    TEST_ASSERT(!ssd1306_draw_int(&n, INT32_MIN) &&
+                test_field(&n, "-2147483648"));
+    TEST_ASSERT(!ssd1306_draw_int(&n, INT32_MAX) &&
+                test_field(&n, " 2147483647"));
+
+    /* A field without room for a digit after the sign. */
+    test_setup(&n, 1, 0);
+    TEST_ASSERT(!ssd1306_draw_int(&n, 9) && test_field(&n, "9"));
+    TEST_ASSERT(ssd1306_draw_int(&n, -1) && test_field(&n, "-"));
+}
+
+static void test_decimal(void)
+{
+    struct ssd1306_number n;
+
+    test_setup(&n, 7, 2);
+    TEST_ASSERT(!ssd1306_draw_int(&n, 12) && test_field(&n, "  12.00"));
+    TEST_ASSERT(!ssd1306_draw_decimal(&n, 1234) && test_field(&n, "  12.34"));
+    TEST_ASSERT(!ssd1306_draw_decimal(&n, -5) && test_field(&n, "  -0.05"));
+    TEST_ASSERT(!ssd1306_draw_decimal(&n, 0) && test_field(&n, "   0.00"));
+    TEST_ASSERT(!ssd1306_draw_decimal(&n, 99999) &&
+                test_field(&n, " 999.99"));
+    TEST_ASSERT(!ssd1306_draw_decimal(&n, -99999) &&
+                test_field(&n, "-999.99"));
+    TEST_ASSERT(ssd1306_draw_decimal(&n, 1000000) &&
+                test_field(&n, "----.--"));
+    TEST_ASSERT(ssd1306_draw_decimal(&n, -100000) &&
+                test_field(&n, "----.--"));
+    TEST_ASSERT(ssd1306_draw_int(&n, 10000) && test_field(&n, "----.--"));
+
+    /* Precisions above the maximum are rejected. */
+    n.precision = SSD1306_NUMBER_MAX_PRECISION + 1u;
+    n.width = 12;
+    TEST_ASSERT(ssd1306_draw_decimal(&n, 1));
+}
+
+static void test_fixed(void)
+{
+    struct ssd1306_number n;
+
+    test_setup(&n, 7, 2);
+    TEST_ASSERT(!ssd1306_draw_fixed(&n, 0x18000, 16) &&
+                test_field(&n, "   1.50"));
+    TEST_ASSERT(!ssd1306_draw_fixed(&n, -0x18000, 16) &&
+                test_field(&n, "  -1.50"));
+    /* 1/3 rounds down, 0.005 rounds up. */
+    TEST_ASSERT(!ssd1306_draw_fixed(&n, 21845, 16) &&
+                test_field(&n, "   0.33"));
+    TEST_ASSERT(!ssd1306_draw_fixed(&n, 328, 16) &&
+                test_field(&n, "   0.01"));
+    /* Rounding carries into the integer part. */
+    TEST_ASSERT(!ssd1306_draw_fixed(&n, 0x1FFFF, 16) &&
+                test_field(&n, "   2.00"));
+    TEST_ASSERT(!ssd1306_draw_fixed(&n, 7, 0) && test_field(&n, "   7.00"));
+    TEST_ASSERT(!ssd1306_draw_fixed(&n, INT32_MIN, 31) &&
+                test_field(&n, "  -1.00"));
+    TEST_ASSERT(ssd1306_draw_fixed(&n, 1, 32) && test_field(&n, "----.--"));
+    TEST_ASSERT(ssd1306_draw_fixed(&n, 10000 << 8, 8) &&
+                test_field(&n, "----.--"));
+}
+
+static void test_float(void)
+{
+    struct ssd1306_number n;
+
+    test_setup(&n, 7, 2);
+    TEST_ASSERT(!ssd1306_draw_float(&n, 3.14159f) &&
+                test_field(&n, "   3.14"));
+    TEST_ASSERT(!ssd1306_draw_float(&n, -2.5f) && test_field(&n, "  -2.50"));
+    TEST_ASSERT(!ssd1306_draw_float(&n, 0.999f) && test_field(&n, "   1.00"));
+    /* Values rounded to zero have no sign. */
+    TEST_ASSERT(!ssd1306_draw_float(&n, -0.001f) &&
+                test_field(&n, "   0.00"));
+    TEST_ASSERT(!ssd1306_draw_float(&n, 9999.99f) &&
+                test_field(&n, "9999.99"));
+    TEST_ASSERT(ssd1306_draw_float(&n, 10000.0f) &&
+                test_field(&n, "----.--"));
+    TEST_ASSERT(ssd1306_draw_float(&n, NAN) && test_field(&n, "----.--"));
+    TEST_ASSERT(ssd1306_draw_float(&n, -INFINITY) &&
+                test_field(&n, "----.--"));
+    TEST_ASSERT(ssd1306_draw_float(&n, 1e10f) && test_field(&n, "----.--"));
+}
+
+static void test_changed_cells(void)
+{
+    struct ssd1306_number n;
+    uint8_t page = 13u >> 3u;
+
+    test_setup(&n, 7, 2);
+    TEST_ASSERT(!ssd1306_draw_decimal(&n, 1234));
+
+    /* Only the last digit changes. */
+    ssd1306_bitmap_reset_dirty(&test_bm);
+    TEST_ASSERT(!ssd1306_draw_decimal(&n, 1239) && test_field(&n, "  12.39"));
+    TEST_ASSERT(test_bm.dirty_start[page] ==
+                n.x + ssd1306_number_width(&n) - n.cell_width);
+    TEST_ASSERT(test_bm.dirty_end[page] == n.x + ssd1306_number_width(&n));
+
+    /* Nothing changes. */
+    ssd1306_bitmap_reset_dirty(&test_bm);
+    TEST_ASSERT(!ssd1306_draw_decimal(&n, 1239));
+    TEST_ASSERT(!ssd1306_bitmap_is_dirty(&test_bm));
+
+    /* Pixels over an unchanged cell survive until the field is
+     * invalidated. */
+    test_buffer[page * 128u + n.x + 2u * n.cell_width] ^= 0x80u;
+    TEST_ASSERT(!ssd1306_draw_decimal(&n, 1249));
+    TEST_ASSERT(!test_field(&n, "  12.49"));
+    ssd1306_number_invalidate(&n);
+    TEST_ASSERT(!ssd1306_draw_decimal(&n, 1249) && test_field(&n, "  12.49"));
+}
+
+static void test_init(void)
+{
+    struct ssd1306_number n = {.text = &test_number_text,
+                               .drawn = test_drawn};
+
+    /* The decimal point needs a character of its own. */
+    n.width = 2;
+    n.precision = 2;
+    TEST_ASSERT(ssd1306_number_init(&n));
+    n.width = 3;
+    TEST_ASSERT(!ssd1306_number_init(&n));
+    TEST_ASSERT(ssd1306_number_width(&n) == n.point_width + 2u * n.cell_width);
+
+    /* Empty fields have no width, with or without precision. */
+    n.width = 0;
+    TEST_ASSERT(ssd1306_number_init(&n));
+    TEST_ASSERT(ssd1306_number_width(&n) == 0u);
+    n.precision = 0;
+    TEST_ASSERT(!ssd1306_number_init(&n));
+    TEST_ASSERT(ssd1306_number_width(&n) == 0u);
+
+    n.width = 12;
+    n.precision = SSD1306_NUMBER_MAX_PRECISION + 1u;
+    TEST_ASSERT(ssd1306_number_init(&n));
+}
+
+void test_number(void)
+{
+    test_run("number_init", test_init);
+    test_run("number_int", test_int);
+    test_run("number_decimal", test_decimal);
+    test_run("number_fixed", test_fixed);
+    test_run("number_float", test_float);
+    test_run("number_changed_cells", test_changed_cells);
+}
@@ -0,0 +1,191 @@
+/**
+ * @file test_segment.c
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief Checks that the decimal point stays in the spacing between digits,
+ *        and that updating a digit only changes the segments that differ.
+ */
+
+#include "ssd1306/ssd1306_segment.h"
+#include "test.h"
+#include <string.h>
+
+static uint8_t test_buffer[SSD1306_FRAMEBUFFER_SIZE(128, 64)];
+
+static struct ssd1306_bitmap test_bm = {
+    .width = 128,
+    .height = 64,
+    .length = sizeof(test_buffer),
+    .data = test_buffer,
+};
+
+/** Pixels of each segment of the second digit, drawn alone. */
+static uint8_t test_masks[8][SSD1306_FRAMEBUFFER_SIZE(128, 64)];
+
+static uint8_t test_expected[SSD1306_FRAMEBUFFER_SIZE(128, 64)];
+
+/**
+ * @brief Lights only the decimal point of the first digit and checks that
+ *        it is drawn, and that it leaves the column before the second digit
+ *        free.
+ * @param thickness Segment thickness in pixels.
+ * @param spacing Columns between digits.
+ */
+static void test_dp(uint8_t thickness, uint8_t spacing)
+{
+    uint8_t drawn[2];
+    struct ssd1306_segment_display d = {
+        .bitmap = &test_bm,
+        .digit_width = 12,
+        .digit_height = 20,
+        .thickness = thickness,
+        .spacing = spacing,
+        .digits = 2,
+        .drawn = drawn,
+    };
+    uint8_t lit = 0;
+
+    memset(test_buffer, 0, sizeof(test_buffer));
+    ssd1306_segment_set(&d, 0, SSD1306_SEGMENT_DP);
+    for (uint8_t p = 0; p < ssd1306_bitmap_pages(&test_bm); p++) {
+        const uint8_t *page = ssd1306_bitmap_page(&test_bm, p);
+
+        for (uint8_t x = 0; x < test_bm.width; x++) {
+            if (!page[x])
+                continue;
+            TEST_ASSERT(x >= 12 && x < 12 + spacing - 1);
+            lit = 1;
+        }
+    }
+    TEST_ASSERT(lit);
+}
+
+static void test_dp_wide(void)
+{
+    test_dp(3, 6);
+}
+
+static void test_dp_narrow(void)
+{
+    test_dp(4, 2);
+}
+
+static void test_dp_equal(void)
+{
+    test_dp(3, 3);
+}
+
+/**
+ * @brief Sets the segments of the second digit, and checks that only the
+ *        pixels of the segments that differ change, inside its cell. A pixel
+ *        of each segment that stays lit is cleared first, so that drawing
+ *        the segment again shows.
+ * @param d Pointer to a ssd1306_segment_display struct.
+ * @param segments Segment bits.
+ */
+static void test_update(struct ssd1306_segment_display *d, uint8_t segments)
+{
+    uint8_t removed = d->drawn[1] & ~segments;
+    uint8_t added = segments & ~d->drawn[1];
+    uint8_t kept = segments & d->drawn[1];
+    int16_t left = d->x + d->digit_width + d->spacing;
+    int16_t right = left + d->digit_width + d->spacing;
+
+    for (uint8_t k = 0; k < 8u; k++) {
+        uint16_t i = 0;
+        uint8_t bit = 1u;
+
+        if (!(kept & (1u << k)))
+            continue;
+        while (!test_masks[k][i]) {
+            i++;
+        }
+        while (!(test_masks[k][i] & bit)) {
+            bit <<= 1u;
+        }
+        test_buffer[i] &= ~bit;
+    }
+    memcpy(test_expected, test_buffer, sizeof(test_buffer));
+    for (uint8_t k = 0; k < 8u; k++) {
+        for (uint16_t i = 0; i < sizeof(test_buffer); i++) {
+            if (removed & (1u << k))
+                test_expected[i] &= ~test_masks[k][i];
+            if (added & (1u << k))
+                test_expected[i] |= test_masks[k][i];
+        }
+    }
+
+    ssd1306_bitmap_reset_dirty(&test_bm);
+    ssd1306_segment_set(d, 1, segments);
+    TEST_ASSERT(!memcmp(test_buffer, test_expected, sizeof(test_buffer)));
+    TEST_ASSERT(d->drawn[1] == segments);
+    for (uint8_t p = 0; p < SSD1306_MAX_PAGES; p++) {
+        if (test_bm.dirty_end[p])
+            TEST_ASSERT(test_bm.dirty_start[p] >= left &&
+                        test_bm.dirty_end[p] <= right);
+    }
+}
+
+static void test_incremental(void)
+{
+    uint8_t drawn[3];
+    struct ssd1306_segment_display d = {
+        .bitmap = &test_bm,
+        .x = 3,
+        .y = 5,
+        .digit_width = 14,
+        .digit_height = 27,
+        .thickness = 3,
+        .spacing = 5,
+        .digits = 3,
+        .drawn = drawn,
+    };
+    int16_t left = d.x + d.digit_width + d.spacing;
+
+    /* Each segment alone, which must not overlap the others. */
+    for (uint8_t k = 0; k < 8u; k++) {
+        uint8_t lit = 0;
+
+        memset(test_buffer, 0, sizeof(test_buffer));
+        ssd1306_segment_invalidate(&d);
+        ssd1306_segment_set(&d, 1, 1u << k);
+        memcpy(test_masks[k], test_buffer, sizeof(test_buffer));
+        for (uint16_t i = 0; i < sizeof(test_buffer); i++) {
+            lit |= test_masks[k][i];
+        }
+        TEST_ASSERT(lit);
+        for (uint8_t j = 0; j < k; j++) {
+            for (uint16_t i = 0; i < sizeof(test_buffer); i++) {
+                TEST_ASSERT(!(test_masks[k][i] & test_masks[j][i]));
+            }
+        }
+    }
+
+    memset(test_buffer, 0, sizeof(test_buffer));
+    ssd1306_segment_invalidate(&d);
+    ssd1306_segment_print(&d, "8.8.8.");
+    TEST_ASSERT(drawn[0] == 0xFFu && drawn[1] == 0xFFu && drawn[2] == 0xFFu);
+
+    /* 8. to 3. clears E and F, then 3. to 2. swaps C for E. */
+    test_update(&d, ssd1306_segment_encode('3') | SSD1306_SEGMENT_DP);
+    test_update(&d, ssd1306_segment_encode('2') | SSD1306_SEGMENT_DP);
+    test_update(&d, ssd1306_segment_encode('2'));
+    test_update(&d, ssd1306_segment_encode('2'));
+
+    /* Clearing the digit leaves its cell and spacing empty. */
+    test_update(&d, 0);
+    for (int16_t y = d.y; y < d.y + d.digit_height; y++) {
+        for (int16_t x = left; x < left + d.digit_width + d.spacing; x++) {
+            TEST_ASSERT(!((test_buffer[(y >> 3u) * 128u + x] >> (y & 7u)) &
+                          1u));
+        }
+    }
+    TEST_ASSERT(drawn[0] == 0xFFu && drawn[2] == 0xFFu);
+}
+
+void test_segment(void)
+{
+    test_run("segment_dp_wide", test_dp_wide);
+    test_run("segment_dp_narrow", test_dp_narrow);
+    test_run("segment_dp_equal", test_dp_equal);
+    test_run("segment_incremental", test_incremental);
+}
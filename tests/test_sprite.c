@@ -0,0 +1,184 @@
+/**
+ * @file test_sprite.c
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief Checks the sprite raster operations against a per-pixel reference,
+ *        at every vertical offset within a page and clipped at the edges of
+ *        the bitmap and of a band.
+ */
+
+#include "ssd1306/ssd1306_sprite.h"
+#include "test.h"
+#include <string.h>
+
+/**
+ * @brief Sprite width, not a multiple of 8.
+ */
+#define TEST_SPRITE_WIDTH 13u
+
+/**
+ * @brief Sprite height, two pages with an incomplete last one.
+ */
+#define TEST_SPRITE_HEIGHT 11u
+
+static uint8_t test_data[2 * TEST_SPRITE_WIDTH];
+
+static uint8_t test_mask[2 * TEST_SPRITE_WIDTH];
+
+static uint8_t test_buffer[SSD1306_FRAMEBUFFER_SIZE(128, 64)];
+
+static uint8_t test_before[SSD1306_FRAMEBUFFER_SIZE(128, 64)];
+
+/**
+ * @brief Returns a pixel of a page-format image.
+ * @param data Image data.
+ * @param width Image width in pixels.
+ * @param x Position on the x-axis.
+ * @param y Position on the y-axis.
+ */
+static uint8_t test_pixel(const uint8_t *data, uint8_t width, uint8_t x,
+                          uint8_t y)
+{
+    return (data[(y >> 3u) * width + x] >> (y & 7u)) & 1u;
+}
+
+/**
+ * @brief Draws the sprite at (x, y) and checks every pixel held in the
+ *        bitmap against the expected result of the operation.
+ * @param bm Pointer to a ssd1306_bitmap struct using test_buffer.
+ * @param sprite Pointer to a ssd1306_sprite struct.
+ * @param x Top left corner position on the x-axis.
+ * @param y Top left corner position on the y-axis.
+ * @param op Logical operation.
+ */
+static void test_draw(struct ssd1306_bitmap *bm,
+                      const struct ssd1306_sprite *sprite, int16_t x,
+                      int16_t y, enum ssd1306_raster_op op)
+{
+    uint16_t size = ssd1306_bitmap_size(bm);
+    uint8_t ok = 1;
+    uint8_t dirty = 1;
+
+    for (uint16_t i = 0; i < sizeof(test_buffer); i++) {
+        test_buffer[i] = (uint8_t)(i * 53u + 7u);
+    }
+    memcpy(test_before, test_buffer, sizeof(test_buffer));
+    ssd1306_bitmap_reset_dirty(bm);
+    ssd1306_draw_sprite(bm, sprite, x, y, op);
+
+    for (int16_t row = ssd1306_bitmap_top(bm);
+         row <= ssd1306_bitmap_bottom(bm); row++) {
+        uint8_t page = row >> 3u;
+        uint16_t base = (page - bm->band_page) * 128u;
+
+        for (int16_t col = 0; col < 128; col++) {
+            uint8_t d = test_pixel(test_before + base, 128, col, row & 7);
+            uint8_t got = test_pixel(test_buffer + base, 128, col, row & 7);
+            uint8_t expected = d;
+            int16_t sx = col - x;
+            int16_t sy = row - y;
+
+            if (sx >= 0 && sx < sprite->width && sy >= 0 &&
+                sy < sprite->height) {
+                uint8_t s = test_pixel(sprite->data, sprite->width, sx, sy);
+                uint8_t m = sprite->mask ? test_pixel(sprite->mask,
+                                                      sprite->width, sx, sy)
+                                         : s;
+
+                switch (op) {
+                case SSD1306_ROP_COPY:
+                    expected = s;
+                    break;
+                case SSD1306_ROP_OR:
+                    expected = d | s;
+                    break;
+                case SSD1306_ROP_AND:
+                    expected = d & s;
+                    break;
+                case SSD1306_ROP_XOR:
+                    expected = d ^ s;
+                    break;
+                case SSD1306_ROP_MASK:
+                    expected = m ? s : d;
+                    break;
+                }
+                if (bm->dirty_end[page] < col + 1 ||
+                    bm->dirty_start[page] > col)
+                    dirty = 0;
+            }
+            if (got != expected)
+                ok = 0;
+        }
+    }
+    TEST_ASSERT(ok);
+    TEST_ASSERT(dirty);
+    TEST_ASSERT(!memcmp(test_buffer + size, test_before + size,
+                        sizeof(test_buffer) - size));
+}
+
+/**
+ * @brief Draws the sprite with every operation at positions around the
+ *        edges of a bitmap.
+ * @param bm Pointer to a ssd1306_bitmap struct using test_buffer.
+ */
+static void test_positions(struct ssd1306_bitmap *bm)
+{
+    static const int16_t xs[] = {-14, -13, -5, 0, 3, 115, 120, 127, 128};
+    static const enum ssd1306_raster_op ops[] = {
+        SSD1306_ROP_COPY, SSD1306_ROP_OR, SSD1306_ROP_AND, SSD1306_ROP_XOR,
+        SSD1306_ROP_MASK};
+    struct ssd1306_sprite sprite = {.width = TEST_SPRITE_WIDTH,
+                                    .height = TEST_SPRITE_HEIGHT,
+                                    .data = test_data,
+                                    .mask = test_mask};
+
+    for (uint8_t i = 0; i < sizeof(test_data); i++) {
+        test_data[i] = (uint8_t)(i * 151u + 13u);
+        test_mask[i] = (uint8_t)(i * 97u + 201u);
+    }
+
+    for (uint8_t o = 0; o < sizeof(ops) / sizeof(ops[0]); o++) {
+        for (uint8_t i = 0; i < sizeof(xs) / sizeof(xs[0]); i++) {
+            for (int16_t y = -12; y <= 65; y++) {
+                test_draw(bm, &sprite, xs[i], y, ops[o]);
+            }
+        }
+    }
+
+    /* Without a mask, SSD1306_ROP_MASK draws like SSD1306_ROP_OR. */
+    sprite.mask = NULL;
+    for (int16_t y = -3; y < 12; y++) {
+        test_draw(bm, &sprite, 60, y, SSD1306_ROP_MASK);
+    }
+}
+
+static void test_full(void)
+{
+    struct ssd1306_bitmap bm = {
+        .width = 128,
+        .height = 64,
+        .length = sizeof(test_buffer),
+        .data = test_buffer,
+    };
+
+    test_positions(&bm);
+}
+
+static void test_band(void)
+{
+    struct ssd1306_bitmap bm = {
+        .width = 128,
+        .height = 64,
+        .length = 3 * 128,
+        .data = test_buffer,
+        .band_page = 2,
+        .band_pages = 3,
+    };
+
+    test_positions(&bm);
+}
+
+void test_sprite(void)
+{
+    test_run("sprite_full", test_full);
+    test_run("sprite_band", test_band);
+}
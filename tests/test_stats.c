@@ -0,0 +1,156 @@
+/**
+ * @file test_stats.c
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief Checks the transport counters of a library built with
+ *        SSD1306_STATS against the transfers recorded by the mock transport.
+ */
+
+#include "ssd1306/ssd1306.h"
+#include "ssd1306_mock.h"
+#include "test.h"
+#include <string.h>
+
+static uint8_t test_buffer[SSD1306_FRAMEBUFFER_SIZE(128, 32)];
+
+static struct ssd1306_bitmap test_bm = {
+    .width = 128,
+    .height = 32,
+    .length = sizeof(test_buffer),
+    .data = test_buffer,
+};
+
+static struct ssd1306_driver test_driver;
+
+/** Timestamp returned by test_clock. */
+static uint32_t test_now;
+
+/**
+ * @brief Clock function advancing 10 ticks per call.
+ */
+static uint32_t test_clock(void)
+{
+    test_now += 10u;
+    return test_now;
+}
+
+/**
+ * @brief Attaches the mock transport and resets the counters.
+ * @param transport Transport to use.
+ */
+static void test_setup(const struct ssd1306_transport *transport)
+{
+    memset(&test_driver, 0, sizeof(test_driver));
+    ssd1306_mock_attach(&test_driver, transport, NULL);
+    test_driver.addressing_mode = HORIZONTAL_ADDRESSING_MODE;
+    ssd1306_stats_reset(&test_driver);
+}
+
+/**
+ * @brief Checks the counters against the mock record. I2C transfers start
+ *        with a control byte telling commands from data, SPI transfers are
+ *        told apart by the D/C level.
+ * @param i2c 1 for the I2C transport, 0 for SPI.
+ */
+static void test_check_counts(uint8_t i2c)
+{
+    struct ssd1306_stats stats = ssd1306_stats_snapshot(&test_driver);
+    uint32_t command_bytes = 0;
+    uint32_t data_bytes = 0;
+
+    for (uint16_t n = 0; n < ssd1306_mock.transfers; n++) {
+        uint16_t length;
+        const uint8_t *bytes = ssd1306_mock_transfer(n, &length);
+        uint8_t data = i2c ? bytes[0] == 0x40 : ssd1306_mock.dc[n];
+
+        if (i2c)
+            length--;
+        if (data)
+            data_bytes += length;
+        else
+            command_bytes += length;
+    }
+
+    TEST_ASSERT(stats.transactions == ssd1306_mock.transfers);
+    TEST_ASSERT(stats.command_bytes == command_bytes);
+    TEST_ASSERT(stats.data_bytes == data_bytes);
+}
+
+/**
+ * @brief Sends commands, a window and the dirty columns of the bitmap.
+ */
+static void test_frame(void)
+{
+    ssd1306_set_contrast(&test_driver, 0x20);
+    ssd1306_set_inverse_display(&test_driver);
+    ssd1306_update_gddram_window(&test_driver, &test_bm, 2, 9, 1, 2);
+    ssd1306_bitmap_reset_dirty(&test_bm);
+    ssd1306_bitmap_mark_dirty(&test_bm, 40, 0, 20, 32);
+    ssd1306_update_dirty_gddram(&test_driver, &test_bm);
+}
+
+static void test_i2c(void)
+{
+    test_setup(&ssd1306_i2c_transport);
+    test_frame();
+    test_check_counts(1);
+    TEST_ASSERT(ssd1306_stats_snapshot(&test_driver).data_bytes >= 16u);
+}
+
+static void test_spi(void)
+{
+    test_setup(&ssd1306_spi_transport);
+    test_frame();
+    test_check_counts(0);
+}
+
+static void test_split(void)
+{
+    /* i2c_write splits the payloads to fit in the bounce buffer, and
+     * max_transfer splits the display data. */
+    test_setup(&ssd1306_i2c_transport);
+    test_driver.i2c_writev = NULL;
+    ssd1306_write_gddram(&test_driver, test_buffer,
+                         3u * SSD1306_I2C_BOUNCE_SIZE + 1u);
+    test_check_counts(1);
+    TEST_ASSERT(ssd1306_mock.transfers == 4u);
+
+    test_setup(&ssd1306_i2c_transport);
+    test_driver.max_transfer = 16;
+    ssd1306_update_gddram_pages(&test_driver, &test_bm, 0, 1);
+    test_check_counts(1);
+    TEST_ASSERT(ssd1306_stats_snapshot(&test_driver).data_bytes == 256u);
+}
+
+static void test_delta(void)
+{
+    struct ssd1306_stats before;
+    struct ssd1306_stats call;
+
+    test_setup(&ssd1306_i2c_transport);
+    test_driver.clock = test_clock;
+    test_frame();
+    before = ssd1306_stats_snapshot(&test_driver);
+    TEST_ASSERT(before.time > 0u && before.time % 10u == 0u);
+
+    ssd1306_set_contrast(&test_driver, 0x20);
+    call = ssd1306_stats_delta(before, ssd1306_stats_snapshot(&test_driver));
+    TEST_ASSERT(call.transactions == 1u && call.command_bytes == 2u);
+    TEST_ASSERT(call.data_bytes == 0u && call.time == 10u);
+
+    /* Start, address, control byte and stop, then 9 bits per byte. */
+    TEST_ASSERT(ssd1306_stats_i2c_us(&call, 100000u) == 380u);
+    TEST_ASSERT(ssd1306_stats_spi_us(&call, 1000000u) == 16u);
+
+    ssd1306_stats_reset(&test_driver);
+    call = ssd1306_stats_snapshot(&test_driver);
+    TEST_ASSERT(!call.transactions && !call.command_bytes &&
+                !call.data_bytes && !call.time);
+}
+
+void test_stats(void)
+{
+    test_run("stats_i2c", test_i2c);
+    test_run("stats_spi", test_spi);
+    test_run("stats_split", test_split);
+    test_run("stats_delta", test_delta);
+}
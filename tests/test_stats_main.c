@@ -0,0 +1,13 @@
+/**
+ * @file test_stats_main.c
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief Runs the tests that need the library built with SSD1306_STATS.
+ */
+
+#include "test.h"
+
+int main(void)
+{
+    test_stats();
+    return test_failures() ? 1 : 0;
+}
@@ -0,0 +1,426 @@
+/**
+ * @file test_text.c
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief Checks that text drawn at any row matches the page-aligned text
+ *        shifted by the same number of rows, for raw and RLE fonts, and
+ *        checks the wrapping, alignment and ellipsis of text layouts, the
+ *        UTF-8 decoder and the lookup of glyph ranges.
+ */
+
+#include "ssd1306/font/ssd1306_font_5x7.h"
+#include "ssd1306/font/ssd1306_font_7x11.h"
+#include "ssd1306/ssd1306_text.h"
+#include "ssd1306_font_rle.h"
+#include "test.h"
+#include <string.h>
+
+static uint8_t test_buffer[SSD1306_FRAMEBUFFER_SIZE(128, 64)];
+
+static uint8_t test_aligned[SSD1306_FRAMEBUFFER_SIZE(128, 64)];
+
+static struct ssd1306_bitmap test_bm = {
+    .width = 128,
+    .height = 64,
+    .length = sizeof(test_buffer),
+    .data = test_buffer,
+};
+
+static const char test_str[] = "Hi, 42 px!";
+
+/**
+ * @brief Returns a pixel of a 128x64 frame.
+ * @param data Frame data.
+ * @param x Position on the x-axis.
+ * @param y Position on the y-axis, pixels outside of the frame are 0.
+ */
+static uint8_t test_pixel(const uint8_t *data, uint8_t x, int16_t y)
+{
+    if (y < 0 || y >= 64)
+        return 0;
+    return (data[(y >> 3u) * 128u + x] >> (y & 7u)) & 1u;
+}
+
+/**
+ * @brief Draws the text at page 2 with the cursor and at the pixel rows
+ *        around it, and compares each one with the aligned text shifted.
+ * @param font Pointer to a ssd1306_font struct.
+ */
+static void test_rows(const struct ssd1306_font *font)
+{
+    struct ssd1306_text t = {.bitmap = &test_bm, .font = font};
+    int16_t end;
+
+    memset(test_buffer, 0, sizeof(test_buffer));
+    ssd1306_set_cursor_position(&t, 3, 2);
+    ssd1306_draw_text(&t, test_str);
+    memcpy(test_aligned, test_buffer, sizeof(test_buffer));
+
+    for (int16_t y = -20; y < 64; y++) {
+        uint8_t ok = 1;
+
+        memset(test_buffer, 0, sizeof(test_buffer));
+        end = ssd1306_draw_text_at(&t, 3, y, test_str, SSD1306_ROP_COPY);
+        TEST_ASSERT(end == t.cursor_col);
+        for (int16_t row = 0; row < 64; row++) {
+            for (uint8_t x = 0; x < 128u; x++) {
+                if (test_pixel(test_buffer, x, row) !=
+                    test_pixel(test_aligned, x, row - y + 16))
+                    ok = 0;
+            }
+        }
+        TEST_ASSERT(ok);
+    }
+}
+
+/**
+ * @brief Checks the raster operations of unaligned text over a pattern.
+ * @param font Pointer to a ssd1306_font struct.
+ */
+static void test_rops(const struct ssd1306_font *font)
+{
+    struct ssd1306_text t = {.bitmap = &test_bm, .font = font};
+    uint8_t cell = font->page_alignment << 3u;
+    int16_t y = 21;
+    int16_t end;
+
+    memset(test_buffer, 0, sizeof(test_buffer));
+    end = ssd1306_draw_text_at(&t, 9, y, test_str, SSD1306_ROP_OR);
+    memcpy(test_aligned, test_buffer, sizeof(test_buffer));
+
+    for (uint16_t i = 0; i < sizeof(test_buffer); i++) {
+        test_buffer[i] = (uint8_t)(i * 73u + 5u);
+    }
+    ssd1306_draw_text_at(&t, 9, y, test_str, SSD1306_ROP_XOR);
+    ssd1306_draw_text_at(&t, 9, y, test_str, SSD1306_ROP_XOR);
+    for (uint16_t i = 0; i < sizeof(test_buffer); i++) {
+        TEST_ASSERT(test_buffer[i] == (uint8_t)(i * 73u + 5u));
+    }
+
+    /* COPY replaces the glyph cells and keeps the rest. */
+    ssd1306_draw_text_at(&t, 9, y, test_str, SSD1306_ROP_COPY);
+    for (int16_t row = 0; row < 64; row++) {
+        for (uint8_t x = 0; x < 128u; x++) {
+            uint16_t i = (row >> 3u) * 128u + x;
+            uint8_t bg = ((uint8_t)(i * 73u + 5u) >> (row & 7u)) & 1u;
+            uint8_t inside = row >= y && row < y + cell && x >= 9 && x < end;
+
+            if (!inside)
+                TEST_ASSERT(test_pixel(test_buffer, x, row) == bg);
+            else if (test_pixel(test_aligned, x, row))
+                TEST_ASSERT(test_pixel(test_buffer, x, row));
+        }
+    }
+}
+
+static void test_rows_5x7(void)
+{
+    test_rows(&font_5x7);
+    test_rops(&font_5x7);
+}
+
+static void test_rows_7x11(void)
+{
+    test_rows(&font_7x11);
+    test_rops(&font_7x11);
+}
+
+static void test_rows_rle(void)
+{
+    static uint8_t data[2048];
+    static uint16_t offsets[256];
+    uint16_t length =
+        ssd1306_font_rle_encode(&font_7x11, data, sizeof(data), offsets);
+    struct ssd1306_font rle = font_7x11;
+
+    TEST_ASSERT(length > 0);
+    rle.data = data;
+    rle.char_offset = offsets;
+    rle.encoding = SSD1306_RLE_FONT;
+    test_rows(&rle);
+    test_rops(&rle);
+}
+
+/**
+ * @brief Checks that a layout line holds the given text and its width.
+ * @param t Pointer to a ssd1306_text struct.
+ * @param layout Pointer to a ssd1306_layout struct.
+ * @param k Line index.
+ * @param str Expected text of the line.
+ * @return 1 if the line matches, 0 otherwise.
+ */
+static uint8_t test_line(struct ssd1306_text *t,
+                         const struct ssd1306_layout *layout, uint8_t k,
+                         const char *str)
+{
+    const struct ssd1306_layout_line *line = &layout->lines[k];
+
+    return line->length == strlen(str) &&
+           !strncmp(layout->str + line->start, str, line->length) &&
+           line->width == ssd1306_text_width(t, str);
+}
+
+/**
+ * @brief Draws a layout, and checks it against each line drawn with
+ *        ssd1306_draw_text_at where the layout places it.
+ * @param t Pointer to a ssd1306_text struct.
+ * @param layout Pointer to a ssd1306_layout struct.
+ */
+static void test_draw_layout(struct ssd1306_text *t,
+                             const struct ssd1306_layout *layout)
+{
+    char str[64];
+
+    memset(test_buffer, 0, sizeof(test_buffer));
+    for (uint8_t k = 0; k < layout->line_count; k++) {
+        const struct ssd1306_layout_line *line = &layout->lines[k];
+
+        memcpy(str, layout->str + line->start, line->length);
+        str[line->length] = 0x00;
+        if (layout->ellipsis && k + 1u == layout->line_count)
+            strcat(str, "...");
+        ssd1306_draw_text_at(t, layout->box.x + line->x,
+                             layout->box.y + k * layout->line_height, str,
+                             SSD1306_ROP_OR);
+    }
+    memcpy(test_aligned, test_buffer, sizeof(test_buffer));
+
+    memset(test_buffer, 0, sizeof(test_buffer));
+    ssd1306_draw_layout(t, layout, SSD1306_ROP_OR);
+    TEST_ASSERT(!memcmp(test_buffer, test_aligned, sizeof(test_buffer)));
+}
+
+static void test_layout_wrap(void)
+{
+    struct ssd1306_text t = {.bitmap = &test_bm, .font = &font_5x7};
+    struct ssd1306_rect box = {.x = 10, .y = 13, .width = 40, .height = 40};
+    struct ssd1306_layout layout;
+    char words[] = "one two  three";
+    char word[] = "abcdefghij";
+    char lines[] = "ab\n\n  cd";
+
+    /* Lines break at spaces, which are dropped. */
+    TEST_ASSERT(!ssd1306_layout_text(&t, &layout, words, &box,
+                                     SSD1306_ALIGN_LEFT));
+    TEST_ASSERT(layout.line_count == 3u && !layout.ellipsis);
+    TEST_ASSERT(test_line(&t, &layout, 0, "one"));
+    TEST_ASSERT(test_line(&t, &layout, 1, "two"));
+    TEST_ASSERT(test_line(&t, &layout, 2, "three"));
+    TEST_ASSERT(layout.line_height == 8u);
+    TEST_ASSERT(layout.bounds.x == 10 && layout.bounds.y == 13);
+    TEST_ASSERT(layout.bounds.width == layout.lines[2].width);
+    TEST_ASSERT(layout.bounds.height == 24u);
+    test_draw_layout(&t, &layout);
+
+    /* Words wider than the box break between glyphs. */
+    box.width = 20;
+    TEST_ASSERT(!ssd1306_layout_text(&t, &layout, word, &box,
+                                     SSD1306_ALIGN_LEFT));
+    TEST_ASSERT(layout.line_count == 4u);
+    TEST_ASSERT(test_line(&t, &layout, 0, "abc"));
+    TEST_ASSERT(test_line(&t, &layout, 1, "def"));
+    TEST_ASSERT(test_line(&t, &layout, 2, "ghi"));
+    TEST_ASSERT(test_line(&t, &layout, 3, "j"));
+    for (uint8_t k = 0; k < layout.line_count; k++) {
+        TEST_ASSERT(layout.lines[k].width <= box.width);
+    }
+    test_draw_layout(&t, &layout);
+
+    /* Newlines break lines, empty lines included. */
+    TEST_ASSERT(!ssd1306_layout_text(&t, &layout, lines, &box,
+                                     SSD1306_ALIGN_LEFT));
+    TEST_ASSERT(layout.line_count == 3u);
+    TEST_ASSERT(test_line(&t, &layout, 0, "ab"));
+    TEST_ASSERT(test_line(&t, &layout, 1, ""));
+    TEST_ASSERT(test_line(&t, &layout, 2, "cd"));
+    test_draw_layout(&t, &layout);
+}
+
+static void test_layout_align(void)
+{
+    struct ssd1306_text t = {.bitmap = &test_bm, .font = &font_5x7};
+    struct ssd1306_rect box = {.x = 7, .y = 0, .width = 40, .height = 64};
+    struct ssd1306_layout layout;
+    char words[] = "one two three";
+    uint16_t narrow = ssd1306_text_width(&t, "one");
+    uint16_t wide = ssd1306_text_width(&t, "three");
+
+    TEST_ASSERT(!ssd1306_layout_text(&t, &layout, words, &box,
+                                     SSD1306_ALIGN_CENTER));
+    TEST_ASSERT(layout.lines[0].x == (40 - narrow) / 2);
+    TEST_ASSERT(layout.lines[2].x == (40 - wide) / 2);
+    TEST_ASSERT(layout.bounds.x == 7 + (40 - wide) / 2);
+    TEST_ASSERT(layout.bounds.width == wide);
+    test_draw_layout(&t, &layout);
+
+    TEST_ASSERT(!ssd1306_layout_text(&t, &layout, words, &box,
+                                     SSD1306_ALIGN_RIGHT));
+    TEST_ASSERT(layout.lines[0].x == 40 - narrow);
+    TEST_ASSERT(layout.lines[2].x == 40 - wide);
+    TEST_ASSERT(layout.bounds.x == 7 + 40 - wide);
+    TEST_ASSERT(layout.bounds.width == wide);
+    test_draw_layout(&t, &layout);
+
+    TEST_ASSERT(!ssd1306_layout_text(&t, &layout, words, &box,
+                                     SSD1306_ALIGN_LEFT));
+    for (uint8_t k = 0; k < layout.line_count; k++) {
+        TEST_ASSERT(layout.lines[k].x == 0);
+    }
+    test_draw_layout(&t, &layout);
+}
+
+static void test_layout_ellipsis(void)
+{
+    struct ssd1306_text t = {.bitmap = &test_bm, .font = &font_5x7};
+    struct ssd1306_rect box = {.x = 20, .y = 5, .width = 40, .height = 20};
+    struct ssd1306_layout layout;
+    char words[] = "one two three four";
+    char fits[] = "one\ntwo\n";
+    char word[] = "abcdefghijklmnop";
+    uint16_t dots = ssd1306_text_width(&t, "...");
+
+    /* Only two lines fit, the second one ends with an ellipsis. */
+    TEST_ASSERT(ssd1306_layout_text(&t, &layout, words, &box,
+                                    SSD1306_ALIGN_RIGHT));
+    TEST_ASSERT(layout.line_count == 2u && layout.ellipsis);
+    TEST_ASSERT(test_line(&t, &layout, 0, "one"));
+    TEST_ASSERT(layout.lines[1].width <= box.width);
+    TEST_ASSERT(layout.lines[1].width ==
+                ssd1306_text_width(&t, "two...") &&
+                layout.lines[1].length == 3u);
+    TEST_ASSERT(layout.lines[1].x == 40 - layout.lines[1].width);
+    test_draw_layout(&t, &layout);
+
+    /* Glyphs are dropped until the ellipsis fits. */
+    box.width = 30;
+    TEST_ASSERT(ssd1306_layout_text(&t, &layout, word, &box,
+                                    SSD1306_ALIGN_LEFT));
+    TEST_ASSERT(layout.line_count == 2u && layout.ellipsis);
+    TEST_ASSERT(test_line(&t, &layout, 0, "abcd"));
+    TEST_ASSERT(layout.lines[1].width <= box.width);
+    TEST_ASSERT(layout.lines[1].width ==
+                ssd1306_text_width(&t, "e...") &&
+                layout.lines[1].width > box.width - 7u);
+    test_draw_layout(&t, &layout);
+
+    /* A line too narrow for any glyph keeps only the ellipsis. */
+    box.width = dots + 2u;
+    box.height = 8;
+    TEST_ASSERT(ssd1306_layout_text(&t, &layout, word, &box,
+                                    SSD1306_ALIGN_LEFT));
+    TEST_ASSERT(layout.line_count == 1u && layout.ellipsis);
+    TEST_ASSERT(layout.lines[0].length == 0u &&
+                layout.lines[0].width == dots);
+    test_draw_layout(&t, &layout);
+
+    /* A trailing newline on the last line is not a truncation. */
+    box.width = 40;
+    box.height = 16;
+    TEST_ASSERT(!ssd1306_layout_text(&t, &layout, fits, &box,
+                                     SSD1306_ALIGN_LEFT));
+    TEST_ASSERT(layout.line_count == 2u && !layout.ellipsis);
+}
+
+/**
+ * @brief Checks the decoding of the character at the start of a string.
+ * @param str String.
+ * @param c Expected codepoint.
+ * @param n Expected number of bytes.
+ * @return 1 if the decoding matches, 0 otherwise.
+ */
+static uint8_t test_decode(const char *str, uint32_t c, uint8_t n)
+{
+    uint32_t decoded;
+
+    return ssd1306_utf8_decode(str, &decoded) == n && decoded == c;
+}
+
+static void test_utf8(void)
+{
+    TEST_ASSERT(test_decode("A", 'A', 1));
+    TEST_ASSERT(test_decode("\x7F", 0x7F, 1));
+    TEST_ASSERT(test_decode("\xC2\x80", 0x80, 2));
+    TEST_ASSERT(test_decode("\xDF\xBF", 0x7FF, 2));
+    TEST_ASSERT(test_decode("\xE0\xA0\x80", 0x800, 3));
+    TEST_ASSERT(test_decode("\xE2\x82\xAC", 0x20AC, 3));
+    TEST_ASSERT(test_decode("\xED\x9F\xBF", 0xD7FF, 3));
+    TEST_ASSERT(test_decode("\xEE\x80\x80", 0xE000, 3));
+    TEST_ASSERT(test_decode("\xF0\x90\x80\x80", 0x10000, 4));
+    TEST_ASSERT(test_decode("\xF4\x8F\xBF\xBF", 0x10FFFF, 4));
+
+    /* Overlong sequences. */
+    TEST_ASSERT(test_decode("\xC0\x80", SSD1306_UTF8_INVALID, 1));
+    TEST_ASSERT(test_decode("\xC1\xBF", SSD1306_UTF8_INVALID, 1));
+    TEST_ASSERT(test_decode("\xE0\x9F\xBF", SSD1306_UTF8_INVALID, 1));
+    TEST_ASSERT(test_decode("\xF0\x8F\xBF\xBF", SSD1306_UTF8_INVALID, 1));
+
+    /* Surrogates. */
+    TEST_ASSERT(test_decode("\xED\xA0\x80", SSD1306_UTF8_INVALID, 1));
+    TEST_ASSERT(test_decode("\xED\xBF\xBF", SSD1306_UTF8_INVALID, 1));
+
+    /* Codepoints above U+10FFFF. */
+    TEST_ASSERT(test_decode("\xF4\x90\x80\x80", SSD1306_UTF8_INVALID, 1));
+    TEST_ASSERT(test_decode("\xF7\xBF\xBF\xBF", SSD1306_UTF8_INVALID, 1));
+
+    /* Truncated sequences never skip the terminator. */
+    TEST_ASSERT(test_decode("\xC2", SSD1306_UTF8_INVALID, 1));
+    TEST_ASSERT(test_decode("\xE2\x82", SSD1306_UTF8_INVALID, 1));
+    TEST_ASSERT(test_decode("\xF0\x90\x80", SSD1306_UTF8_INVALID, 1));
+    TEST_ASSERT(test_decode("\xE2" "A", SSD1306_UTF8_INVALID, 1));
+
+    /* Lone continuation bytes and invalid lead bytes. */
+    TEST_ASSERT(test_decode("\x80", SSD1306_UTF8_INVALID, 1));
+    TEST_ASSERT(test_decode("\xBF", SSD1306_UTF8_INVALID, 1));
+    TEST_ASSERT(test_decode("\xF8\x88\x80\x80\x80", SSD1306_UTF8_INVALID, 1));
+    TEST_ASSERT(test_decode("\xFF", SSD1306_UTF8_INVALID, 1));
+}
+
+static void test_ranges(void)
+{
+    const struct ssd1306_glyph_range ranges[] = {
+        {.first = 0xB0, .count = 1, .glyph = 94},
+        {.first = 0x391, .count = 25, .glyph = 95},
+        {.first = 0x2190, .count = 4, .glyph = 120},
+    };
+    struct ssd1306_font font = font_5x7;
+
+    font.ranges = ranges;
+    font.range_count = sizeof(ranges) / sizeof(ranges[0]);
+
+    /* Before the first range, between ranges and after the last one. */
+    TEST_ASSERT(_ssd1306_font_range_glyph(&font, 0) == -1);
+    TEST_ASSERT(_ssd1306_font_range_glyph(&font, 0xAF) == -1);
+    TEST_ASSERT(_ssd1306_font_range_glyph(&font, 0xB1) == -1);
+    TEST_ASSERT(_ssd1306_font_range_glyph(&font, 0x390) == -1);
+    TEST_ASSERT(_ssd1306_font_range_glyph(&font, 0x3AA) == -1);
+    TEST_ASSERT(_ssd1306_font_range_glyph(&font, 0x218F) == -1);
+    TEST_ASSERT(_ssd1306_font_range_glyph(&font, 0x2194) == -1);
+    TEST_ASSERT(_ssd1306_font_range_glyph(&font, 0x10FFFF) == -1);
+
+    /* First, inner and last codepoints of each range. */
+    TEST_ASSERT(_ssd1306_font_range_glyph(&font, 0xB0) == 94);
+    TEST_ASSERT(_ssd1306_font_range_glyph(&font, 0x391) == 95);
+    TEST_ASSERT(_ssd1306_font_range_glyph(&font, 0x3A0) == 110);
+    TEST_ASSERT(_ssd1306_font_range_glyph(&font, 0x3A9) == 119);
+    TEST_ASSERT(_ssd1306_font_range_glyph(&font, 0x2190) == 120);
+    TEST_ASSERT(_ssd1306_font_range_glyph(&font, 0x2193) == 123);
+
+    /* ASCII characters don't search the ranges. */
+    TEST_ASSERT(ssd1306_font_glyph(&font, 'A') == 'A' - '!');
+    TEST_ASSERT(ssd1306_font_glyph(&font, 0x3A9) == 119);
+    TEST_ASSERT(ssd1306_font_glyph(&font, ' ') == -1);
+
+    font.range_count = 0;
+    TEST_ASSERT(_ssd1306_font_range_glyph(&font, 0xB0) == -1);
+}
+
+void test_text(void)
+{
+    test_run("text_rows_5x7", test_rows_5x7);
+    test_run("text_rows_7x11", test_rows_7x11);
+    test_run("text_rows_rle", test_rows_rle);
+    test_run("text_layout_wrap", test_layout_wrap);
+    test_run("text_layout_align", test_layout_align);
+    test_run("text_layout_ellipsis", test_layout_ellipsis);
+    test_run("text_utf8", test_utf8);
+    test_run("text_ranges", test_ranges);
+}
@@ -0,0 +1,286 @@
+/**
+ * @file test_tilemap.c
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief Checks that a tilemap only draws the cells that changed since the
+ *        last render, and that the result matches a full render.
+ */
+
+#include "ssd1306/font/ssd1306_font_5x7.h"
+#include "ssd1306/ssd1306_tilemap.h"
+#include "test.h"
+#include <string.h>
+
+/**
+ * @brief Number of columns of the test grid.
+ */
+#define TEST_COLS 10u
+
+/**
+ * @brief Number of rows of the test grid.
+ */
+#define TEST_ROWS 3u
+
+static uint8_t test_buffer[SSD1306_FRAMEBUFFER_SIZE(128, 64)];
+
+static uint8_t test_before[SSD1306_FRAMEBUFFER_SIZE(128, 64)];
+
+static uint8_t test_full_buffer[SSD1306_FRAMEBUFFER_SIZE(128, 64)];
+
+static struct ssd1306_bitmap test_bm = {
+    .width = 128,
+    .height = 64,
+    .length = sizeof(test_buffer),
+    .data = test_buffer,
+};
+
+static struct ssd1306_bitmap test_full_bm = {
+    .width = 128,
+    .height = 64,
+    .length = sizeof(test_full_buffer),
+    .data = test_full_buffer,
+};
+
+static struct ssd1306_text test_map_text = {.bitmap = &test_bm,
+                                            .font = &font_5x7};
+
+static struct ssd1306_text test_full_text = {.bitmap = &test_full_bm,
+                                             .font = &font_5x7};
+
+static uint16_t test_cells[TEST_COLS * TEST_ROWS];
+
+static uint16_t test_drawn[TEST_COLS * TEST_ROWS];
+
+static uint16_t test_full_cells[TEST_COLS * TEST_ROWS];
+
+static uint16_t test_full_drawn[TEST_COLS * TEST_ROWS];
+
+/**
+ * @brief Returns the glyph index of a character of font_5x7.
+ * @param c Character.
+ */
+static uint16_t test_glyph(char c)
+{
+    return ssd1306_font_glyph(&font_5x7, c);
+}
+
+/**
+ * @brief Sets up a grid at an unaligned position of the test bitmap.
+ * @param map Pointer to the ssd1306_tilemap struct to set up.
+ */
+static void test_setup(struct ssd1306_tilemap *map)
+{
+    memset(map, 0, sizeof(*map));
+    map->text = &test_map_text;
+    map->x = 4;
+    map->y = 3;
+    map->cols = TEST_COLS;
+    map->rows = TEST_ROWS;
+    map->cells = test_cells;
+    map->drawn = test_drawn;
+    ssd1306_tilemap_init(map);
+}
+
+/**
+ * @brief Renders a copy of the grid from scratch in test_full_bm.
+ * @param map Pointer to a ssd1306_tilemap struct.
+ */
+static void test_full_render(const struct ssd1306_tilemap *map)
+{
+    struct ssd1306_tilemap full = *map;
+
+    full.text = &test_full_text;
+    full.cells = test_full_cells;
+    full.drawn = test_full_drawn;
+    memset(test_full_buffer, 0, sizeof(test_full_buffer));
+    ssd1306_tilemap_init(&full);
+    memcpy(test_full_cells, map->cells, sizeof(test_full_cells));
+    ssd1306_tilemap_render(&full, NULL, 0);
+}
+
+/**
+ * @brief Checks whether a pixel lies in one of the windows.
+ * @param windows Array of windows.
+ * @param count Number of windows.
+ * @param x Position on the x-axis.
+ * @param y Position on the y-axis.
+ * @return 1 if the pixel is in a window, 0 otherwise.
+ */
+static uint8_t test_in_windows(const struct ssd1306_rect *windows,
+                               uint8_t count, int16_t x, int16_t y)
+{
+    for (uint8_t i = 0; i < count; i++) {
+        if (x >= windows[i].x && x < windows[i].x + windows[i].width &&
+            y >= windows[i].y && y < windows[i].y + windows[i].height)
+            return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Renders the grid and checks that only pixels and dirty columns
+ *        inside the reported windows changed, and that the result matches
+ *        a full render.
+ * @param map Pointer to a ssd1306_tilemap struct.
+ * @param windows Array receiving the windows.
+ * @param max_windows Size of the array.
+ * @return Number of windows.
+ */
+static uint8_t test_render(struct ssd1306_tilemap *map,
+                           struct ssd1306_rect *windows, uint8_t max_windows)
+{
+    uint8_t count;
+
+    memcpy(test_before, test_buffer, sizeof(test_buffer));
+    ssd1306_bitmap_reset_dirty(&test_bm);
+    count = ssd1306_tilemap_render(map, windows, max_windows);
+
+    for (int16_t y = 0; y < 64; y++) {
+        for (int16_t x = 0; x < 128; x++) {
+            uint16_t i = (y >> 3u) * 128u + x;
+
+            if ((test_buffer[i] ^ test_before[i]) & (1u << (y & 7u)))
+                TEST_ASSERT(test_in_windows(windows, count, x, y));
+        }
+    }
+
+    /* The dirty columns of a page lie within the windows crossing it. */
+    for (uint8_t p = 0; p < SSD1306_MAX_PAGES; p++) {
+        int16_t left = 128;
+        int16_t right = 0;
+
+        for (uint8_t i = 0; i < count; i++) {
+            if (windows[i].y >= p * 8 + 8 ||
+                windows[i].y + windows[i].height <= p * 8)
+                continue;
+            if (windows[i].x < left)
+                left = windows[i].x;
+            if (windows[i].x + windows[i].width > right)
+                right = windows[i].x + windows[i].width;
+        }
+        if (test_bm.dirty_end[p] > test_bm.dirty_start[p])
+            TEST_ASSERT(test_bm.dirty_start[p] >= left &&
+                        test_bm.dirty_end[p] <= right);
+    }
+
+    test_full_render(map);
+    TEST_ASSERT(!memcmp(test_buffer, test_full_buffer, sizeof(test_buffer)));
+    return count;
+}
+
+static void test_changed_cells(void)
+{
+    struct ssd1306_tilemap map;
+    struct ssd1306_rect windows[8];
+    uint8_t count;
+
+    memset(test_buffer, 0, sizeof(test_buffer));
+    test_setup(&map);
+    TEST_ASSERT(map.cell_width == 7u && map.cell_height == 8u);
+
+    /* The first render draws every row. */
+    ssd1306_tilemap_print(&map, 0, 0, "Tilemap");
+    ssd1306_tilemap_print(&map, 2, 1, "0123456789");
+    ssd1306_tilemap_print(&map, 9, 2, "AB");
+    count = test_render(&map, windows, 8);
+    TEST_ASSERT(count == TEST_ROWS);
+    for (uint8_t r = 0; r < TEST_ROWS; r++) {
+        TEST_ASSERT(windows[r].x == 4 && windows[r].y == 3 + r * 8);
+        TEST_ASSERT(windows[r].width == TEST_COLS * 7u &&
+                    windows[r].height == 8u);
+    }
+    TEST_ASSERT(test_cells[TEST_COLS * 2u + 9u] == test_glyph('A'));
+    TEST_ASSERT(test_cells[TEST_COLS * 0u + 9u] == SSD1306_TILEMAP_BLANK);
+
+    /* Nothing changed, nothing is drawn. */
+    count = test_render(&map, windows, 8);
+    TEST_ASSERT(count == 0u && !ssd1306_bitmap_is_dirty(&test_bm));
+
+    /* Writing the same characters again draws nothing either. */
+    ssd1306_tilemap_print(&map, 0, 0, "Tile");
+    ssd1306_tilemap_put(&map, 5, 1, test_glyph('3'));
+    count = test_render(&map, windows, 8);
+    TEST_ASSERT(count == 0u && !ssd1306_bitmap_is_dirty(&test_bm));
+
+    /* Each run of changed cells in a row is a window. */
+    ssd1306_tilemap_put(&map, 1, 0, test_glyph('o'));
+    ssd1306_tilemap_put(&map, 2, 0, test_glyph('L'));
+    ssd1306_tilemap_put(&map, 6, 0, test_glyph('P'));
+    ssd1306_tilemap_print(&map, 0, 2, "x");
+    count = test_render(&map, windows, 8);
+    TEST_ASSERT(count == 3u);
+    TEST_ASSERT(windows[0].x == 4 + 7 && windows[0].width == 14u &&
+                windows[0].y == 3);
+    TEST_ASSERT(windows[1].x == 4 + 6 * 7 && windows[1].width == 7u &&
+                windows[1].y == 3);
+    TEST_ASSERT(windows[2].x == 4 && windows[2].width == 7u &&
+                windows[2].y == 3 + 16);
+
+    /* Unchanged cells are not drawn again, so a pixel set in the separation
+     * of one of them survives a render. */
+    test_buffer[(16u >> 3u) * 128u + 4u + 7u * 8u + 6u] |= 1u;
+    ssd1306_tilemap_put(&map, 3, 2, test_glyph('#'));
+    count = ssd1306_tilemap_render(&map, windows, 8);
+    TEST_ASSERT(count == 1u);
+    TEST_ASSERT(test_buffer[(16u >> 3u) * 128u + 4u + 7u * 8u + 6u] & 1u);
+
+    /* Invalidating draws every cell again and clears that pixel. */
+    ssd1306_tilemap_invalidate(&map);
+    count = test_render(&map, windows, 8);
+    TEST_ASSERT(count == TEST_ROWS);
+}
+
+static void test_window_limit(void)
+{
+    struct ssd1306_tilemap map;
+    struct ssd1306_rect windows[2];
+    uint8_t count;
+
+    memset(test_buffer, 0, sizeof(test_buffer));
+    test_setup(&map);
+    ssd1306_tilemap_render(&map, NULL, 0);
+
+    /* Runs past the size of the array grow the last window. */
+    ssd1306_tilemap_put(&map, 0, 0, test_glyph('a'));
+    ssd1306_tilemap_put(&map, 5, 0, test_glyph('b'));
+    ssd1306_tilemap_put(&map, 2, 1, test_glyph('c'));
+    ssd1306_tilemap_put(&map, 8, 2, test_glyph('d'));
+    count = test_render(&map, windows, 2);
+    TEST_ASSERT(count == 2u);
+    TEST_ASSERT(windows[0].x == 4 && windows[0].width == 7u);
+    TEST_ASSERT(windows[1].x == 4 + 2 * 7 && windows[1].y == 3);
+    TEST_ASSERT(windows[1].width == 7u * 7u && windows[1].height == 24u);
+}
+
+static void test_ranges(void)
+{
+    const struct ssd1306_glyph_range ranges[] = {
+        {.first = 0xB0, .count = 1, .glyph = test_glyph('o')}};
+    struct ssd1306_font font = font_5x7;
+    struct ssd1306_tilemap map;
+    struct ssd1306_rect windows[8];
+
+    font.ranges = ranges;
+    font.range_count = 1;
+    test_map_text.font = &font;
+    memset(test_buffer, 0, sizeof(test_buffer));
+    test_setup(&map);
+
+    /* Characters outside of first_char..last_char use the font ranges,
+     * characters without a glyph leave the cell empty. */
+    ssd1306_tilemap_print(&map, 0, 0, "\xC2\xB0" "C \xE2\x82\xAC!");
+    TEST_ASSERT(test_cells[0] == test_glyph('o'));
+    TEST_ASSERT(test_cells[1] == test_glyph('C'));
+    TEST_ASSERT(test_cells[2] == SSD1306_TILEMAP_BLANK);
+    TEST_ASSERT(test_cells[3] == SSD1306_TILEMAP_BLANK);
+    TEST_ASSERT(test_cells[4] == test_glyph('!'));
+    TEST_ASSERT(test_cells[5] == SSD1306_TILEMAP_BLANK);
+    test_map_text.font = &font_5x7;
+    TEST_ASSERT(test_render(&map, windows, 8) == TEST_ROWS);
+}
+
+void test_tilemap(void)
+{
+    test_run("tilemap_changed_cells", test_changed_cells);
+    test_run("tilemap_window_limit", test_window_limit);
+    test_run("tilemap_ranges", test_ranges);
+}
@@ -0,0 +1,393 @@
+/**
+ * @file test_transport.c
+ * @author Iván Santiago (https://github.com/ivansntg)
+ * @brief Checks the byte streams written by the I2C and SPI transports, in
+ *        blocking and asynchronous mode, against the mock transport record.
+ */
+
+#include "ssd1306/font/ssd1306_font_5x7.h"
+#include "ssd1306/ssd1306.h"
+#include "ssd1306/ssd1306_marquee.h"
+#include "ssd1306_mock.h"
+#include "test.h"
+#include <string.h>
+
+/**
+ * @brief Bitmap width, the window commands use columns 2 to 4.
+ */
+#define TEST_WIDTH 16u
+
+static uint8_t test_buffer[SSD1306_FRAMEBUFFER_SIZE(TEST_WIDTH, 24)];
+
+static struct ssd1306_bitmap test_bm = {
+    .width = TEST_WIDTH,
+    .height = 24,
+    .length = sizeof(test_buffer),
+    .data = test_buffer,
+};
+
+static struct ssd1306_driver test_driver;
+
+static struct ssd1306_async test_queue;
+
+/**
+ * @brief Attaches the mock transport and fills the bitmap with the value
+ *        0xPC at page P, column C.
+ * @param transport Transport to use.
+ * @param async Pointer to a ssd1306_async struct, or NULL for blocking mode.
+ * @param mode Addressing mode of the driver.
+ */
+static void test_setup(const struct ssd1306_transport *transport,
+                       struct ssd1306_async *async,
+                       enum ssd1306_addressing_mode mode)
+{
+    memset(&test_driver, 0, sizeof(test_driver));
+    ssd1306_mock_attach(&test_driver, transport, async);
+    test_driver.addressing_mode = mode;
+    for (uint16_t i = 0; i < sizeof(test_buffer); i++) {
+        test_buffer[i] = (i / TEST_WIDTH) << 4u | (i % TEST_WIDTH);
+    }
+}
+
+/**
+ * @brief Updates the window of columns 2 to 4 and pages 1 to 2. In
+ *        asynchronous mode, the transfers are completed one at a time.
+ */
+static void test_update_window(void)
+{
+    ssd1306_update_gddram_window(&test_driver, &test_bm, 2, 4, 1, 2);
+    if (!test_driver.async)
+        return;
+
+    TEST_ASSERT(ssd1306_async_pending(&test_driver) == 3u);
+    TEST_ASSERT(ssd1306_mock.transfers == 0);
+    while (ssd1306_mock_complete()) {
+    }
+    TEST_ASSERT(ssd1306_async_pending(&test_driver) == 0);
+}
+
+static void test_i2c_commands(void)
+{
+    test_setup(&ssd1306_i2c_transport, NULL, PAGE_ADDRESSING_MODE);
+    ssd1306_set_contrast(&test_driver, 0x20);
+    ssd1306_set_start_line(&test_driver, 8);
+
+    TEST_ASSERT(ssd1306_mock.transfers == 2u);
+    TEST_TRANSFER(0, 0, 0x00, 0x81, 0x20);
+    TEST_TRANSFER(1, 0, 0x00, 0x48);
+}
+
+static void test_spi_commands(void)
+{
+    test_setup(&ssd1306_spi_transport, NULL, PAGE_ADDRESSING_MODE);
+    ssd1306_set_contrast(&test_driver, 0x20);
+    ssd1306_set_start_line(&test_driver, 8);
+
+    TEST_ASSERT(ssd1306_mock.transfers == 2u);
+    TEST_TRANSFER(0, 0, 0x81, 0x20);
+    TEST_TRANSFER(1, 0, 0x48);
+}
+
+/**
+ * @brief Checks the I2C stream of test_update_window in horizontal mode.
+ */
+static void test_check_i2c_window(void)
+{
+    TEST_ASSERT(ssd1306_mock.transfers == 3u);
+    TEST_TRANSFER(0, 0, 0x00, 0x21, 2, 4, 0x22, 1, 2);
+    TEST_TRANSFER(1, 0, 0x40, 0x12, 0x13, 0x14);
+    TEST_TRANSFER(2, 0, 0x40, 0x22, 0x23, 0x24);
+}
+
+/**
+ * @brief Checks the SPI stream of test_update_window in horizontal mode.
+ */
+static void test_check_spi_window(void)
+{
+    TEST_ASSERT(ssd1306_mock.transfers == 3u);
+    TEST_TRANSFER(0, 0, 0x21, 2, 4, 0x22, 1, 2);
+    TEST_TRANSFER(1, 1, 0x12, 0x13, 0x14);
+    TEST_TRANSFER(2, 1, 0x22, 0x23, 0x24);
+}
+
+static void test_i2c_window(void)
+{
+    test_setup(&ssd1306_i2c_transport, NULL, HORIZONTAL_ADDRESSING_MODE);
+    test_update_window();
+    test_check_i2c_window();
+}
+
+static void test_i2c_window_async(void)
+{
+    test_setup(&ssd1306_i2c_transport, &test_queue,
+               HORIZONTAL_ADDRESSING_MODE);
+    ssd1306_mock.auto_complete = 0;
+    test_update_window();
+    test_check_i2c_window();
+}
+
+static void test_spi_window(void)
+{
+    test_setup(&ssd1306_spi_transport, NULL, HORIZONTAL_ADDRESSING_MODE);
+    test_update_window();
+    test_check_spi_window();
+}
+
+static void test_spi_window_async(void)
+{
+    test_setup(&ssd1306_spi_transport, &test_queue,
+               HORIZONTAL_ADDRESSING_MODE);
+    ssd1306_mock.auto_complete = 0;
+    test_update_window();
+    test_check_spi_window();
+}
+
+static void test_i2c_page_window(void)
+{
+    test_setup(&ssd1306_i2c_transport, NULL, PAGE_ADDRESSING_MODE);
+    ssd1306_update_gddram_window(&test_driver, &test_bm, 2, 4, 1, 2);
+
+    TEST_ASSERT(ssd1306_mock.transfers == 4u);
+    TEST_TRANSFER(0, 0, 0x00, 0xB1, 0x02, 0x10);
+    TEST_TRANSFER(1, 0, 0x40, 0x12, 0x13, 0x14);
+    TEST_TRANSFER(2, 0, 0x00, 0xB2, 0x02, 0x10);
+    TEST_TRANSFER(3, 0, 0x40, 0x22, 0x23, 0x24);
+}
+
+static void test_spi_vertical_window(void)
+{
+    test_setup(&ssd1306_spi_transport, NULL, VERTICAL_ADDRESSING_MODE);
+    ssd1306_update_gddram_window(&test_driver, &test_bm, 2, 4, 1, 2);
+
+    TEST_ASSERT(ssd1306_mock.transfers == 2u);
+    TEST_TRANSFER(0, 0, 0x21, 2, 4, 0x22, 1, 2);
+    TEST_TRANSFER(1, 1, 0x12, 0x22, 0x13, 0x23, 0x14, 0x24);
+}
+
+static void test_i2c_dirty(void)
+{
+    test_setup(&ssd1306_i2c_transport, NULL, HORIZONTAL_ADDRESSING_MODE);
+    ssd1306_bitmap_reset_dirty(&test_bm);
+    ssd1306_bitmap_mark_dirty(&test_bm, 5, 0, 2, 8);
+    ssd1306_update_dirty_gddram(&test_driver, &test_bm);
+
+    TEST_ASSERT(ssd1306_mock.transfers == 2u);
+    TEST_TRANSFER(0, 0, 0x00, 0x21, 5, 6, 0x22, 0, 0);
+    TEST_TRANSFER(1, 0, 0x40, 0x05, 0x06);
+    TEST_ASSERT(!ssd1306_bitmap_is_dirty(&test_bm));
+}
+
+static void test_i2c_max_transfer(void)
+{
+    test_setup(&ssd1306_i2c_transport, NULL, HORIZONTAL_ADDRESSING_MODE);
+    test_driver.max_transfer = 2;
+    ssd1306_write_gddram(&test_driver, test_buffer, 3);
+
+    TEST_ASSERT(ssd1306_mock.transfers == 2u);
+    TEST_TRANSFER(0, 0, 0x40, 0x00, 0x01);
+    TEST_TRANSFER(1, 0, 0x40, 0x02);
+}
+
+static void test_i2c_batch(void)
+{
+    uint8_t batch[8];
+
+    test_setup(&ssd1306_i2c_transport, NULL, PAGE_ADDRESSING_MODE);
+    ssd1306_begin_batch(&test_driver, batch, sizeof(batch));
+    ssd1306_set_contrast(&test_driver, 0x20);
+    ssd1306_set_inverse_display(&test_driver);
+    TEST_ASSERT(ssd1306_mock.transfers == 0);
+    ssd1306_write_gddram(&test_driver, test_buffer, 1);
+    ssd1306_set_normal_display(&test_driver);
+    ssd1306_end_batch(&test_driver);
+
+    TEST_ASSERT(ssd1306_mock.transfers == 3u);
+    TEST_TRANSFER(0, 0, 0x00, 0x81, 0x20, 0xA7);
+    TEST_TRANSFER(1, 0, 0x40, 0x00);
+    TEST_TRANSFER(2, 0, 0x00, 0xA6);
+}
+
+/**
+ * @brief Starts a software marquee on page 0 of the bitmap.
+ * @param m Pointer to the ssd1306_marquee struct to start.
+ * @param ssd1306b 1 if the controller is a SSD1306B.
+ */
+static void test_marquee_start(struct ssd1306_marquee *m, uint8_t ssd1306b)
+{
+    static struct ssd1306_text text = {.bitmap = &test_bm, .font = &font_5x7};
+
+    memset(m, 0, sizeof(*m));
+    m->driver = &test_driver;
+    m->text = &text;
+    m->str = "AB";
+    m->gap = 4;
+    m->frames = 1;
+    m->ssd1306b = ssd1306b;
+    test_setup(&ssd1306_i2c_transport, NULL, PAGE_ADDRESSING_MODE);
+    TEST_ASSERT(!ssd1306_marquee_start(m));
+    ssd1306_mock_reset();
+}
+
+static void test_i2c_marquee_batch(void)
+{
+    struct ssd1306_marquee m;
+    uint8_t batch[32];
+
+    test_marquee_start(&m, 1);
+    ssd1306_begin_batch(&test_driver, batch, sizeof(batch));
+    ssd1306_set_contrast(&test_driver, 0x20);
+    ssd1306_marquee_step(&m);
+    TEST_ASSERT(test_driver.batch == batch);
+    ssd1306_set_normal_display(&test_driver);
+    ssd1306_end_batch(&test_driver);
+
+    TEST_ASSERT(ssd1306_mock.transfers == 3u);
+    TEST_TRANSFER(0, 0, 0x00, 0x81, 0x20, 0x2D, 0x00, 0x00, 0x01, 0x00, 0x00,
+                  0xFF, 0xB0, 0x0F, 0x10);
+    TEST_TRANSFER(1, 0, 0x40, 0x7E);
+    TEST_TRANSFER(2, 0, 0x00, 0xA6);
+}
+
+static void test_i2c_marquee_ssd1306(void)
+{
+    struct ssd1306_marquee m;
+    const uint8_t *data;
+    uint16_t length;
+
+    /* Without the one-column scroll, the shifted page is sent whole. */
+    test_marquee_start(&m, 0);
+    ssd1306_marquee_step(&m);
+    TEST_ASSERT(ssd1306_mock.transfers == 2u);
+    TEST_TRANSFER(0, 0, 0x00, 0xB0, 0x00, 0x10);
+    data = ssd1306_mock_transfer(1, &length);
+    TEST_ASSERT(length == TEST_WIDTH + 1u && data[0] == 0x40);
+    TEST_ASSERT(data[TEST_WIDTH] == 0x7E);
+    TEST_ASSERT(test_bm.dirty_end[0] == 0u);
+}
+
+static void test_i2c_update_gddram(void)
+{
+    uint8_t frame[4] = {0xFF, 0x01, 0x02, 0x03};
+
+    test_setup(&ssd1306_i2c_transport, NULL, HORIZONTAL_ADDRESSING_MODE);
+    ssd1306_update_gddram(&test_driver, frame, sizeof(frame));
+
+    TEST_ASSERT(ssd1306_mock.transfers == 1u);
+    TEST_TRANSFER(0, 0, 0x40, 0x01, 0x02, 0x03);
+
+    /* With i2c_write, the reserved byte holds the control byte. */
+    test_driver.i2c_writev = NULL;
+    ssd1306_mock_reset();
+    ssd1306_update_gddram(&test_driver, frame, sizeof(frame));
+    TEST_ASSERT(ssd1306_mock.transfers == 1u);
+    TEST_TRANSFER(0, 0, 0x40, 0x01, 0x02, 0x03);
+
+    /* Arrays with only the reserved byte send nothing. */
+    ssd1306_mock_reset();
+    ssd1306_update_gddram(&test_driver, frame, 1);
+    ssd1306_update_gddram(&test_driver, frame, 0);
+    TEST_ASSERT(ssd1306_mock.transfers == 0u && ssd1306_mock.length == 0u);
+}
+
+/**
+ * @brief Attaches the mock I2C transport with only the i2c_write function.
+ * @param mode Addressing mode of the driver.
+ */
+static void test_setup_i2c_write(enum ssd1306_addressing_mode mode)
+{
+    test_setup(&ssd1306_i2c_transport, NULL, mode);
+    test_driver.i2c_writev = NULL;
+}
+
+static void test_i2c_write_window(void)
+{
+    test_setup_i2c_write(HORIZONTAL_ADDRESSING_MODE);
+    test_update_window();
+    test_check_i2c_window();
+
+    /* The bytes lent to the control byte are restored. */
+    TEST_ASSERT(test_buffer[TEST_WIDTH + 1u] == 0x11);
+    TEST_ASSERT(test_buffer[2u * TEST_WIDTH + 1u] == 0x21);
+}
+
+static void test_i2c_write_frame(void)
+{
+    uint16_t length;
+    const uint8_t *frame;
+
+    test_setup_i2c_write(HORIZONTAL_ADDRESSING_MODE);
+    ssd1306_update_gddram_pages(&test_driver, &test_bm, 0, 2);
+
+    /* The first byte has no byte before it, so it is sent on its own. */
+    TEST_ASSERT(ssd1306_mock.transfers == 3u);
+    TEST_TRANSFER(0, 0, 0x00, 0x21, 0, TEST_WIDTH - 1u, 0x22, 0, 2);
+    TEST_TRANSFER(1, 0, 0x40, 0x00);
+    frame = ssd1306_mock_transfer(2, &length);
+    TEST_ASSERT(length == sizeof(test_buffer));
+    TEST_ASSERT(frame[0] == 0x40);
+    TEST_ASSERT(!memcmp(frame + 1, test_buffer + 1, sizeof(test_buffer) - 1u));
+    TEST_ASSERT(test_buffer[0] == 0x00);
+}
+
+static void test_i2c_write_columns(void)
+{
+    test_setup_i2c_write(VERTICAL_ADDRESSING_MODE);
+    ssd1306_update_gddram_window(&test_driver, &test_bm, 2, 4, 1, 2);
+
+    TEST_ASSERT(ssd1306_mock.transfers == 2u);
+    TEST_TRANSFER(0, 0, 0x00, 0x21, 2, 4, 0x22, 1, 2);
+    TEST_TRANSFER(1, 0, 0x40, 0x12, 0x22, 0x13, 0x23, 0x14, 0x24);
+}
+
+static void test_i2c_write_bounce(void)
+{
+    uint16_t length;
+
+    test_setup_i2c_write(HORIZONTAL_ADDRESSING_MODE);
+    ssd1306_write_gddram(&test_driver, test_buffer, 40);
+
+    /* Data that can't be modified is copied after the control byte. */
+    TEST_ASSERT(ssd1306_mock.transfers == 2u);
+    TEST_ASSERT(ssd1306_mock_transfer(0, &length)[0] == 0x40);
+    TEST_ASSERT(length == SSD1306_I2C_BOUNCE_SIZE + 1u);
+    TEST_ASSERT(ssd1306_mock_transfer(1, &length)[0] == 0x40);
+    TEST_ASSERT(length == 40u - SSD1306_I2C_BOUNCE_SIZE + 1u);
+}
+
+static void test_i2c_write_buffer(void)
+{
+    uint8_t buffer[64];
+    uint16_t length;
+
+    test_setup_i2c_write(HORIZONTAL_ADDRESSING_MODE);
+    test_driver.i2c_buffer = buffer;
+    test_driver.i2c_buffer_size = sizeof(buffer);
+    ssd1306_write_gddram(&test_driver, test_buffer, 40);
+
+    TEST_ASSERT(ssd1306_mock.transfers == 1u);
+    TEST_ASSERT(ssd1306_mock_transfer(0, &length)[0] == 0x40);
+    TEST_ASSERT(length == 41u);
+}
+
+void test_transport(void)
+{
+    test_run("i2c_commands", test_i2c_commands);
+    test_run("spi_commands", test_spi_commands);
+    test_run("i2c_window", test_i2c_window);
+    test_run("i2c_window_async", test_i2c_window_async);
+    test_run("spi_window", test_spi_window);
+    test_run("spi_window_async", test_spi_window_async);
+    test_run("i2c_page_window", test_i2c_page_window);
+    test_run("spi_vertical_window", test_spi_vertical_window);
+    test_run("i2c_dirty", test_i2c_dirty);
+    test_run("i2c_max_transfer", test_i2c_max_transfer);
+    test_run("i2c_batch", test_i2c_batch);
+    test_run("i2c_marquee_batch", test_i2c_marquee_batch);
+    test_run("i2c_marquee_ssd1306", test_i2c_marquee_ssd1306);
+    test_run("i2c_update_gddram", test_i2c_update_gddram);
+    test_run("i2c_write_window", test_i2c_write_window);
+    test_run("i2c_write_frame", test_i2c_write_frame);
+    test_run("i2c_write_columns", test_i2c_write_columns);
+    test_run("i2c_write_bounce", test_i2c_write_bounce);
+    test_run("i2c_write_buffer", test_i2c_write_buffer);
+}
@@ -0,0 +1,580 @@
+#!/usr/bin/env python3
+"""Compiles a PNG or BDF font into a ssd1306-lib font module.
+
+The module is a header declaring the font and a source file defining it, so
+the font data has a single definition however many translation units use it.
+Only the characters passed with --chars are emitted; the characters of the
+range that are left out get a zero width and no data.
+
+Printable ASCII characters go to the first_char..last_char range of the font.
+Any other codepoint goes to the sorted ranges searched by ssd1306_font_glyph,
+so the font can be drawn from UTF-8 strings. Nearby codepoints share a range
+when the glyphs in between cost less than another range.
+
+PNG fonts are strips with one glyph cell per character, stacked from top to
+bottom and starting at --first, or holding the characters of --strip in
+order. Dark opaque pixels are lit. BDF fonts are read with their own
+encodings, taken as Unicode codepoints, ascent and descent.
+
+Examples:
+    ssd1306_fontc.py assets/fonts/ascii_7x11.png --name font_7x11 \\
+        --cell-height 16 --proportional --space-width 7 --separation 3
+    ssd1306_fontc.py terminus.bdf --name font_digits --chars '0123456789.V' \\
+        --output-dir build/fonts
+    ssd1306_fontc.py terminus.bdf --name font_units --chars '0123456789°Cµs'
+"""
+
+import argparse
+import os
+import struct
+import sys
+import textwrap
+import zlib
+
+PNG_SIGNATURE = b"\x89PNG\r\n\x1a\n"
+# Channels of each PNG color type.
+PNG_CHANNELS = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}
+RLE_MAX_LITERAL = 128
+RLE_MAX_REPEAT = 129
+# Glyphs per offset of a fixed width RLE font (SSD1306_RLE_GROUP).
+RLE_GROUP = 8
+# First and last characters of the first_char..last_char range.
+ASCII_FIRST = 0x21
+ASCII_LAST = 0x7E
+# Size of a struct ssd1306_glyph_range and maximum number of ranges.
+RANGE_SIZE = 8
+RANGE_MAX = 255
+
+
+class FontError(Exception):
+    """Error in the font source or the compiler options."""
+
+
+class Glyph:
+    """Glyph of a font, as rows of booleans."""
+
+    def __init__(self, rows, width):
+        self.rows = rows
+        self.width = width
+
+
+def _paeth(a, b, c):
+    p = a + b - c
+    pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+    if pa <= pb and pa <= pc:
+        return a
+    return b if pb <= pc else c
+
+
+def read_png(path):
+    """Decodes a non-interlaced PNG file.
+
+    Returns the width, the height and a function returning the luminance and
+    alpha (0-255) of a pixel.
+    """
+    with open(path, "rb") as f:
+        data = f.read()
+    if not data.startswith(PNG_SIGNATURE):
+        raise FontError("%s: not a PNG file" % path)
+
+    pos = len(PNG_SIGNATURE)
+    idat = b""
+    palette = []
+    transparency = b""
+    header = None
+    while pos + 8 <= len(data):
+        length, kind = struct.unpack(">I4s", data[pos:pos + 8])
+        chunk = data[pos + 8:pos + 8 + length]
+        pos += 12 + length
+        if kind == b"IHDR":
+            header = struct.unpack(">IIBBBBB", chunk)
+        elif kind == b"PLTE":
+            palette = [chunk[i:i + 3] for i in range(0, len(chunk), 3)]
+        elif kind == b"tRNS":
+            transparency = chunk
+        elif kind == b"IDAT":
+            idat += chunk
+        elif kind == b"IEND":
+            break
+
+    if header is None:
+        raise FontError("%s: missing IHDR chunk" % path)
+    width, height, depth, color, _, _, interlace = header
+    if color not in PNG_CHANNELS or interlace:
+        raise FontError("%s: unsupported color type or interlacing" % path)
+    if depth == 16 or (depth < 8 and color not in (0, 3)):
+        raise FontError("%s: unsupported bit depth %d" % (path, depth))
+
+    bits = depth * PNG_CHANNELS[color]
+    stride = (width * bits + 7) // 8
+    bpp = max(1, bits // 8)
+    raw = zlib.decompress(idat)
+    rows = []
+    previous = bytearray(stride)
+    for y in range(height):
+        start = y * (stride + 1)
+        kind = raw[start]
+        line = bytearray(raw[start + 1:start + 1 + stride])
+        for x in range(stride):
+            a = line[x - bpp] if x >= bpp else 0
+            b = previous[x]
+            c = previous[x - bpp] if x >= bpp else 0
+            if kind == 1:
+                line[x] = (line[x] + a) & 0xFF
+            elif kind == 2:
+                line[x] = (line[x] + b) & 0xFF
+            elif kind == 3:
+                line[x] = (line[x] + (a + b) // 2) & 0xFF
+            elif kind == 4:
+                line[x] = (line[x] + _paeth(a, b, c)) & 0xFF
+        rows.append(line)
+        previous = line
+
+    def sample(x, y):
+        line = rows[y]
+        if depth < 8:
+            shift = 8 - depth - (x * depth) % 8
+            value = (line[x * depth // 8] >> shift) & ((1 << depth) - 1)
+            if color == 3:
+                alpha = transparency[value] if value < len(transparency) \
+                    else 255
+                rgb = palette[value]
+                return (rgb[0] * 299 + rgb[1] * 587 + rgb[2] * 114) // 1000, \
+                    alpha
+            return value * 255 // ((1 << depth) - 1), 255
+        px = line[x * bpp:(x + 1) * bpp]
+        if color == 0:
+            return px[0], 255
+        if color == 4:
+            return px[0], px[1]
+        if color == 3:
+            alpha = transparency[px[0]] if px[0] < len(transparency) else 255
+            px = palette[px[0]]
+        else:
+            alpha = px[3] if color == 6 else 255
+        return (px[0] * 299 + px[1] * 587 + px[2] * 114) // 1000, alpha
+
+    return width, height, sample
+
+
+def load_png(path, cell_height, first, invert, strip=None):
+    """Loads the glyphs of a PNG strip, keyed by character code.
+
+    The cells hold the characters of strip, or consecutive characters from
+    first if strip is None.
+    """
+    width, height, sample = read_png(path)
+    if not cell_height:
+        cell_height = width
+    if height % cell_height:
+        raise FontError("%s: height %d is not a multiple of the cell height %d"
+                        % (path, height, cell_height))
+    cells = height // cell_height
+    if strip is not None and len(strip) != cells:
+        raise FontError("%s: %d cells but %d characters in --strip"
+                        % (path, cells, len(strip)))
+
+    glyphs = {}
+    for n in range(cells):
+        rows = []
+        for y in range(cell_height):
+            row = []
+            for x in range(width):
+                luminance, alpha = sample(x, n * cell_height + y)
+                dark = luminance < 128
+                row.append(alpha >= 128 and dark != invert)
+            rows.append(row)
+        code = first + n if strip is None else ord(strip[n])
+        glyphs[code] = Glyph(rows, width)
+    return glyphs, width, cell_height
+
+
+def load_bdf(path):
+    """Loads the glyphs of a BDF font, keyed by encoding."""
+    glyphs = {}
+    ascent = descent = None
+    box = None
+    advance = {}
+    with open(path, "r", encoding="latin-1") as f:
+        lines = iter(f.read().splitlines())
+
+    for line in lines:
+        words = line.split()
+        if not words:
+            continue
+        if words[0] == "FONTBOUNDINGBOX":
+            box = [int(v) for v in words[1:5]]
+        elif words[0] == "FONT_ASCENT":
+            ascent = int(words[1])
+        elif words[0] == "FONT_DESCENT":
+            descent = int(words[1])
+        elif words[0] == "STARTCHAR":
+            encoding = -1
+            dwidth = 0
+            bbx = None
+            for line in lines:
+                words = line.split()
+                if not words:
+                    continue
+                if words[0] == "ENCODING":
+                    encoding = int(words[1])
+                elif words[0] == "DWIDTH":
+                    dwidth = int(words[1])
+                elif words[0] == "BBX":
+                    bbx = [int(v) for v in words[1:5]]
+                elif words[0] == "BITMAP":
+                    bitmap = []
+                    for line in lines:
+                        if line.strip() == "ENDCHAR":
+                            break
+                        bitmap.append(int(line.strip() or "0", 16))
+                    if encoding >= 0 and bbx:
+                        glyphs[encoding] = (bbx, bitmap)
+                        advance[encoding] = dwidth
+                    break
+
+    if box is None:
+        raise FontError("%s: missing FONTBOUNDINGBOX" % path)
+    if ascent is None:
+        ascent = box[1] + box[3]
+    if descent is None:
+        descent = -box[3]
+    cell_height = ascent + descent
+
+    result = {}
+    for code, (bbx, bitmap) in glyphs.items():
+        w, h, xoff, yoff = bbx
+        row_bits = (w + 7) // 8 * 8
+        cell_width = max(xoff + w, advance[code], 1)
+        rows = [[False] * cell_width for _ in range(cell_height)]
+        for j, value in enumerate(bitmap[:h]):
+            y = ascent - yoff - h + j
+            if not 0 <= y < cell_height:
+                continue
+            for i in range(w):
+                x = xoff + i
+                if 0 <= x < cell_width and value >> (row_bits - 1 - i) & 1:
+                    rows[y][x] = True
+        result[code] = Glyph(rows, cell_width)
+
+    space = advance.get(ord(" "), box[0])
+    return result, space, cell_height
+
+
+def lit_width(glyph):
+    """Returns the columns of a glyph up to its last lit column."""
+    width = 0
+    for row in glyph.rows:
+        for x, lit in enumerate(row):
+            if lit:
+                width = max(width, x + 1)
+    return width
+
+
+def page_data(glyph, width, pages):
+    """Converts a glyph into page format: one byte per column and page."""
+    data = []
+    for p in range(pages):
+        for x in range(width):
+            byte = 0
+            for bit in range(8):
+                y = p * 8 + bit
+                if y < len(glyph.rows) and x < len(glyph.rows[y]) and \
+                        glyph.rows[y][x]:
+                    byte |= 1 << bit
+            data.append(byte)
+    return data
+
+
+def rle_encode(data):
+    """Encodes a glyph for SSD1306_RLE_FONT.
+
+    A control byte n below 0x80 is followed by n + 1 literal bytes, and a
+    control byte n from 0x80 by a single byte repeated n - 0x7E times.
+    """
+    out = []
+    literal = None
+    i = 0
+    while i < len(data):
+        run = 1
+        while i + run < len(data) and run < RLE_MAX_REPEAT and \
+                data[i + run] == data[i]:
+            run += 1
+        # A pair only pays off when it doesn't split a literal run.
+        if run >= 3 or (run == 2 and literal is None):
+            out += [0x7E + run, data[i]]
+            literal = None
+            i += run
+            continue
+        if literal is None or out[literal] == RLE_MAX_LITERAL - 1:
+            literal = len(out)
+            out.append(0xFF)
+        out[literal] = (out[literal] + 1) & 0xFF
+        out.append(data[i])
+        i += 1
+    return out
+
+
+def c_char(code):
+    """Returns a C character literal."""
+    if code == ord("'") or code == ord("\\"):
+        return "'\\%c'" % code
+    if 0x20 < code < 0x7F:
+        return "'%c'" % code
+    return "0x%02X" % code
+
+
+def c_array(kind, name, values, fmt, per_line=12):
+    """Returns a C array definition, 12 values per line."""
+    lines = ["static const %s %s[%d] = {" % (kind, name, len(values))]
+    for i in range(0, len(values), per_line):
+        chunk = ", ".join(fmt % v for v in values[i:i + per_line])
+        lines.append("    %s%s" % (chunk, "," if i + per_line < len(values)
+                                     else "};"))
+    return "\n".join(lines)
+
+
+def group_ranges(codes, gap):
+    """Groups sorted codepoints into (first, last) ranges.
+
+    Ranges closer than gap + 1 codepoints are merged, the codepoints in
+    between become zero-width glyphs.
+    """
+    ranges = []
+    for code in codes:
+        if ranges and code - ranges[-1][1] <= gap + 1:
+            ranges[-1][1] = code
+        else:
+            ranges.append([code, code])
+    return ranges
+
+
+def compile_font(args):
+    """Compiles the font and writes the module files."""
+    if args.source.lower().endswith(".bdf"):
+        glyphs, space, cell_height = load_bdf(args.source)
+        cell_width = max(g.width for g in glyphs.values())
+        proportional = True
+    else:
+        glyphs, cell_width, cell_height = load_png(
+            args.source, args.cell_height, ord(args.first), args.invert,
+            args.strip)
+        space = cell_width
+        proportional = args.proportional
+
+    if args.chars is None:
+        codes = sorted(c for c in glyphs
+                       if c > ord(" ") and not 0x7F <= c < 0xA0)
+    else:
+        codes = sorted(set(ord(c) for c in args.chars) - {ord(" ")})
+    if not codes:
+        raise FontError("no characters to emit")
+    missing = [chr(c) for c in codes if c not in glyphs]
+    if missing:
+        raise FontError("characters not in %s: %s" %
+                        (args.source, "".join(missing)))
+    if any(c < ord(" ") or 0x7F <= c < 0xA0 for c in codes) or \
+            codes[-1] > 0x10FFFF:
+        raise FontError("control characters are not supported")
+
+    pages = (cell_height + 7) // 8
+    ascii_codes = [c for c in codes if c <= ASCII_LAST]
+    if ascii_codes:
+        first, last = ascii_codes[0], ascii_codes[-1]
+    else:
+        first, last = ASCII_FIRST, ASCII_FIRST - 1
+    contiguous = len(ascii_codes) == last - first + 1
+    variable = proportional or not contiguous
+    if args.space_width is not None:
+        space = args.space_width
+
+    # A zero-width glyph costs a width and an offset, fixed width fonts
+    # can't have them.
+    ranges = group_ranges([c for c in codes if c > ASCII_LAST],
+                          2 if variable else 0)
+    if len(ranges) > RANGE_MAX:
+        raise FontError("%d codepoint ranges, at most %d are supported" %
+                        (len(ranges), RANGE_MAX))
+    glyph_codes = list(range(first, last + 1))
+    range_values = []
+    for range_first, range_last in ranges:
+        range_values.append((range_first, range_last - range_first + 1,
+                             len(glyph_codes)))
+        glyph_codes += range(range_first, range_last + 1)
+
+    emitted = set(codes)
+    widths, raw_offsets, raw_data, rle_offsets, rle_data = [], [], [], [], []
+    for n, code in enumerate(glyph_codes):
+        if code in emitted:
+            glyph = glyphs[code]
+            width = max(lit_width(glyph), 1) if proportional else cell_width
+            glyph_data = page_data(glyph, width, pages)
+        else:
+            width = 0
+            glyph_data = []
+        widths.append(width)
+        raw_offsets.append(len(raw_data))
+        raw_data += glyph_data
+        # Fixed width RLE fonts only keep the offset of every RLE_GROUP-th
+        # glyph, the glyphs in between are skipped while decoding.
+        if variable or n % RLE_GROUP == 0:
+            rle_offsets.append(len(rle_data))
+        rle_data += rle_encode(glyph_data)
+
+    if not variable:
+        raw_offsets = []
+    raw_flash = len(raw_data) + 2 * len(raw_offsets)
+    rle_flash = len(rle_data) + 2 * len(rle_offsets)
+    rle = args.rle and rle_flash < raw_flash
+    if args.rle and not rle:
+        print("ssd1306_fontc.py: warning: %s: RLE takes %d bytes and raw %d, "
+              "emitting a raw font" % (args.name, rle_flash, raw_flash),
+              file=sys.stderr)
+    data, offsets = (rle_data, rle_offsets) if rle else (raw_data,
+                                                         raw_offsets)
+
+    if len(data) > 0xFFFF:
+        raise FontError("font data doesn't fit in 64 KiB")
+
+    name = args.name
+    file = args.file or name
+    guard = "__%s_H" % file.upper()
+    source = os.path.basename(args.source)
+    subset = "" if args.chars is None else \
+        " Subset: %s." % "".join(chr(c) for c in codes)
+    if args.brief:
+        text = "%s Generated by ssd1306_fontc.py from %s.%s" % (
+            args.brief, source, subset)
+    else:
+        text = "%s font generated by ssd1306_fontc.py from %s.%s" % (
+            name, source, subset)
+    brief = "\n".join(textwrap.wrap(
+        text, 80, initial_indent=" * @brief ", subsequent_indent=" *        ",
+        break_long_words=False, break_on_hyphens=False))
+    if args.author:
+        brief = " * @author %s\n%s" % (args.author, brief)
+
+    header = "\n".join([
+        "/**",
+        " * @file %s.h" % file,
+        brief,
+        " */",
+        "",
+        "#ifndef %s" % guard,
+        "#define %s" % guard,
+        "",
+        '#include "ssd1306/font/ssd1306_font.h"',
+        "",
+        "extern const struct ssd1306_font %s;" % name,
+        "",
+        "#endif /* !%s */" % guard,
+        "",
+    ])
+
+    fields = [
+        (".type", "SSD1306_VARIABLE_WIDTH_FONT" if variable else
+         "SSD1306_FIXED_WIDTH_FONT"),
+        (".first_char", c_char(first)),
+        (".last_char", c_char(last)),
+        (".space_width", str(space)),
+        (".horizontal_separation", str(args.separation)),
+        (".page_alignment", str(pages)),
+        (".data", "%s_data" % name),
+        (".data_length", str(len(data))),
+    ]
+    body = ["/**", " * @file %s.c" % file, brief, " */", "",
+            '#include "%s.h"' % (args.include_prefix + file), "",
+            c_array("uint8_t", "%s_data" % name, data, "0x%02x"), ""]
+    if variable:
+        body += [c_array("uint8_t", "%s_width" % name, widths, "%d"), ""]
+        fields.append((".char_width", "%s_width" % name))
+    if offsets:
+        body += [c_array("uint16_t", "%s_offset" % name, offsets, "%d"), ""]
+        fields.append((".char_offset", "%s_offset" % name))
+    if rle:
+        fields.append((".encoding", "SSD1306_RLE_FONT"))
+    if ranges:
+        body += [c_array("struct ssd1306_glyph_range", "%s_ranges" % name,
+                         range_values, "{0x%04X, %d, %d}", 4), ""]
+        fields.append((".ranges", "%s_ranges" % name))
+        fields.append((".range_count", str(len(ranges))))
+
+    body.append("const struct ssd1306_font %s = {" % name)
+    body += ["    %s = %s," % field for field in fields]
+    body += ["};", ""]
+
+    header_dir = args.header_dir or args.output_dir
+    os.makedirs(args.output_dir, exist_ok=True)
+    os.makedirs(header_dir, exist_ok=True)
+    with open(os.path.join(header_dir, file + ".h"), "w",
+              encoding="utf-8") as f:
+        f.write(header)
+    with open(os.path.join(args.output_dir, file + ".c"), "w",
+              encoding="utf-8") as f:
+        f.write("\n".join(body))
+
+    flash = len(data) + 2 * len(offsets) + \
+        (len(widths) if variable else 0) + RANGE_SIZE * len(ranges)
+    print("%s: %d glyphs, %d bytes" % (name, len(codes), flash))
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Compiles a PNG or BDF font into a ssd1306-lib font "
+                    "module (NAME.h and NAME.c).")
+    parser.add_argument("source", help="PNG strip or BDF font")
+    parser.add_argument("--name", required=True,
+                        help="C name of the font, also used for the files")
+    parser.add_argument("--chars",
+                        help="characters to emit (default: all printable "
+                             "characters of the source)")
+    parser.add_argument("--chars-file",
+                        help="file with the characters to emit")
+    parser.add_argument("--file",
+                        help="name of the generated files (default: NAME)")
+    parser.add_argument("--output-dir", default=".",
+                        help="directory of the generated files")
+    parser.add_argument("--header-dir",
+                        help="directory of the generated header (default: "
+                             "OUTPUT_DIR)")
+    parser.add_argument("--include-prefix", default="",
+                        help="path of the header in the #include of the "
+                             "source file")
+    parser.add_argument("--cell-height", type=int, default=0,
+                        help="PNG: height of a glyph cell (default: width)")
+    parser.add_argument("--first", default="!",
+                        help="PNG: character of the first cell")
+    parser.add_argument("--strip",
+                        help="PNG: characters of the cells, in order "
+                             "(default: consecutive from --first)")
+    parser.add_argument("--invert", action="store_true",
+                        help="PNG: light pixels are lit")
+    parser.add_argument("--proportional", action="store_true",
+                        help="PNG: trim the glyphs to their lit columns")
+    parser.add_argument("--space-width", type=int,
+                        help="space width (default: cell width or BDF "
+                             "advance)")
+    parser.add_argument("--separation", type=int, default=1,
+                        help="columns between characters")
+    parser.add_argument("--author",
+                        help="@author line of the generated files")
+    parser.add_argument("--brief",
+                        help="description of the font in the @brief line of "
+                             "the generated files")
+    parser.add_argument("--rle", action="store_true",
+                        help="emit a SSD1306_RLE_FONT if it is smaller than "
+                             "the raw font")
+    args = parser.parse_args()
+
+    if args.chars_file:
+        with open(args.chars_file, "r", encoding="utf-8") as f:
+            args.chars = (args.chars or "") + f.read().replace("\n", "")
+
+    try:
+        compile_font(args)
+    except (FontError, OSError, zlib.error) as e:
+        sys.exit("ssd1306_fontc.py: %s" % e)
+
+
+if __name__ == "__main__":
+    main()